@@ -5,6 +5,8 @@
 # - libmongoc_target
 # - libmongoc_definitions
 # - libmongoc_definitions
+# - mongocxx_codec_libraries
+# - mongocxx_codec_include_directories
 function(mongocxx_add_library TARGET OUTPUT_NAME LINK_TYPE)
     add_library(${TARGET} ${LINK_TYPE}
         ${mongocxx_sources}
@@ -28,8 +30,11 @@ function(mongocxx_add_library TARGET OUTPUT_NAME LINK_TYPE)
         target_compile_definitions(${TARGET} PUBLIC MONGOCXX_STATIC)
     endif()
 
-    target_link_libraries(${TARGET} PRIVATE ${libmongoc_target})
-    target_include_directories(${TARGET} PRIVATE ${libmongoc_include_directories})
+    target_link_libraries(${TARGET} PRIVATE ${libmongoc_target} ${mongocxx_codec_libraries})
+    target_include_directories(${TARGET} PRIVATE
+        ${libmongoc_include_directories}
+        ${mongocxx_codec_include_directories}
+    )
     target_include_directories(
         ${TARGET}
         PUBLIC
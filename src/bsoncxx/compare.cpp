@@ -0,0 +1,705 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <bsoncxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/decimal128.hpp>
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/types.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using types::bson_value::view;
+
+template <typename T>
+int three_way(const T& lhs, const T& rhs) {
+    return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+// Returns MongoDB's canonical ordering of BSON types. Types with the same rank compare by value.
+int canonical_rank(type t) {
+    switch (t) {
+        case type::k_minkey:
+            return -1;
+        case type::k_undefined:
+            return 0;
+        case type::k_null:
+            return 5;
+        case type::k_double:
+        case type::k_int32:
+        case type::k_int64:
+        case type::k_decimal128:
+            return 10;
+        case type::k_string:
+        case type::k_symbol:
+            return 15;
+        case type::k_document:
+            return 20;
+        case type::k_array:
+            return 25;
+        case type::k_binary:
+            return 30;
+        case type::k_oid:
+            return 35;
+        case type::k_bool:
+            return 40;
+        case type::k_date:
+            return 45;
+        case type::k_timestamp:
+            return 47;
+        case type::k_regex:
+            return 50;
+        case type::k_dbpointer:
+            return 55;
+        case type::k_code:
+            return 60;
+        case type::k_codewscope:
+            return 65;
+        case type::k_maxkey:
+            return 100;
+    }
+
+    return 100;
+}
+
+int compare_bytes(stdx::string_view lhs, stdx::string_view rhs) {
+    std::size_t len = std::min(lhs.size(), rhs.size());
+    int result = len ? std::memcmp(lhs.data(), rhs.data(), len) : 0;
+
+    if (result != 0) {
+        return result < 0 ? -1 : 1;
+    }
+
+    return three_way(lhs.size(), rhs.size());
+}
+
+int compare_doubles(double lhs, double rhs) {
+    // NaN sorts before every other number and is equal to itself.
+    if (std::isnan(lhs)) {
+        return std::isnan(rhs) ? 0 : -1;
+    }
+
+    if (std::isnan(rhs)) {
+        return 1;
+    }
+
+    return three_way(lhs, rhs);
+}
+
+// Compares an integer with a double exactly, without converting the integer to a double.
+int compare_int64_double(std::int64_t lhs, double rhs) {
+    if (std::isnan(rhs)) {
+        return 1;
+    }
+
+    if (rhs >= 9223372036854775808.0) {
+        return -1;
+    }
+
+    if (rhs < -9223372036854775808.0) {
+        return 1;
+    }
+
+    double integral = std::trunc(rhs);
+    int result = three_way(lhs, static_cast<std::int64_t>(integral));
+
+    if (result != 0) {
+        return result;
+    }
+
+    return three_way(integral, rhs);
+}
+
+std::int64_t as_int64(const view& value) {
+    return value.type() == type::k_int32 ? value.get_int32().value : value.get_int64().value;
+}
+
+bool is_integral(type t) {
+    return t == type::k_int32 || t == type::k_int64;
+}
+
+// A number of any BSON type, decoded so that it can be compared exactly with any other: NaN, an
+// infinity, or a finite value whose magnitude is coefficient * 10^exp10 * 2^exp2.
+struct number {
+    enum class kind { k_nan, k_negative_infinity, k_finite, k_positive_infinity };
+
+    kind category = kind::k_finite;
+
+    // -1, 0 or 1 for a finite number.
+    int sign = 0;
+
+    // The coefficient, as the high and low halves of a 128-bit integer.
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+
+    std::int32_t exp10 = 0;
+    std::int32_t exp2 = 0;
+};
+
+number from_int64(std::int64_t value) {
+    number result;
+    result.sign = three_way(value, std::int64_t{0});
+    // Negating in unsigned arithmetic is exact, including for the smallest int64.
+    result.low = value < 0 ? 0 - static_cast<std::uint64_t>(value)
+                           : static_cast<std::uint64_t>(value);
+    return result;
+}
+
+number from_double(double value) {
+    number result;
+
+    if (std::isnan(value)) {
+        result.category = number::kind::k_nan;
+    } else if (std::isinf(value)) {
+        result.category =
+            value < 0 ? number::kind::k_negative_infinity : number::kind::k_positive_infinity;
+    } else if (value != 0) {
+        int exponent;
+        const double fraction = std::frexp(std::fabs(value), &exponent);
+
+        // Every double is an integer of at most 53 bits scaled by a power of two.
+        result.sign = value < 0 ? -1 : 1;
+        result.low = static_cast<std::uint64_t>(std::ldexp(fraction, 53));
+        result.exp2 = exponent - 53;
+    }
+
+    return result;
+}
+
+// Decodes a decimal128 from its BID encoding. Non-canonical coefficients, which exceed 34 digits,
+// are zero.
+number from_decimal128(const decimal128& value) {
+    const std::uint64_t high = value.high();
+    number result;
+
+    const bool negative = (high >> 63) != 0;
+    const auto combination = (high >> 58) & 0x1f;
+
+    if (combination == 0x1f) {
+        result.category = number::kind::k_nan;
+        return result;
+    }
+
+    if (combination == 0x1e) {
+        result.category =
+            negative ? number::kind::k_negative_infinity : number::kind::k_positive_infinity;
+        return result;
+    }
+
+    const std::int32_t bias = 6176;
+
+    // The largest canonical coefficient, 10^34 - 1.
+    const std::uint64_t max_high = 0x0001ed09bead87c0;
+    const std::uint64_t max_low = 0x378d8e63ffffffff;
+
+    if (((high >> 61) & 3) == 3) {
+        // The implied coefficient is at least 2^113, which is not canonical.
+        return result;
+    }
+
+    result.high = high & 0x0001ffffffffffff;
+    result.low = value.low();
+    result.exp10 = static_cast<std::int32_t>((high >> 49) & 0x3fff) - bias;
+
+    if (result.high > max_high || (result.high == max_high && result.low > max_low)) {
+        result.high = 0;
+        result.low = 0;
+    }
+
+    if (result.high || result.low) {
+        result.sign = negative ? -1 : 1;
+    }
+
+    return result;
+}
+
+number from_value(const view& value) {
+    switch (value.type()) {
+        case type::k_int32:
+        case type::k_int64:
+            return from_int64(as_int64(value));
+        case type::k_decimal128:
+            return from_decimal128(value.get_decimal128().value);
+        default:
+            return from_double(value.get_double().value);
+    }
+}
+
+// An unsigned integer large enough for the products compare_magnitudes forms, held on the stack.
+class big_integer {
+   public:
+    big_integer(std::uint64_t high, std::uint64_t low) {
+        const std::uint64_t parts[] = {low, high};
+        for (auto part : parts) {
+            _limbs[_size++] = static_cast<std::uint32_t>(part);
+            _limbs[_size++] = static_cast<std::uint32_t>(part >> 32);
+        }
+        trim();
+    }
+
+    void multiply(std::uint32_t factor) {
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < _size; ++i) {
+            const std::uint64_t product = static_cast<std::uint64_t>(_limbs[i]) * factor + carry;
+            _limbs[i] = static_cast<std::uint32_t>(product);
+            carry = product >> 32;
+        }
+        if (carry) {
+            _limbs[_size++] = static_cast<std::uint32_t>(carry);
+        }
+    }
+
+    void multiply_by_power_of_ten(std::int32_t exponent) {
+        for (; exponent >= 9; exponent -= 9) {
+            multiply(1000000000u);
+        }
+        for (; exponent > 0; --exponent) {
+            multiply(10u);
+        }
+    }
+
+    void multiply_by_power_of_two(std::int32_t exponent) {
+        for (; exponent >= 31; exponent -= 31) {
+            multiply(1u << 31);
+        }
+        if (exponent > 0) {
+            multiply(1u << exponent);
+        }
+    }
+
+    friend int compare(const big_integer& lhs, const big_integer& rhs) {
+        if (lhs._size != rhs._size) {
+            return three_way(lhs._size, rhs._size);
+        }
+
+        for (std::size_t i = lhs._size; i-- > 0;) {
+            if (lhs._limbs[i] != rhs._limbs[i]) {
+                return three_way(lhs._limbs[i], rhs._limbs[i]);
+            }
+        }
+
+        return 0;
+    }
+
+   private:
+    void trim() {
+        while (_size > 0 && _limbs[_size - 1] == 0) {
+            --_size;
+        }
+    }
+
+    // compare_magnitudes only forms products of numbers within a factor of 10^4 of each other, at
+    // most a 113-bit coefficient scaled by 10^400 and 2^1126, which fit in 3000 bits.
+    std::uint32_t _limbs[96] = {};
+    std::size_t _size = 0;
+};
+
+// Estimates the base-10 logarithm of the magnitude of a finite, non-zero number.
+double log10_magnitude(const number& n) {
+    const double coefficient = static_cast<double>(n.high) * 18446744073709551616.0 +
+                               static_cast<double>(n.low);
+    return std::log10(coefficient) + n.exp10 + n.exp2 * 0.30102999566398120;
+}
+
+// Compares the magnitudes of two finite, non-zero numbers exactly.
+int compare_magnitudes(const number& lhs, const number& rhs) {
+    // The estimates are accurate to far better than a factor of ten, so numbers whose estimates
+    // differ by more than four orders of magnitude are ordered by them. That also bounds the
+    // exponents the exact comparison below has to scale by.
+    const double difference = log10_magnitude(lhs) - log10_magnitude(rhs);
+    if (difference > 4) {
+        return 1;
+    }
+    if (difference < -4) {
+        return -1;
+    }
+
+    big_integer lhs_scaled{lhs.high, lhs.low};
+    big_integer rhs_scaled{rhs.high, rhs.low};
+
+    // Both sides are multiplied so that neither has a negative exponent left.
+    const std::int32_t exp10 = lhs.exp10 - rhs.exp10;
+    const std::int32_t exp2 = lhs.exp2 - rhs.exp2;
+
+    if (exp10 > 0) {
+        lhs_scaled.multiply_by_power_of_ten(exp10);
+    } else {
+        rhs_scaled.multiply_by_power_of_ten(-exp10);
+    }
+
+    if (exp2 > 0) {
+        lhs_scaled.multiply_by_power_of_two(exp2);
+    } else {
+        rhs_scaled.multiply_by_power_of_two(-exp2);
+    }
+
+    return compare(lhs_scaled, rhs_scaled);
+}
+
+int compare_numbers(const view& lhs, const view& rhs) {
+    if (is_integral(lhs.type()) && is_integral(rhs.type())) {
+        return three_way(as_int64(lhs), as_int64(rhs));
+    }
+
+    if (lhs.type() == type::k_double && rhs.type() == type::k_double) {
+        return compare_doubles(lhs.get_double().value, rhs.get_double().value);
+    }
+
+    if (lhs.type() != type::k_decimal128 && rhs.type() != type::k_decimal128) {
+        if (is_integral(lhs.type())) {
+            return compare_int64_double(as_int64(lhs), rhs.get_double().value);
+        }
+
+        return -compare_int64_double(as_int64(rhs), lhs.get_double().value);
+    }
+
+    // Decimal128 values are decoded and compared exactly with numbers of any type, as with
+    // doubles, NaN orders before every other number.
+    const number lhs_number = from_value(lhs);
+    const number rhs_number = from_value(rhs);
+
+    int result = three_way(static_cast<int>(lhs_number.category),
+                           static_cast<int>(rhs_number.category));
+    if (result != 0 || lhs_number.category != number::kind::k_finite) {
+        return result;
+    }
+
+    result = three_way(lhs_number.sign, rhs_number.sign);
+    if (result != 0 || lhs_number.sign == 0) {
+        return result;
+    }
+
+    return compare_magnitudes(lhs_number, rhs_number) * lhs_number.sign;
+}
+
+stdx::string_view as_string(const view& value) {
+    return value.type() == type::k_symbol ? value.get_symbol().symbol : value.get_string().value;
+}
+
+int compare_values(const view& lhs, const view& rhs);
+
+int compare_documents(document::view lhs, document::view rhs) {
+    auto lhs_it = lhs.begin();
+    auto rhs_it = rhs.begin();
+
+    for (; lhs_it != lhs.end() && rhs_it != rhs.end(); ++lhs_it, ++rhs_it) {
+        int result = three_way(canonical_rank(lhs_it->type()), canonical_rank(rhs_it->type()));
+
+        if (result == 0) {
+            result = compare_bytes(lhs_it->key(), rhs_it->key());
+        }
+
+        if (result == 0) {
+            result = compare_values(lhs_it->get_value(), rhs_it->get_value());
+        }
+
+        if (result != 0) {
+            return result;
+        }
+    }
+
+    if (lhs_it == lhs.end()) {
+        return rhs_it == rhs.end() ? 0 : -1;
+    }
+
+    return 1;
+}
+
+int compare_values(const view& lhs, const view& rhs) {
+    int result = three_way(canonical_rank(lhs.type()), canonical_rank(rhs.type()));
+
+    if (result != 0) {
+        return result;
+    }
+
+    switch (lhs.type()) {
+        case type::k_double:
+        case type::k_int32:
+        case type::k_int64:
+        case type::k_decimal128:
+            return compare_numbers(lhs, rhs);
+
+        case type::k_string:
+        case type::k_symbol:
+            return compare_bytes(as_string(lhs), as_string(rhs));
+
+        case type::k_document:
+            return compare_documents(lhs.get_document().value, rhs.get_document().value);
+
+        case type::k_array:
+            return compare_documents(lhs.get_array().value, rhs.get_array().value);
+
+        case type::k_binary: {
+            const auto& lhs_binary = lhs.get_binary();
+            const auto& rhs_binary = rhs.get_binary();
+
+            result = three_way(lhs_binary.size, rhs_binary.size);
+            if (result == 0) {
+                result = three_way(static_cast<int>(lhs_binary.sub_type),
+                                   static_cast<int>(rhs_binary.sub_type));
+            }
+            if (result == 0 && lhs_binary.size) {
+                result = three_way(std::memcmp(lhs_binary.bytes, rhs_binary.bytes, lhs_binary.size),
+                                   0);
+            }
+            return result;
+        }
+
+        case type::k_oid:
+            return three_way(std::memcmp(lhs.get_oid().value.bytes(),
+                                         rhs.get_oid().value.bytes(),
+                                         oid::size()),
+                             0);
+
+        case type::k_bool:
+            return three_way(lhs.get_bool().value, rhs.get_bool().value);
+
+        case type::k_date:
+            return three_way(lhs.get_date().value.count(), rhs.get_date().value.count());
+
+        case type::k_timestamp:
+            result = three_way(lhs.get_timestamp().timestamp, rhs.get_timestamp().timestamp);
+            if (result == 0) {
+                result = three_way(lhs.get_timestamp().increment, rhs.get_timestamp().increment);
+            }
+            return result;
+
+        case type::k_regex:
+            result = compare_bytes(lhs.get_regex().regex, rhs.get_regex().regex);
+            if (result == 0) {
+                result = compare_bytes(lhs.get_regex().options, rhs.get_regex().options);
+            }
+            return result;
+
+        case type::k_dbpointer:
+            result = compare_bytes(lhs.get_dbpointer().collection, rhs.get_dbpointer().collection);
+            if (result == 0) {
+                result = three_way(std::memcmp(lhs.get_dbpointer().value.bytes(),
+                                               rhs.get_dbpointer().value.bytes(),
+                                               oid::size()),
+                                   0);
+            }
+            return result;
+
+        case type::k_code:
+            return compare_bytes(lhs.get_code().code, rhs.get_code().code);
+
+        case type::k_codewscope:
+            result = compare_bytes(lhs.get_codewscope().code, rhs.get_codewscope().code);
+            if (result == 0) {
+                result = compare_documents(lhs.get_codewscope().scope, rhs.get_codewscope().scope);
+            }
+            return result;
+
+        case type::k_minkey:
+        case type::k_undefined:
+        case type::k_null:
+        case type::k_maxkey:
+            return 0;
+    }
+
+    return 0;
+}
+
+// Keeps the value a document sorts by among the values a sort key takes in it: the smallest in
+// an ascending sort and the largest in a descending one.
+class sort_key_reducer {
+   public:
+    explicit sort_key_reducer(std::int32_t direction) : _direction{direction} {}
+
+    void offer(const view& value) {
+        if (!_found || compare_values(value, _result) * _direction < 0) {
+            _result = value;
+            _found = true;
+        }
+    }
+
+    // A sort key that takes no value sorts as null.
+    view result() const {
+        return _result;
+    }
+
+   private:
+    std::int32_t _direction;
+    bool _found = false;
+    view _result{types::b_null{}};
+};
+
+// Parses a path component that names an array element by position.
+bool parse_index(stdx::string_view component, std::uint32_t* index) {
+    if (component.empty() || component.size() > 9 ||
+        (component[0] == '0' && component.size() > 1)) {
+        return false;
+    }
+
+    *index = 0;
+    for (char c : component) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        *index = *index * 10 + static_cast<std::uint32_t>(c - '0');
+    }
+
+    return true;
+}
+
+// Offers the value at the end of a sort path: each element of an array, or undefined for an empty
+// array, which sorts before null.
+void offer_leaf(const view& value, sort_key_reducer* reducer) {
+    if (value.type() != type::k_array) {
+        reducer->offer(value);
+        return;
+    }
+
+    array::view array = value.get_array().value;
+
+    if (array.empty()) {
+        reducer->offer(view{types::b_undefined{}});
+        return;
+    }
+
+    for (auto&& item : array) {
+        reducer->offer(item.get_value());
+    }
+}
+
+void collect_below(const view& value, stdx::string_view path, sort_key_reducer* reducer);
+
+// Offers the values a dotted path takes in a document. A missing field offers null.
+void collect_field(document::view doc, stdx::string_view path, sort_key_reducer* reducer) {
+    auto dot = path.find('.');
+    auto element = doc[path.substr(0, dot)];
+
+    if (!element) {
+        reducer->offer(view{types::b_null{}});
+    } else if (dot == stdx::string_view::npos) {
+        offer_leaf(element.get_value(), reducer);
+    } else {
+        collect_below(element.get_value(), path.substr(dot + 1), reducer);
+    }
+}
+
+// Offers the values the rest of a dotted path takes below a value on it. As on the server, a
+// numeric component selects an array element by position when there is one, and otherwise the
+// path continues into every subdocument of the array. A path through any other value is missing.
+void collect_below(const view& value, stdx::string_view path, sort_key_reducer* reducer) {
+    if (value.type() == type::k_document) {
+        collect_field(value.get_document().value, path, reducer);
+        return;
+    }
+
+    if (value.type() != type::k_array) {
+        reducer->offer(view{types::b_null{}});
+        return;
+    }
+
+    array::view array = value.get_array().value;
+    auto dot = path.find('.');
+    std::uint32_t index;
+
+    if (parse_index(path.substr(0, dot), &index)) {
+        if (auto item = array[index]) {
+            if (dot == stdx::string_view::npos) {
+                offer_leaf(item.get_value(), reducer);
+            } else {
+                collect_below(item.get_value(), path.substr(dot + 1), reducer);
+            }
+            return;
+        }
+    }
+
+    for (auto&& item : array) {
+        if (item.type() == type::k_document) {
+            collect_field(item.get_document().value, path, reducer);
+        }
+    }
+}
+
+// Returns the value a document sorts by for a sort key.
+view sort_value(document::view doc, stdx::string_view path, std::int32_t direction) {
+    sort_key_reducer reducer{direction};
+    collect_field(doc, path, &reducer);
+    return reducer.result();
+}
+
+std::int32_t sort_direction(const document::element& element) {
+    switch (element.type()) {
+        case type::k_int32:
+            return element.get_int32().value;
+        case type::k_int64:
+            return static_cast<std::int32_t>(element.get_int64().value);
+        case type::k_double:
+            return static_cast<std::int32_t>(element.get_double().value);
+        default:
+            return 0;
+    }
+}
+
+}  // namespace
+
+int BSONCXX_CALL compare(const types::bson_value::view& lhs, const types::bson_value::view& rhs) {
+    return compare_values(lhs, rhs);
+}
+
+int BSONCXX_CALL compare(document::view lhs, document::view rhs) {
+    return compare_documents(lhs, rhs);
+}
+
+sort_comparator::sort_comparator(document::view_or_value sort) : _sort{sort.view()} {
+    for (auto&& element : _sort.view()) {
+        std::int32_t direction = sort_direction(element);
+
+        if (direction != 1 && direction != -1) {
+            throw bsoncxx::exception{error_code::k_invalid_sort_specification};
+        }
+    }
+}
+
+int sort_comparator::compare(document::view lhs, document::view rhs) const {
+    for (auto&& element : _sort.view()) {
+        std::int32_t direction = sort_direction(element);
+
+        int result = compare_values(sort_value(lhs, element.key(), direction),
+                                    sort_value(rhs, element.key(), direction));
+
+        if (result != 0) {
+            return result * direction;
+        }
+    }
+
+    return 0;
+}
+
+bool sort_comparator::operator()(document::view lhs, document::view rhs) const {
+    return compare(lhs, rhs) < 0;
+}
+
+document::view sort_comparator::sort() const {
+    return _sort.view();
+}
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
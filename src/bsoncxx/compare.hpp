@@ -0,0 +1,117 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bsoncxx/config/prelude.hpp>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Compares two BSON values using the order MongoDB uses for comparisons and sorts.
+///
+/// Values of different types are ordered by their canonical type order: MinKey, null, numbers,
+/// strings and symbols, documents, arrays, binary data, ObjectIds, booleans, dates, timestamps,
+/// regular expressions, DBPointers, JavaScript code, JavaScript code with scope, and MaxKey.
+/// Numbers compare by value regardless of their type, with NaN ordered before every other number.
+/// Numbers of different types, including Decimal128, are compared by their exact values rather
+/// than through a double. Documents and arrays are compared field by field, by type, field name
+/// and then value.
+///
+/// @param lhs
+///   The first value.
+/// @param rhs
+///   The second value.
+///
+/// @return
+///   A negative value if @p lhs orders before @p rhs, zero if they are equivalent, and a positive
+///   value otherwise.
+///
+BSONCXX_API int BSONCXX_CALL compare(const types::bson_value::view& lhs,
+                                     const types::bson_value::view& rhs);
+
+///
+/// Compares two BSON documents field by field using the order MongoDB uses for comparisons and
+/// sorts.
+///
+/// @see bsoncxx::compare(const types::bson_value::view&, const types::bson_value::view&)
+///
+/// @param lhs
+///   The first document.
+/// @param rhs
+///   The second document.
+///
+/// @return
+///   A negative value if @p lhs orders before @p rhs, zero if they are equivalent, and a positive
+///   value otherwise.
+///
+BSONCXX_API int BSONCXX_CALL compare(document::view lhs, document::view rhs);
+
+///
+/// Class that orders documents by a sort specification, as a MongoDB query with that sort would.
+///
+/// A missing field sorts as null. An array sorts by its smallest element for an ascending key and
+/// by its largest element for a descending key, and an empty array sorts before null. Dotted field
+/// paths are resolved through embedded documents and, as on the server, through every embedded
+/// document of an array along the path, so that a document sorts by the smallest or largest of all
+/// the values the path reaches. A numeric path component also selects an array element by index.
+///
+class BSONCXX_API sort_comparator {
+   public:
+    ///
+    /// Constructs a comparator for a sort specification.
+    ///
+    /// @param sort
+    ///   A sort specification of the form `{<field>: <1 or -1>, ...}`.
+    ///
+    /// @throws bsoncxx::exception if the sort specification is invalid.
+    ///
+    explicit sort_comparator(document::view_or_value sort);
+
+    ///
+    /// Compares two documents by the sort specification.
+    ///
+    /// @return
+    ///   A negative value if @p lhs sorts before @p rhs, zero if they sort equally, and a positive
+    ///   value otherwise.
+    ///
+    int compare(document::view lhs, document::view rhs) const;
+
+    ///
+    /// Returns whether @p lhs sorts strictly before @p rhs. Allows use of the comparator with
+    /// standard library algorithms and containers.
+    ///
+    bool operator()(document::view lhs, document::view rhs) const;
+
+    ///
+    /// Gets the sort specification.
+    ///
+    /// @return The sort specification.
+    ///
+    document::view sort() const;
+
+   private:
+    document::value _sort;
+};
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/postlude.hpp>
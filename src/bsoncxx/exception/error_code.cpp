@@ -79,6 +79,10 @@ class error_category_impl final : public std::error_category {
         return {"unable to append " #name};
 #include <bsoncxx/enums/type.hpp>
 #undef BSONCXX_ENUM
+            case error_code::k_invalid_sort_specification:
+                return "sort specification fields must be 1 or -1";
+            case error_code::k_invalid_query_filter:
+                return "the query filter is malformed or uses an unsupported operator";
             default:
                 return "unknown bsoncxx error code";
         }
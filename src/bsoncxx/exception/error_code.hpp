@@ -95,6 +95,10 @@ enum class error_code : std::int32_t {
 #define BSONCXX_ENUM(name, value) k_cannot_append_##name,
 #include <bsoncxx/enums/type.hpp>
 #undef BSONCXX_ENUM
+    /// A sort specification was not of the form `{<field>: <1 or -1>, ...}`.
+    k_invalid_sort_specification,
+    /// A query filter used an unsupported operator or was malformed.
+    k_invalid_query_filter,
     k_cannot_append_utf8 = k_cannot_append_string,
     k_need_element_type_k_utf8 = k_need_element_type_k_string,
     // Add new constant string message to error_code.cpp as well!
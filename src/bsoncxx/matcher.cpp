@@ -0,0 +1,534 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <bsoncxx/config/private/prelude.hh>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/exception/error_code.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/types.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using types::bson_value::view;
+
+enum class operation { k_eq, k_gt, k_gte, k_lt, k_lte, k_in, k_exists, k_elem_match };
+
+struct node;
+
+// A condition on the values of a field. Operands are views into the filter held by the matcher.
+struct condition {
+    operation op;
+
+    // Whether the condition is the negation of op, as $ne is of $eq, $nin of $in, and
+    // {$exists: false} of {$exists: true}.
+    bool negated = false;
+
+    view operand;
+
+    // The operands of $in and $nin.
+    std::vector<view> values;
+
+    // The filter of $elemMatch, applied to the elements of an array: to their values if it is
+    // made of operators, and to the documents they hold otherwise.
+    std::unique_ptr<node> sub;
+    bool sub_on_values = false;
+};
+
+// A clause of a filter: either conditions on a field, or a logical operator over filters.
+struct clause {
+    enum class kind { k_field, k_and, k_or, k_nor };
+
+    kind type;
+
+    // The components of the dotted path of the field, which are views into the filter. Empty for
+    // the operators of an $elemMatch applied to values.
+    std::vector<stdx::string_view> path;
+    std::vector<condition> conditions;
+
+    std::vector<std::unique_ptr<node>> children;
+};
+
+// A filter, which matches if all its clauses do.
+struct node {
+    std::vector<clause> clauses;
+};
+
+[[noreturn]] void invalid_filter() {
+    throw bsoncxx::exception{error_code::k_invalid_query_filter};
+}
+
+bool is_operator(stdx::string_view key) {
+    return !key.empty() && key[0] == '$';
+}
+
+std::unique_ptr<node> compile_filter(document::view filter);
+
+std::vector<condition> compile_conditions(const view& value);
+
+condition compile_operator(stdx::string_view name, const view& value) {
+    condition c;
+    c.operand = value;
+
+    if (name == "$eq" || name == "$ne") {
+        c.op = operation::k_eq;
+        c.negated = name == "$ne";
+    } else if (name == "$gt") {
+        c.op = operation::k_gt;
+    } else if (name == "$gte") {
+        c.op = operation::k_gte;
+    } else if (name == "$lt") {
+        c.op = operation::k_lt;
+    } else if (name == "$lte") {
+        c.op = operation::k_lte;
+    } else if (name == "$in" || name == "$nin") {
+        if (value.type() != type::k_array) {
+            invalid_filter();
+        }
+        c.op = operation::k_in;
+        c.negated = name == "$nin";
+        for (auto&& element : value.get_array().value) {
+            if (element.type() == type::k_regex) {
+                invalid_filter();
+            }
+            c.values.push_back(element.get_value());
+        }
+    } else if (name == "$exists") {
+        c.op = operation::k_exists;
+        switch (value.type()) {
+            case type::k_bool:
+                c.negated = !value.get_bool().value;
+                break;
+            case type::k_int32:
+                c.negated = value.get_int32().value == 0;
+                break;
+            case type::k_int64:
+                c.negated = value.get_int64().value == 0;
+                break;
+            case type::k_double:
+                c.negated = value.get_double().value == 0.0;
+                break;
+            default:
+                invalid_filter();
+        }
+    } else if (name == "$elemMatch") {
+        if (value.type() != type::k_document) {
+            invalid_filter();
+        }
+        c.op = operation::k_elem_match;
+
+        const auto spec = value.get_document().value;
+        const stdx::string_view first = spec.empty() ? stdx::string_view{} : spec.begin()->key();
+        c.sub_on_values =
+            is_operator(first) && first != "$and" && first != "$or" && first != "$nor";
+
+        if (c.sub_on_values) {
+            c.sub = stdx::make_unique<node>();
+            clause on_values;
+            on_values.type = clause::kind::k_field;
+            on_values.conditions = compile_conditions(value);
+            c.sub->clauses.push_back(std::move(on_values));
+        } else {
+            c.sub = compile_filter(spec);
+        }
+    } else {
+        invalid_filter();
+    }
+
+    if (c.op != operation::k_exists && c.op != operation::k_elem_match &&
+        value.type() == type::k_regex) {
+        invalid_filter();
+    }
+
+    return c;
+}
+
+std::vector<condition> compile_conditions(const view& value) {
+    std::vector<condition> conditions;
+
+    if (value.type() == type::k_document) {
+        const auto spec = value.get_document().value;
+        if (spec.begin() != spec.end() && is_operator(spec.begin()->key())) {
+            for (auto&& element : spec) {
+                if (!is_operator(element.key())) {
+                    invalid_filter();
+                }
+                conditions.push_back(compile_operator(element.key(), element.get_value()));
+            }
+            return conditions;
+        }
+    }
+
+    // A regular expression given as a value would be a pattern match, which is not supported.
+    if (value.type() == type::k_regex) {
+        invalid_filter();
+    }
+
+    condition equal;
+    equal.op = operation::k_eq;
+    equal.operand = value;
+    conditions.push_back(std::move(equal));
+    return conditions;
+}
+
+std::unique_ptr<node> compile_filter(document::view filter) {
+    auto compiled = stdx::make_unique<node>();
+
+    for (auto&& element : filter) {
+        const auto key = element.key();
+        clause c;
+
+        if (is_operator(key)) {
+            if (key == "$and") {
+                c.type = clause::kind::k_and;
+            } else if (key == "$or") {
+                c.type = clause::kind::k_or;
+            } else if (key == "$nor") {
+                c.type = clause::kind::k_nor;
+            } else {
+                invalid_filter();
+            }
+
+            if (element.type() != type::k_array) {
+                invalid_filter();
+            }
+            for (auto&& child : element.get_array().value) {
+                if (child.type() != type::k_document) {
+                    invalid_filter();
+                }
+                c.children.push_back(compile_filter(child.get_document().value));
+            }
+            if (c.children.empty()) {
+                invalid_filter();
+            }
+        } else {
+            c.type = clause::kind::k_field;
+
+            std::size_t start = 0;
+            for (;;) {
+                const auto dot = key.find('.', start);
+                c.path.push_back(key.substr(start, dot == stdx::string_view::npos
+                                                       ? stdx::string_view::npos
+                                                       : dot - start));
+                if (dot == stdx::string_view::npos) {
+                    break;
+                }
+                start = dot + 1;
+            }
+
+            c.conditions = compile_conditions(element.get_value());
+        }
+
+        compiled->clauses.push_back(std::move(c));
+    }
+
+    return compiled;
+}
+
+// Comparison operators only match values of the same type class as their operand.
+int type_class(type t) {
+    switch (t) {
+        case type::k_int32:
+        case type::k_int64:
+        case type::k_double:
+        case type::k_decimal128:
+            return -1;
+        case type::k_string:
+        case type::k_symbol:
+            return -2;
+        default:
+            return static_cast<int>(t);
+    }
+}
+
+bool satisfies(operation op, const view& value, const view& operand) {
+    if (op == operation::k_eq) {
+        return compare(value, operand) == 0;
+    }
+
+    if (type_class(value.type()) != type_class(operand.type())) {
+        return false;
+    }
+
+    const int order = compare(value, operand);
+    switch (op) {
+        case operation::k_gt:
+            return order > 0;
+        case operation::k_gte:
+            return order >= 0;
+        case operation::k_lt:
+            return order < 0;
+        case operation::k_lte:
+            return order <= 0;
+        default:
+            return false;
+    }
+}
+
+// Whether a value, or any element of it if it is an array, satisfies a comparison.
+bool satisfies_or_contains(operation op, const view& value, const view& operand) {
+    if (satisfies(op, value, operand)) {
+        return true;
+    }
+
+    if (value.type() == type::k_array) {
+        for (auto&& element : value.get_array().value) {
+            if (satisfies(op, element.get_value(), operand)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool matches_filter(const node& filter, document::view doc);
+bool matches_values(const node& filter, const view& value);
+
+// Whether a value found at the path of a field satisfies a condition, before negation.
+bool test(const condition& c, const view& value) {
+    switch (c.op) {
+        case operation::k_exists:
+            return true;
+        case operation::k_in:
+            for (const auto& candidate : c.values) {
+                if (satisfies_or_contains(operation::k_eq, value, candidate)) {
+                    return true;
+                }
+            }
+            return false;
+        case operation::k_elem_match:
+            if (value.type() != type::k_array) {
+                return false;
+            }
+            for (auto&& element : value.get_array().value) {
+                if (c.sub_on_values ? matches_values(*c.sub, element.get_value())
+                                    : element.type() == type::k_document &&
+                                          matches_filter(*c.sub, element.get_document().value)) {
+                    return true;
+                }
+            }
+            return false;
+        default:
+            return satisfies_or_contains(c.op, value, c.operand);
+    }
+}
+
+// Whether a missing field satisfies a condition, before negation: it equals null.
+bool test_missing(const condition& c) {
+    switch (c.op) {
+        case operation::k_eq:
+            return c.operand.type() == type::k_null;
+        case operation::k_in:
+            for (const auto& candidate : c.values) {
+                if (candidate.type() == type::k_null) {
+                    return true;
+                }
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+// Parses a path component made only of digits as an array index.
+bool parse_index(stdx::string_view component, std::uint32_t* index) {
+    if (component.empty() || component.size() > 9) {
+        return false;
+    }
+
+    std::uint32_t parsed = 0;
+    for (const char c : component) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        parsed = parsed * 10 + static_cast<std::uint32_t>(c - '0');
+    }
+
+    *index = parsed;
+    return true;
+}
+
+template <typename Visitor>
+bool resolve_in_value(const view& value,
+                      const std::vector<stdx::string_view>& path,
+                      std::size_t i,
+                      const Visitor& visit);
+
+// Calls visit with each value a path resolves to from its i-th component, or with a null pointer
+// where the path is missing, until visit returns true.
+template <typename Visitor>
+bool resolve(document::view doc,
+             const std::vector<stdx::string_view>& path,
+             std::size_t i,
+             const Visitor& visit) {
+    const auto element = doc[path[i]];
+    if (!element) {
+        return visit(nullptr);
+    }
+
+    const view value = element.get_value();
+    if (i + 1 == path.size()) {
+        return visit(&value);
+    }
+
+    return resolve_in_value(value, path, i + 1, visit);
+}
+
+// Continues resolving a path from its i-th component within a value found at the previous one.
+template <typename Visitor>
+bool resolve_in_value(const view& value,
+                      const std::vector<stdx::string_view>& path,
+                      std::size_t i,
+                      const Visitor& visit) {
+    if (value.type() == type::k_document) {
+        return resolve(value.get_document().value, path, i, visit);
+    }
+
+    if (value.type() != type::k_array) {
+        return visit(nullptr);
+    }
+
+    const auto array = value.get_array().value;
+    if (array.empty()) {
+        return visit(nullptr);
+    }
+
+    // A numeric component selects an element of the array, and is also looked up in the
+    // documents the array holds.
+    std::uint32_t index;
+    if (parse_index(path[i], &index)) {
+        const auto element = array[index];
+        if (element) {
+            const view selected = element.get_value();
+            if (i + 1 == path.size() ? visit(&selected)
+                                     : resolve_in_value(selected, path, i + 1, visit)) {
+                return true;
+            }
+        }
+    }
+
+    for (auto&& element : array) {
+        if (element.type() == type::k_document) {
+            if (resolve(element.get_document().value, path, i, visit)) {
+                return true;
+            }
+        } else if (visit(nullptr)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool matches_field(const clause& c, document::view doc) {
+    for (const auto& cond : c.conditions) {
+        const bool positive = resolve(doc, c.path, 0, [&](const view* value) {
+            return value ? test(cond, *value) : test_missing(cond);
+        });
+
+        if (positive == cond.negated) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matches_filter(const node& filter, document::view doc) {
+    for (const auto& c : filter.clauses) {
+        bool matched = true;
+
+        switch (c.type) {
+            case clause::kind::k_field:
+                matched = matches_field(c, doc);
+                break;
+            case clause::kind::k_and:
+                for (const auto& child : c.children) {
+                    matched = matched && matches_filter(*child, doc);
+                }
+                break;
+            case clause::kind::k_or:
+            case clause::kind::k_nor: {
+                bool any = false;
+                for (const auto& child : c.children) {
+                    if (matches_filter(*child, doc)) {
+                        any = true;
+                        break;
+                    }
+                }
+                matched = (c.type == clause::kind::k_or) == any;
+                break;
+            }
+        }
+
+        if (!matched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Applies the operators of an $elemMatch to the value of an element.
+bool matches_values(const node& filter, const view& value) {
+    for (const auto& c : filter.clauses) {
+        for (const auto& cond : c.conditions) {
+            if (test(cond, value) == cond.negated) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+class matcher::impl {
+   public:
+    explicit impl(document::view filter)
+        : filter(filter), root(compile_filter(this->filter.view())) {}
+
+    // The filter, which holds the operands the compiled filter refers to.
+    const document::value filter;
+    const std::unique_ptr<node> root;
+};
+
+matcher::matcher(document::view_or_value filter)
+    : _impl(std::make_shared<const impl>(filter.view())) {}
+
+bool matcher::matches(document::view doc) const {
+    return matches_filter(*_impl->root, doc);
+}
+
+bool matcher::operator()(document::view doc) const {
+    return matches(doc);
+}
+
+document::view matcher::filter() const {
+    return _impl->filter.view();
+}
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
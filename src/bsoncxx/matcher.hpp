@@ -0,0 +1,85 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <bsoncxx/config/prelude.hpp>
+
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+
+namespace bsoncxx {
+BSONCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class that evaluates a MongoDB query filter against documents on the client.
+///
+/// The filter is compiled once on construction; evaluating it reads the encoded document in place
+/// without copying it. Values are compared with bsoncxx::compare, and comparison operators only
+/// match values of the same type class as their operand, as on the server: numbers with numbers,
+/// strings with strings, and so on.
+///
+/// The supported operators are $eq, $ne, $gt, $gte, $lt, $lte, $in, $nin, $exists and
+/// $elemMatch on fields, and $and, $or and $nor to combine filters. A field which is not given
+/// an operator is tested for equality; regular expressions are not supported. Dotted paths are
+/// resolved through embedded documents, through the documents of arrays, and through array
+/// indexes. A field holding an array matches a condition if the array or any of its elements
+/// does, and a missing field equals null.
+///
+/// A matcher is immutable, so it may be used from several threads at once. Copies share the
+/// compiled filter.
+///
+class BSONCXX_API matcher {
+   public:
+    ///
+    /// Compiles a query filter.
+    ///
+    /// @param filter
+    ///   The query filter. An empty filter matches every document.
+    ///
+    /// @throws bsoncxx::exception if the filter is malformed or uses an unsupported operator.
+    ///
+    explicit matcher(document::view_or_value filter);
+
+    ///
+    /// Evaluates the filter against a document.
+    ///
+    /// @return Whether the document matches the filter.
+    ///
+    bool matches(document::view doc) const;
+
+    ///
+    /// Evaluates the filter against a document. Allows use of the matcher as a predicate with
+    /// standard library algorithms.
+    ///
+    bool operator()(document::view doc) const;
+
+    ///
+    /// Gets the query filter.
+    ///
+    /// @return The query filter.
+    ///
+    document::view filter() const;
+
+   private:
+    class BSONCXX_PRIVATE impl;
+    std::shared_ptr<const impl> _impl;
+};
+
+BSONCXX_INLINE_NAMESPACE_END
+}  // namespace bsoncxx
+
+#include <bsoncxx/config/postlude.hpp>
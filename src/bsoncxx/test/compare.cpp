@@ -0,0 +1,201 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/oid.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+
+using namespace bsoncxx;
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+// Compares the values of the "v" field of two single-field documents.
+int compare_v(const document::value& lhs, const document::value& rhs) {
+    return compare(lhs.view()["v"].get_value(), rhs.view()["v"].get_value());
+}
+
+TEST_CASE("values of different types follow the canonical type order", "[bsoncxx::compare]") {
+    std::vector<document::value> ordered;
+    ordered.push_back(make_document(kvp("v", types::b_minkey{})));
+    ordered.push_back(make_document(kvp("v", types::b_null{})));
+    ordered.push_back(make_document(kvp("v", 1)));
+    ordered.push_back(make_document(kvp("v", "a")));
+    ordered.push_back(make_document(kvp("v", make_document(kvp("a", 1)))));
+    ordered.push_back(make_document(kvp("v", make_array(1))));
+    ordered.push_back(make_document(kvp("v", oid{})));
+    ordered.push_back(make_document(kvp("v", false)));
+    ordered.push_back(make_document(kvp("v", types::b_date{std::chrono::milliseconds{0}})));
+    ordered.push_back(make_document(kvp("v", types::b_timestamp{0, 0})));
+    ordered.push_back(make_document(kvp("v", types::b_regex{"a"})));
+    ordered.push_back(make_document(kvp("v", types::b_code{"a"})));
+    ordered.push_back(make_document(kvp("v", types::b_maxkey{})));
+
+    for (std::size_t i = 0; i < ordered.size(); ++i) {
+        for (std::size_t j = 0; j < ordered.size(); ++j) {
+            int result = compare_v(ordered[i], ordered[j]);
+            if (i < j) {
+                REQUIRE(result < 0);
+            } else if (i > j) {
+                REQUIRE(result > 0);
+            } else {
+                REQUIRE(result == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("numbers compare by value across types", "[bsoncxx::compare]") {
+    auto int32_one = make_document(kvp("v", std::int32_t{1}));
+    auto int64_one = make_document(kvp("v", std::int64_t{1}));
+    auto double_one = make_document(kvp("v", 1.0));
+    auto double_half = make_document(kvp("v", 1.5));
+    auto nan = make_document(kvp("v", std::numeric_limits<double>::quiet_NaN()));
+    auto negative_infinity = make_document(kvp("v", -std::numeric_limits<double>::infinity()));
+
+    REQUIRE(compare_v(int32_one, int64_one) == 0);
+    REQUIRE(compare_v(int64_one, double_one) == 0);
+    REQUIRE(compare_v(int32_one, double_half) < 0);
+    REQUIRE(compare_v(double_half, int64_one) > 0);
+    REQUIRE(compare_v(nan, negative_infinity) < 0);
+    REQUIRE(compare_v(nan, nan) == 0);
+
+    // Integers beyond 2^53 are compared exactly rather than through a double.
+    auto big = make_document(kvp("v", std::int64_t{9007199254740993}));
+    auto big_double = make_document(kvp("v", 9007199254740992.0));
+    REQUIRE(compare_v(big, big_double) > 0);
+
+    auto decimal_two = make_document(kvp("v", types::b_decimal128{decimal128{"2"}}));
+    REQUIRE(compare_v(decimal_two, double_half) > 0);
+    REQUIRE(compare_v(decimal_two, make_document(kvp("v", 2))) == 0);
+}
+
+TEST_CASE("decimal128 values compare exactly with numbers of every type", "[bsoncxx::compare]") {
+    auto decimal = [](const char* str) {
+        return make_document(kvp("v", types::b_decimal128{decimal128{str}}));
+    };
+
+    // Both round to the same double.
+    REQUIRE(compare_v(decimal("0.1000000000000000000000000000000001"), decimal("0.1")) > 0);
+    REQUIRE(compare_v(decimal("0.10"), decimal("0.1")) == 0);
+    REQUIRE(compare_v(decimal("-0"), make_document(kvp("v", 0.0))) == 0);
+
+    // The double nearest to 0.1 is slightly larger than it.
+    REQUIRE(compare_v(decimal("0.1"), make_document(kvp("v", 0.1))) < 0);
+    REQUIRE(compare_v(decimal("0.5"), make_document(kvp("v", 0.5))) == 0);
+    REQUIRE(compare_v(decimal("1E-400"), make_document(kvp("v", 4.9e-324))) < 0);
+    REQUIRE(compare_v(decimal("1E+400"), make_document(kvp("v", 1.7e308))) > 0);
+
+    REQUIRE(compare_v(decimal("9007199254740992"),
+                      make_document(kvp("v", std::int64_t{9007199254740993}))) < 0);
+    REQUIRE(compare_v(decimal("-9223372036854775808"),
+                      make_document(kvp("v", std::numeric_limits<std::int64_t>::min()))) == 0);
+
+    auto infinity = make_document(kvp("v", std::numeric_limits<double>::infinity()));
+    REQUIRE(compare_v(decimal("Infinity"), infinity) == 0);
+    REQUIRE(compare_v(decimal("-Infinity"), decimal("-1E+6111")) < 0);
+    REQUIRE(compare_v(decimal("NaN"), decimal("-Infinity")) < 0);
+    REQUIRE(compare_v(decimal("NaN"),
+                      make_document(kvp("v", std::numeric_limits<double>::quiet_NaN()))) == 0);
+}
+
+TEST_CASE("strings, binary and documents compare by content", "[bsoncxx::compare]") {
+    REQUIRE(compare_v(make_document(kvp("v", "ab")), make_document(kvp("v", "abc"))) < 0);
+    REQUIRE(compare_v(make_document(kvp("v", "b")), make_document(kvp("v", "abc"))) > 0);
+    REQUIRE(compare_v(make_document(kvp("v", types::b_symbol{"a"})),
+                      make_document(kvp("v", "a"))) == 0);
+
+    const std::uint8_t short_bytes[] = {9};
+    const std::uint8_t long_bytes[] = {0, 0};
+    REQUIRE(compare_v(make_document(kvp(
+                          "v", types::b_binary{binary_sub_type::k_binary, 1, short_bytes})),
+                      make_document(kvp(
+                          "v", types::b_binary{binary_sub_type::k_binary, 2, long_bytes}))) < 0);
+
+    // Documents compare field by field, by type before field name.
+    REQUIRE(compare(make_document(kvp("a", 1)), make_document(kvp("a", 1), kvp("b", 1))) < 0);
+    REQUIRE(compare(make_document(kvp("b", 1)), make_document(kvp("a", "x"))) < 0);
+    REQUIRE(compare(make_document(kvp("a", 2)), make_document(kvp("b", 1))) < 0);
+    REQUIRE(compare(make_document(kvp("a", 1.0)), make_document(kvp("a", 1))) == 0);
+}
+
+TEST_CASE("sort_comparator orders documents by a sort specification", "[bsoncxx::compare]") {
+    sort_comparator comparator{make_document(kvp("a", 1), kvp("b.c", -1))};
+
+    std::vector<document::value> docs;
+    docs.push_back(make_document(kvp("a", 2), kvp("b", make_document(kvp("c", 1)))));
+    docs.push_back(make_document(kvp("a", 1), kvp("b", make_document(kvp("c", 1)))));
+    docs.push_back(make_document(kvp("a", 1), kvp("b", make_document(kvp("c", 5)))));
+    docs.push_back(make_document(kvp("b", make_document(kvp("c", 0)))));
+
+    std::sort(docs.begin(),
+              docs.end(),
+              [&](const document::value& lhs, const document::value& rhs) {
+                  return comparator(lhs.view(), rhs.view());
+              });
+
+    // The missing "a" sorts as null, before every number.
+    REQUIRE(!docs[0].view()["a"]);
+    REQUIRE(docs[1].view()["b"]["c"].get_int32().value == 5);
+    REQUIRE(docs[2].view()["b"]["c"].get_int32().value == 1);
+    REQUIRE(docs[3].view()["a"].get_int32().value == 2);
+
+    SECTION("arrays sort by their smallest or largest element") {
+        auto array = make_document(kvp("a", make_array(1, 5)));
+        auto three = make_document(kvp("a", 3));
+
+        REQUIRE(sort_comparator{make_document(kvp("a", 1))}.compare(array, three) < 0);
+        REQUIRE(sort_comparator{make_document(kvp("a", -1))}.compare(array, three) < 0);
+        REQUIRE(sort_comparator{make_document(kvp("a", 1))}.compare(
+                    make_document(kvp("a", make_array())), make_document()) < 0);
+    }
+
+    SECTION("dotted paths reach into arrays of subdocuments") {
+        auto array = make_document(
+            kvp("a", make_array(make_document(kvp("b", 5)), make_document(kvp("b", 1)))));
+        auto three = make_document(kvp("a", make_document(kvp("b", 3))));
+
+        REQUIRE(sort_comparator{make_document(kvp("a.b", 1))}.compare(array, three) < 0);
+        REQUIRE(sort_comparator{make_document(kvp("a.b", -1))}.compare(array, three) < 0);
+
+        // A numeric component also selects an element by position.
+        REQUIRE(sort_comparator{make_document(kvp("a.0.b", 1))}.compare(array, three) > 0);
+
+        // A subdocument without the field contributes null.
+        auto partial = make_document(
+            kvp("a", make_array(make_document(kvp("c", 1)), make_document(kvp("b", 1)))));
+        REQUIRE(sort_comparator{make_document(kvp("a.b", 1))}.compare(
+                    partial, make_document(kvp("a", types::b_null{}))) == 0);
+    }
+
+    SECTION("invalid sort specifications are rejected") {
+        REQUIRE_THROWS_AS(sort_comparator{make_document(kvp("a", 2))}, bsoncxx::exception);
+        REQUIRE_THROWS_AS(sort_comparator{make_document(kvp("a", "text"))}, bsoncxx::exception);
+    }
+}
+
+}  // namespace
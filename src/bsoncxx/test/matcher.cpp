@@ -0,0 +1,189 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <vector>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/json.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+
+using namespace bsoncxx;
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+namespace {
+
+bool match(const char* filter, const char* doc) {
+    return matcher{from_json(filter)}.matches(from_json(doc).view());
+}
+
+TEST_CASE("fields without an operator are tested for equality", "[bsoncxx::matcher]") {
+    REQUIRE(match("{}", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": 1})", R"({"a": 1})"));
+    REQUIRE(!match(R"({"a": 1})", R"({"a": 2})"));
+    REQUIRE(match(R"({"a": 1, "b": "x"})", R"({"b": "x", "a": 1})"));
+    REQUIRE(!match(R"({"a": 1, "b": "x"})", R"({"a": 1, "b": "y"})"));
+    REQUIRE(match(R"({"a": {"b": 1}})", R"({"a": {"b": 1}})"));
+    REQUIRE(!match(R"({"a": {"b": 1}})", R"({"a": {"b": 1, "c": 2}})"));
+
+    // Numbers are equal regardless of their type.
+    const auto filter = make_document(kvp("a", 1));
+    REQUIRE(matcher{filter.view()}(make_document(kvp("a", 1.0)).view()));
+    REQUIRE(matcher{filter.view()}(make_document(kvp("a", std::int64_t{1})).view()));
+}
+
+TEST_CASE("dotted paths are resolved through documents and arrays", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a.b": 1})", R"({"a": {"b": 1}})"));
+    REQUIRE(match(R"({"a.b.c": 1})", R"({"a": {"b": {"c": 1}}})"));
+    REQUIRE(!match(R"({"a.b": 1})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a.b": 2})", R"({"a": [{"b": 1}, {"b": 2}]})"));
+    REQUIRE(!match(R"({"a.b": 3})", R"({"a": [{"b": 1}, {"b": 2}]})"));
+    REQUIRE(match(R"({"a.1": 20})", R"({"a": [10, 20]})"));
+    REQUIRE(!match(R"({"a.1": 10})", R"({"a": [10, 20]})"));
+    REQUIRE(match(R"({"a.0.b": 1})", R"({"a": [{"b": 1}]})"));
+}
+
+TEST_CASE("arrays match if any element does", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": 2})", R"({"a": [1, 2, 3]})"));
+    REQUIRE(match(R"({"a": [1, 2]})", R"({"a": [1, 2]})"));
+    REQUIRE(!match(R"({"a": [2, 1]})", R"({"a": [1, 2]})"));
+    REQUIRE(match(R"({"a": {"$gt": 2}})", R"({"a": [1, 3]})"));
+    REQUIRE(!match(R"({"a": {"$gt": 3}})", R"({"a": [1, 3]})"));
+
+    // Each condition may be satisfied by a different element.
+    REQUIRE(match(R"({"a": {"$gt": 2, "$lt": 2}})", R"({"a": [1, 3]})"));
+}
+
+TEST_CASE("comparison operators", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": {"$eq": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$ne": 1}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$ne": 1}})", R"({"a": 1})"));
+    REQUIRE(!match(R"({"a": {"$ne": 1}})", R"({"a": [1, 2]})"));
+    REQUIRE(match(R"({"a": {"$ne": 1}})", R"({"b": 1})"));
+
+    REQUIRE(match(R"({"a": {"$gt": 1}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$gte": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$lt": 1}})", R"({"a": 0.5})"));
+    REQUIRE(match(R"({"a": {"$lte": 1}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$gt": 1, "$lt": 3}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$gt": 1, "$lt": 3}})", R"({"a": 3})"));
+    REQUIRE(match(R"({"a": {"$gt": "a"}})", R"({"a": "b"})"));
+
+    // Values of another type class never satisfy a comparison.
+    REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"a": "b"})"));
+    REQUIRE(!match(R"({"a": {"$lt": "b"}})", R"({"a": 1})"));
+    REQUIRE(!match(R"({"a": {"$gt": 1}})", R"({"b": 2})"));
+}
+
+TEST_CASE("$in and $nin", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": {"$in": [1, 2]}})", R"({"a": 2})"));
+    REQUIRE(!match(R"({"a": {"$in": [1, 2]}})", R"({"a": 3})"));
+    REQUIRE(match(R"({"a": {"$in": [1, 2]}})", R"({"a": [3, 2]})"));
+    REQUIRE(match(R"({"a": {"$in": [null]}})", R"({"b": 1})"));
+    REQUIRE(!match(R"({"a": {"$in": []}})", R"({"a": 1})"));
+
+    REQUIRE(match(R"({"a": {"$nin": [1, 2]}})", R"({"a": 3})"));
+    REQUIRE(!match(R"({"a": {"$nin": [1, 2]}})", R"({"a": [3, 2]})"));
+    REQUIRE(match(R"({"a": {"$nin": [1, 2]}})", R"({"b": 1})"));
+}
+
+TEST_CASE("$exists and null", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"a": {"$exists": true}})", R"({"a": null})"));
+    REQUIRE(!match(R"({"a": {"$exists": true}})", R"({"b": 1})"));
+    REQUIRE(match(R"({"a": {"$exists": false}})", R"({"b": 1})"));
+    REQUIRE(!match(R"({"a": {"$exists": 0}})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a.b": {"$exists": true}})", R"({"a": [{"c": 1}, {"b": 1}]})"));
+
+    // A missing field equals null.
+    REQUIRE(match(R"({"a": null})", R"({"a": null})"));
+    REQUIRE(match(R"({"a": null})", R"({"b": 1})"));
+    REQUIRE(!match(R"({"a": null})", R"({"a": 1})"));
+    REQUIRE(match(R"({"a": {"$ne": null}})", R"({"a": 1})"));
+    REQUIRE(!match(R"({"a": {"$ne": null}})", R"({"b": 1})"));
+}
+
+TEST_CASE("$elemMatch", "[bsoncxx::matcher]") {
+    const char* filter = R"({"a": {"$elemMatch": {"b": 1, "c": 2}}})";
+    REQUIRE(match(filter, R"({"a": [{"b": 1, "c": 2}]})"));
+    // The conditions must hold for the same element.
+    REQUIRE(!match(filter, R"({"a": [{"b": 1}, {"c": 2}]})"));
+    REQUIRE(!match(filter, R"({"a": {"b": 1, "c": 2}})"));
+
+    const char* range = R"({"a": {"$elemMatch": {"$gt": 1, "$lt": 3}}})";
+    REQUIRE(match(range, R"({"a": [0, 2, 4]})"));
+    REQUIRE(!match(range, R"({"a": [0, 4]})"));
+    REQUIRE(!match(range, R"({"a": 2})"));
+
+    REQUIRE(match(R"({"a": {"$elemMatch": {"$or": [{"b": 1}, {"b": 2}]}}})",
+                  R"({"a": [{"b": 2}]})"));
+}
+
+TEST_CASE("logical operators", "[bsoncxx::matcher]") {
+    REQUIRE(match(R"({"$and": [{"a": 1}, {"b": 2}]})", R"({"a": 1, "b": 2})"));
+    REQUIRE(!match(R"({"$and": [{"a": 1}, {"b": 2}]})", R"({"a": 1, "b": 3})"));
+    REQUIRE(match(R"({"$or": [{"a": 1}, {"b": 2}]})", R"({"a": 0, "b": 2})"));
+    REQUIRE(!match(R"({"$or": [{"a": 1}, {"b": 2}]})", R"({"a": 0, "b": 0})"));
+    REQUIRE(match(R"({"$nor": [{"a": 1}, {"b": 2}]})", R"({"a": 0, "b": 0})"));
+    REQUIRE(!match(R"({"$nor": [{"a": 1}, {"b": 2}]})", R"({"a": 1})"));
+    REQUIRE(match(R"({"c": 3, "$or": [{"a": 1}, {"$and": [{"b": 2}, {"d": 4}]}]})",
+                  R"({"b": 2, "c": 3, "d": 4})"));
+}
+
+TEST_CASE("unsupported or malformed filters are rejected", "[bsoncxx::matcher]") {
+    const char* invalid[] = {
+        R"({"$where": "true"})",
+        R"({"a": {"$regex": "x"}})",
+        R"({"a": {"$gt": 1, "b": 2}})",
+        R"({"a": {"$in": 1}})",
+        R"({"a": {"$exists": "yes"}})",
+        R"({"a": {"$elemMatch": 1}})",
+        R"({"$or": []})",
+        R"({"$and": {"a": 1}})",
+    };
+
+    for (const auto filter : invalid) {
+        INFO(filter);
+        REQUIRE_THROWS_AS(matcher{from_json(filter)}, bsoncxx::exception);
+    }
+
+    // A regular expression given as a value is a pattern match, which is not supported.
+    REQUIRE_THROWS_AS(matcher{make_document(kvp("a", types::b_regex{"x"}))}, bsoncxx::exception);
+}
+
+TEST_CASE("a matcher can be used with standard algorithms", "[bsoncxx::matcher]") {
+    std::vector<document::value> docs;
+    for (std::int32_t i = 0; i < 10; ++i) {
+        docs.push_back(make_document(kvp("n", i), kvp("tags", make_array(i % 2, i % 3))));
+    }
+
+    const matcher filter{from_json(R"({"n": {"$gte": 4}, "tags": 0})")};
+    const auto count = std::count_if(
+        docs.begin(), docs.end(), [&](const document::value& doc) { return filter(doc.view()); });
+
+    // n in [4, 9] with n even or divisible by 3: 4, 6, 8, 9.
+    REQUIRE(count == 4);
+
+    const matcher copy = filter;
+    REQUIRE(copy.filter() == filter.filter());
+}
+
+}  // namespace
@@ -15,6 +15,7 @@
 #include <mongocxx/config/private/prelude.hh>
 
 #include <string>
+#include <vector>
 
 #include <bsoncxx/stdx/make_unique.hpp>
 #include <mongocxx/change_stream.hpp>
@@ -54,6 +55,34 @@ change_stream::iterator change_stream::end() const {
     return iterator{change_stream::iterator::iter_type::k_end, this};
 }
 
+std::vector<bsoncxx::document::value> change_stream::next_batch(
+    std::size_t max, std::chrono::milliseconds max_wait) {
+    std::vector<bsoncxx::document::value> events;
+    if (_impl->is_dead()) {
+        return events;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + max_wait;
+
+    while (events.size() < max) {
+        if (!events.empty() && std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+
+        _impl->mark_started();
+        _impl->advance_iterator();
+        if (_impl->is_exhausted()) {
+            return events;
+        }
+
+        events.emplace_back(_impl->doc());
+    }
+
+    // The last notification has been returned; the next call to begin() must advance past it.
+    _impl->mark_nothing_left();
+    return events;
+}
+
 stdx::optional<bsoncxx::document::view> change_stream::get_resume_token() const {
     return _impl->get_resume_token();
 }
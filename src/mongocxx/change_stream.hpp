@@ -16,8 +16,12 @@
 
 #include <mongocxx/config/prelude.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
+#include <bsoncxx/document/value.hpp>
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
 
@@ -82,6 +86,32 @@ class MONGOCXX_API change_stream {
     ///
     iterator end() const;
 
+    ///
+    /// Returns the next notifications of the change stream, copied so that they outlive further
+    /// iteration.
+    ///
+    /// Notifications already received from the server are returned without a round trip, and
+    /// further batches are requested from the server until max notifications have been collected,
+    /// max_wait has elapsed, or a request returns no notification within the max_await_time (from
+    /// the options::change_stream). The elapsed time is checked between notifications, so a
+    /// request in progress when max_wait elapses still blocks until it returns.
+    ///
+    /// After this call, get_resume_token() returns the token from which to resume after the last
+    /// notification returned, and begin() points to the notification following it.
+    ///
+    /// @param max
+    ///   The maximum number of notifications to return.
+    /// @param max_wait
+    ///   The time after which no further notification is requested.
+    ///
+    /// @return
+    ///   The notifications, which may be fewer than max, or none.
+    /// @exception
+    ///   Throws mongocxx::query_exception if the query failed.
+    ///
+    std::vector<bsoncxx::document::value> next_batch(std::size_t max,
+                                                     std::chrono::milliseconds max_wait);
+
     ///
     /// Returns a resume token for this change stream.
     ///
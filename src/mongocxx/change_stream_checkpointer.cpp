@@ -0,0 +1,409 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cerrno>
+#include <cstdio>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/validate.hpp>
+#include <mongocxx/change_stream_checkpointer.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/options/update.hpp>
+#include <mongocxx/private/change_stream_checkpointer.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+const std::chrono::milliseconds k_default_commit_interval{1000};
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error{errno, std::generic_category(), what};
+}
+
+// Reads a checkpoint from the fields of a file or a document, which holds other fields when it is
+// stored in a collection.
+change_stream_checkpointer::checkpoint parse_checkpoint(bsoncxx::document::view doc) {
+    const auto sequence = doc["sequence"];
+    const auto resume_token = doc["resumeToken"];
+
+    if (!sequence || sequence.type() != bsoncxx::type::k_int64 || !resume_token ||
+        resume_token.type() != bsoncxx::type::k_document) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "the change stream checkpoint is malformed"};
+    }
+
+    return change_stream_checkpointer::checkpoint{
+        static_cast<std::uint64_t>(sequence.get_int64().value),
+        bsoncxx::document::value{resume_token.get_document().value}};
+}
+
+}  // namespace
+
+stdx::optional<change_stream_checkpointer::checkpoint> change_stream_checkpointer::impl::load() {
+    if (pool) {
+        auto client = pool->acquire();
+        auto doc = (*client)[db_name][collection_name].find_one(make_document(kvp("_id", id)));
+        if (!doc) {
+            return stdx::nullopt;
+        }
+        return parse_checkpoint(doc->view());
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        if (errno == ENOENT) {
+            return stdx::nullopt;
+        }
+        throw_errno("cannot open the checkpoint file " + path);
+    }
+
+    std::vector<std::uint8_t> contents;
+    std::uint8_t buffer[4096];
+    std::size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        contents.insert(contents.end(), buffer, buffer + read);
+    }
+    const bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+
+    if (failed) {
+        throw_errno("cannot read the checkpoint file " + path);
+    }
+
+    const auto doc = bsoncxx::validate(contents.data(), contents.size());
+    if (!doc) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "the checkpoint file " + path + " is not a BSON document"};
+    }
+
+    return parse_checkpoint(*doc);
+}
+
+void change_stream_checkpointer::impl::persist(const checkpoint& next) {
+    if (pool) {
+        persist_to_collection(next);
+        return;
+    }
+
+    persist_to_file(make_document(kvp("sequence", static_cast<std::int64_t>(next.sequence)),
+                                  kvp("resumeToken", next.resume_token.view())));
+}
+
+void change_stream_checkpointer::impl::persist_to_file(bsoncxx::document::view encoded) {
+    // The checkpoint is written to a temporary file which replaces the previous one only once it
+    // is durable, so a crash leaves either checkpoint intact.
+    const std::string temporary = path + ".tmp";
+
+#if defined(_WIN32)
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        throw_errno("cannot create " + temporary);
+    }
+
+    const bool written = std::fwrite(encoded.data(), 1, encoded.length(), file) ==
+                             encoded.length() &&
+                         std::fflush(file) == 0 && _commit(_fileno(file)) == 0;
+    if (std::fclose(file) != 0 || !written) {
+        throw_errno("cannot write " + temporary);
+    }
+
+    if (!MoveFileExA(temporary.c_str(),
+                     path.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+        throw std::system_error{static_cast<int>(GetLastError()),
+                                std::system_category(),
+                                "cannot replace the checkpoint file " + path};
+    }
+#else
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw_errno("cannot create " + temporary);
+    }
+
+    std::size_t offset = 0;
+    while (offset < encoded.length()) {
+        const auto written = ::write(fd, encoded.data() + offset, encoded.length() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            const int saved = errno;
+            ::close(fd);
+            errno = saved;
+            throw_errno("cannot write " + temporary);
+        }
+        offset += static_cast<std::size_t>(written);
+    }
+
+    if (::fsync(fd) != 0) {
+        const int saved = errno;
+        ::close(fd);
+        errno = saved;
+        throw_errno("cannot sync " + temporary);
+    }
+    if (::close(fd) != 0) {
+        throw_errno("cannot close " + temporary);
+    }
+
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw_errno("cannot replace the checkpoint file " + path);
+    }
+
+    // The rename is durable once the directory holding the file is synced.
+    const auto separator = path.find_last_of('/');
+    const std::string directory = separator == std::string::npos
+                                      ? std::string{"."}
+                                      : separator == 0 ? std::string{"/"}
+                                                       : path.substr(0, separator);
+
+    const int directory_fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (directory_fd < 0) {
+        throw_errno("cannot open " + directory);
+    }
+    const bool synced = ::fsync(directory_fd) == 0;
+    const int saved = errno;
+    ::close(directory_fd);
+    if (!synced) {
+        errno = saved;
+        throw_errno("cannot sync " + directory);
+    }
+#endif
+}
+
+void change_stream_checkpointer::impl::persist_to_collection(const checkpoint& next) {
+    auto client = pool->acquire();
+    auto coll = (*client)[db_name][collection_name];
+
+    options::update options;
+    options.upsert(true);
+    if (write_concern) {
+        options.write_concern(*write_concern);
+    }
+
+    coll.update_one(
+        make_document(kvp("_id", id)),
+        make_document(
+            kvp("$set",
+                make_document(kvp("sequence", static_cast<std::int64_t>(next.sequence)),
+                              kvp("resumeToken", next.resume_token.view())))),
+        options);
+}
+
+void change_stream_checkpointer::impl::commit(std::unique_lock<std::mutex>& lock) {
+    const auto number = ++commits_started;
+
+    if (!acknowledged || acknowledgements == persisted_acknowledgements) {
+        error = nullptr;
+        commits_completed = number;
+        commit_completed.notify_all();
+        return;
+    }
+
+    // Acknowledgements received during the write are persisted by the next commit.
+    checkpoint next = *acknowledged;
+    const auto covered = acknowledgements;
+
+    lock.unlock();
+    std::exception_ptr failure;
+    try {
+        persist(next);
+    } catch (...) {
+        failure = std::current_exception();
+    }
+    lock.lock();
+
+    error = failure;
+    if (!failure) {
+        persisted = std::move(next);
+        persisted_acknowledgements = covered;
+    }
+
+    commits_completed = number;
+    commit_completed.notify_all();
+}
+
+void change_stream_checkpointer::impl::run() {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        commit_requested.wait_for(lock, commit_interval, [&] {
+            return stopping || commits_requested > commits_started;
+        });
+
+        // The last commit starts after stopping is set, so it covers every acknowledgement.
+        const bool last = stopping;
+        commit(lock);
+        if (last) {
+            stopped = true;
+            commit_completed.notify_all();
+            return;
+        }
+    }
+}
+
+std::exception_ptr change_stream_checkpointer::impl::stop() {
+    std::unique_lock<std::mutex> lock{mutex};
+    const bool first = !stopping;
+
+    if (first) {
+        stopping = true;
+        // The committer persists the latest acknowledgement before returning.
+        commit_requested.notify_one();
+    }
+
+    commit_completed.wait(lock, [&] { return stopped; });
+    const std::exception_ptr final_error = error;
+    lock.unlock();
+
+    if (first) {
+        committer.join();
+    }
+
+    return final_error;
+}
+
+change_stream_checkpointer::change_stream_checkpointer(
+    std::string path, const options::change_stream_checkpointer& options) {
+    const auto commit_interval = options.commit_interval().value_or(k_default_commit_interval);
+    if (commit_interval.count() <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_checkpointer::commit_interval()"};
+    }
+
+    _impl = stdx::make_unique<impl>(commit_interval, options.write_concern());
+    _impl->path = std::move(path);
+    _impl->persisted = _impl->load();
+
+    _impl->committer = std::thread{[this] { _impl->run(); }};
+}
+
+change_stream_checkpointer::change_stream_checkpointer(
+    class pool& pool,
+    bsoncxx::string::view_or_value db_name,
+    bsoncxx::string::view_or_value collection_name,
+    bsoncxx::string::view_or_value id,
+    const options::change_stream_checkpointer& options) {
+    const auto commit_interval = options.commit_interval().value_or(k_default_commit_interval);
+    if (commit_interval.count() <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_checkpointer::commit_interval()"};
+    }
+
+    _impl = stdx::make_unique<impl>(commit_interval, options.write_concern());
+    _impl->pool = &pool;
+    _impl->db_name = db_name.terminated().data();
+    _impl->collection_name = collection_name.terminated().data();
+    _impl->id = id.terminated().data();
+    _impl->persisted = _impl->load();
+
+    _impl->committer = std::thread{[this] { _impl->run(); }};
+}
+
+change_stream_checkpointer::~change_stream_checkpointer() {
+    // As a last resort, the error of the final commit is dropped, since a destructor cannot report
+    // it. Consumers that need it call close() first.
+    _impl->stop();
+}
+
+void change_stream_checkpointer::acknowledge(bsoncxx::document::view resume_token,
+                                             std::uint64_t sequence) {
+    std::unique_lock<std::mutex> lock{_impl->mutex};
+    if (_impl->acknowledged && _impl->acknowledged->sequence >= sequence) {
+        return;
+    }
+    lock.unlock();
+
+    checkpoint next{sequence, bsoncxx::document::value{resume_token}};
+
+    lock.lock();
+    if (_impl->acknowledged && _impl->acknowledged->sequence >= sequence) {
+        return;
+    }
+    _impl->acknowledged = std::move(next);
+    ++_impl->acknowledgements;
+}
+
+void change_stream_checkpointer::flush() {
+    std::unique_lock<std::mutex> lock{_impl->mutex};
+
+    // The background thread no longer commits once stopping.
+    if (_impl->stopping) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "cannot flush a closed change_stream_checkpointer"};
+    }
+
+    // A commit already in progress may have missed the latest acknowledgements, so wait for the
+    // next one to start and complete. Concurrent callers share it.
+    const auto target = _impl->commits_started + 1;
+    if (_impl->commits_requested < target) {
+        _impl->commits_requested = target;
+    }
+    _impl->commit_requested.notify_one();
+
+    _impl->commit_completed.wait(lock, [&] { return _impl->commits_completed >= target; });
+
+    if (_impl->error) {
+        std::rethrow_exception(_impl->error);
+    }
+}
+
+void change_stream_checkpointer::close() {
+    const auto final_error = _impl->stop();
+    if (final_error) {
+        std::rethrow_exception(final_error);
+    }
+}
+
+stdx::optional<change_stream_checkpointer::checkpoint>
+change_stream_checkpointer::last_checkpoint() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    return _impl->persisted;
+}
+
+options::change_stream change_stream_checkpointer::resume_options(
+    options::change_stream options) const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    if (_impl->persisted) {
+        // The options outlive the lock, so they hold their own copy of the token.
+        options.resume_after(bsoncxx::document::value{_impl->persisted->resume_token});
+    }
+    return options;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,171 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/options/change_stream_checkpointer.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class persisting the progress of a change stream consumer, so that it can resume where it
+/// stopped after a restart.
+///
+/// Workers acknowledge resume tokens as they finish processing, which only records them in
+/// memory. A background thread persists the acknowledgement with the highest sequence number once
+/// per commit interval, so a single write covers any number of acknowledgements. Each token
+/// acknowledged must cover every notification before it, as the low watermark of a
+/// mongocxx::change_stream_dispatcher does; acknowledgements with a lower sequence number than one
+/// already received are ignored, so they may arrive out of order from several workers.
+///
+/// Checkpoints are persisted either to a file, which is replaced atomically by writing and
+/// syncing a temporary file and renaming it, or to a document of a collection, with one upsert.
+///
+/// The member functions of a change_stream_checkpointer may be called concurrently.
+///
+class MONGOCXX_API change_stream_checkpointer {
+   public:
+    ///
+    /// A persisted position of a change stream.
+    ///
+    struct checkpoint {
+        /// The sequence number acknowledged with the token.
+        std::uint64_t sequence;
+
+        /// The token from which to resume the change stream.
+        bsoncxx::document::value resume_token;
+    };
+
+    ///
+    /// Constructs a change_stream_checkpointer persisting checkpoints to a file, and loads the
+    /// checkpoint the file holds, if it exists.
+    ///
+    /// @param path
+    ///   The path of the file. A temporary file with the suffix ".tmp" is written next to it.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::change_stream_checkpointer.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid or the file does not hold a
+    ///   checkpoint.
+    /// @throws std::system_error if the file cannot be read.
+    ///
+    explicit change_stream_checkpointer(std::string path,
+                                        const options::change_stream_checkpointer& options = {});
+
+    ///
+    /// Constructs a change_stream_checkpointer persisting checkpoints to a document of a
+    /// collection, and loads the checkpoint the document holds, if it exists.
+    ///
+    /// @param pool
+    ///   The pool from which the background thread acquires its client. It must outlive the
+    ///   checkpointer.
+    /// @param db_name
+    ///   The name of the database holding the collection.
+    /// @param collection_name
+    ///   The name of the collection.
+    /// @param id
+    ///   The _id of the document holding the checkpoint, which identifies the consumer.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::change_stream_checkpointer.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid or the document does not hold a
+    ///   checkpoint.
+    /// @throws mongocxx::query_exception if the document cannot be read.
+    ///
+    change_stream_checkpointer(pool& pool,
+                               bsoncxx::string::view_or_value db_name,
+                               bsoncxx::string::view_or_value collection_name,
+                               bsoncxx::string::view_or_value id,
+                               const options::change_stream_checkpointer& options = {});
+
+    ///
+    /// Closes the checkpointer, if it is still open. The error of the final commit cannot be
+    /// reported and is lost; call close() first to observe it.
+    ///
+    ~change_stream_checkpointer();
+
+    change_stream_checkpointer(const change_stream_checkpointer&) = delete;
+    change_stream_checkpointer& operator=(const change_stream_checkpointer&) = delete;
+
+    ///
+    /// Records that every notification up to a resume token has been processed. The token is
+    /// persisted by the next commit.
+    ///
+    /// @param resume_token
+    ///   The token from which to resume the change stream. It is copied.
+    /// @param sequence
+    ///   A number increasing with the position of the token in the change stream.
+    ///
+    void acknowledge(bsoncxx::document::view resume_token, std::uint64_t sequence);
+
+    ///
+    /// Persists the latest acknowledgement now, sharing the write with other callers, and waits
+    /// for it.
+    ///
+    /// @throws mongocxx::operation_exception or std::system_error if the write fails.
+    /// @throws mongocxx::logic_error if the checkpointer is closed.
+    ///
+    void flush();
+
+    ///
+    /// Persists the latest acknowledgement, if it has not been persisted yet, and stops the
+    /// background thread. Acknowledgements received afterwards are not persisted. Calling close()
+    /// again reports the outcome of the same final commit.
+    ///
+    /// @throws mongocxx::operation_exception or std::system_error if the final write fails.
+    ///
+    void close();
+
+    ///
+    /// Gets the latest persisted checkpoint, which is the one loaded on construction until a
+    /// commit succeeds.
+    ///
+    /// @return The latest persisted checkpoint, or a disengaged optional if there is none.
+    ///
+    stdx::optional<checkpoint> last_checkpoint() const;
+
+    ///
+    /// Sets resume_after on change stream options to the latest persisted checkpoint, if any.
+    ///
+    /// @param options
+    ///   The options to complete.
+    ///
+    /// @return
+    ///   The options with resume_after set, to pass to a watch helper.
+    ///
+    options::change_stream resume_options(options::change_stream options = {}) const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,276 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/change_stream_dispatcher.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/change_stream_dispatcher.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+const std::int32_t k_default_workers = 4;
+const std::int32_t k_default_max_queued_events = 1000;
+const std::chrono::milliseconds k_default_max_wait{100};
+
+// FNV-1a over the encoded documentKey. The key of a document is encoded identically in every
+// notification about it, so equal keys always select the same worker.
+std::uint64_t hash_key(bsoncxx::document::view key) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (std::size_t i = 0; i < key.length(); ++i) {
+        hash ^= key.data()[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+stdx::optional<bsoncxx::document::value> event_token(bsoncxx::document::view event) {
+    const auto id = event["_id"];
+    if (!id || id.type() != bsoncxx::type::k_document) {
+        return stdx::nullopt;
+    }
+    return bsoncxx::document::value{id.get_document().value};
+}
+
+}  // namespace
+
+change_stream_dispatcher::impl::impl(change_stream stream,
+                                     handler handler,
+                                     std::size_t workers,
+                                     std::size_t max_queued_events,
+                                     std::chrono::milliseconds max_wait)
+    : stream(std::move(stream)),
+      handler_fn(std::move(handler)),
+      max_queued_events(max_queued_events),
+      max_wait(max_wait) {
+    for (std::size_t i = 0; i < workers; ++i) {
+        this->workers.push_back(stdx::make_unique<worker>());
+    }
+}
+
+void change_stream_dispatcher::impl::read() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (stopping) {
+                return;
+            }
+        }
+
+        std::vector<bsoncxx::document::value> events;
+        stdx::optional<bsoncxx::document::value> batch_token;
+        try {
+            events = stream.next_batch(max_queued_events, max_wait);
+
+            const auto token = stream.get_resume_token();
+            if (token) {
+                batch_token = bsoncxx::document::value{*token};
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{mutex};
+            stop(std::current_exception());
+            return;
+        }
+
+        for (auto&& event : events) {
+            const auto key = event.view()["documentKey"];
+
+            if (!key || key.type() != bsoncxx::type::k_document) {
+                // Notifications about the collection itself are ordered with respect to every
+                // document, so they wait for the workers to finish and run on this thread.
+                std::uint64_t sequence;
+                {
+                    std::unique_lock<std::mutex> lock{mutex};
+                    progress.wait(lock, [&] { return stopping || pending.empty(); });
+                    if (stopping) {
+                        return;
+                    }
+                    sequence = record(event_token(event.view()));
+                }
+
+                if (!handle(event.view())) {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{mutex};
+                complete(sequence);
+                continue;
+            }
+
+            auto& w = *workers[hash_key(key.get_document().value) % workers.size()];
+
+            std::unique_lock<std::mutex> lock{mutex};
+            progress.wait(lock, [&] { return stopping || w.queue.size() < max_queued_events; });
+            if (stopping) {
+                return;
+            }
+
+            const auto sequence = record(event_token(event.view()));
+            w.queue.push_back(queued_event{sequence, std::move(event)});
+            w.event_queued.notify_one();
+        }
+
+        // The token following the batch lets the watermark advance on a stream with no
+        // notification, once every notification before it has been handled.
+        if (batch_token) {
+            std::lock_guard<std::mutex> lock{mutex};
+            complete(record(std::move(batch_token)));
+        }
+    }
+}
+
+void change_stream_dispatcher::impl::work(worker& w) {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        w.event_queued.wait(lock, [&] { return stopping || !w.queue.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        queued_event next = std::move(w.queue.front());
+        w.queue.pop_front();
+        progress.notify_all();
+
+        lock.unlock();
+        const bool handled = handle(next.event.view());
+        lock.lock();
+
+        if (!handled) {
+            return;
+        }
+
+        complete(next.sequence);
+    }
+}
+
+bool change_stream_dispatcher::impl::handle(bsoncxx::document::view event) {
+    try {
+        handler_fn(event);
+        return true;
+    } catch (...) {
+        std::lock_guard<std::mutex> lock{mutex};
+        stop(std::current_exception());
+        return false;
+    }
+}
+
+std::uint64_t change_stream_dispatcher::impl::record(
+    stdx::optional<bsoncxx::document::value> resume_token) {
+    const auto sequence = next_sequence++;
+    pending.emplace(sequence, position{std::move(resume_token), false});
+    return sequence;
+}
+
+void change_stream_dispatcher::impl::complete(std::uint64_t sequence) {
+    pending.find(sequence)->second.handled = true;
+
+    while (!pending.empty() && pending.begin()->second.handled) {
+        auto& passed = *pending.begin();
+        if (passed.second.resume_token) {
+            low_watermark = watermark{passed.first, std::move(*passed.second.resume_token)};
+        }
+        pending.erase(pending.begin());
+    }
+
+    progress.notify_all();
+}
+
+void change_stream_dispatcher::impl::stop(std::exception_ptr cause) {
+    if (cause && !error) {
+        error = cause;
+    }
+
+    stopping = true;
+    progress.notify_all();
+    for (auto& w : workers) {
+        w->event_queued.notify_all();
+    }
+}
+
+change_stream_dispatcher::change_stream_dispatcher(
+    change_stream stream, handler handler, const options::change_stream_dispatcher& options) {
+    if (!handler) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "a change_stream_dispatcher requires a handler"};
+    }
+
+    const auto workers = options.workers().value_or(k_default_workers);
+    if (workers <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_dispatcher::workers()"};
+    }
+
+    const auto max_queued_events =
+        options.max_queued_events().value_or(k_default_max_queued_events);
+    if (max_queued_events <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_dispatcher::max_queued_events()"};
+    }
+
+    const auto max_wait = options.max_wait().value_or(k_default_max_wait);
+    if (max_wait.count() < 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "non-negative value required for options::change_stream_dispatcher::max_wait()"};
+    }
+
+    _impl = stdx::make_unique<impl>(std::move(stream),
+                                    std::move(handler),
+                                    static_cast<std::size_t>(workers),
+                                    static_cast<std::size_t>(max_queued_events),
+                                    max_wait);
+
+    for (auto& w : _impl->workers) {
+        auto* target = w.get();
+        w->thread = std::thread{[this, target] { _impl->work(*target); }};
+    }
+    _impl->reader = std::thread{[this] { _impl->read(); }};
+}
+
+change_stream_dispatcher::~change_stream_dispatcher() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stop(nullptr);
+    }
+
+    _impl->reader.join();
+    for (auto& w : _impl->workers) {
+        w->thread.join();
+    }
+}
+
+stdx::optional<change_stream_dispatcher::watermark> change_stream_dispatcher::low_watermark()
+    const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    return _impl->low_watermark;
+}
+
+void change_stream_dispatcher::rethrow_if_failed() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    if (_impl->error) {
+        std::rethrow_exception(_impl->error);
+    }
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
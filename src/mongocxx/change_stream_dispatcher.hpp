@@ -0,0 +1,120 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/options/change_stream_dispatcher.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class processing the notifications of a change stream on several worker threads while keeping
+/// the notifications about each document in order.
+///
+/// Each notification is assigned to a worker by hashing its documentKey, so notifications about
+/// the same document are handled one after the other, in the order of the change stream, while
+/// notifications about different documents are handled in parallel. Notifications without a
+/// documentKey, such as drop or invalidate, are handled once every earlier notification has been
+/// handled, and before any later one.
+///
+/// The dispatcher tracks a low watermark: the resume token of the latest position in the change
+/// stream up to which every notification has been handled. Resuming a change stream after the
+/// low watermark never skips a notification, although notifications handled after it are
+/// delivered again.
+///
+/// A change_stream_dispatcher takes ownership of its change stream, which should have a
+/// max_await_time so that destruction does not wait on an idle stream indefinitely.
+///
+class MONGOCXX_API change_stream_dispatcher {
+   public:
+    ///
+    /// The function handling a notification, called on a worker thread.
+    ///
+    using handler = std::function<void(bsoncxx::document::view event)>;
+
+    ///
+    /// A position in the change stream up to which every notification has been handled.
+    ///
+    struct watermark {
+        /// A number which increases with every position of the change stream read by the
+        /// dispatcher.
+        std::uint64_t sequence;
+
+        /// The token from which to resume the change stream after this position.
+        bsoncxx::document::value resume_token;
+    };
+
+    ///
+    /// Constructs a change_stream_dispatcher and starts reading the change stream.
+    ///
+    /// @param stream
+    ///   The change stream to process.
+    /// @param handler
+    ///   The function handling each notification. If it throws, the dispatcher stops and the
+    ///   notification is not included in the low watermark.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::change_stream_dispatcher.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    ///
+    change_stream_dispatcher(change_stream stream,
+                             handler handler,
+                             const options::change_stream_dispatcher& options = {});
+
+    ///
+    /// Stops reading the change stream, waits for the notifications being handled, and discards
+    /// those still queued.
+    ///
+    ~change_stream_dispatcher();
+
+    change_stream_dispatcher(const change_stream_dispatcher&) = delete;
+    change_stream_dispatcher& operator=(const change_stream_dispatcher&) = delete;
+
+    ///
+    /// Gets the low watermark.
+    ///
+    /// @return
+    ///   The position up to which every notification has been handled, or a disengaged optional if
+    ///   no position has been reached yet.
+    ///
+    stdx::optional<watermark> low_watermark() const;
+
+    ///
+    /// Rethrows the exception which stopped the dispatcher, if any.
+    ///
+    /// @throws the exception thrown by the handler or by the change stream.
+    ///
+    void rethrow_if_failed() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
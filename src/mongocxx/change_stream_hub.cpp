@@ -0,0 +1,346 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/change_stream_hub.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/change_stream_hub.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+const std::chrono::milliseconds k_default_max_await_time{500};
+
+// How long the background thread collects events before delivering them.
+const std::chrono::milliseconds k_batch_wait{20};
+const std::size_t k_max_batch_size = 1000;
+
+}  // namespace
+
+change_stream change_stream_hub::impl::open_change_stream(
+    const std::vector<std::shared_ptr<subscriber>>& targets) {
+    pipeline stages;
+
+    const bool everything =
+        std::any_of(targets.begin(), targets.end(), [](const std::shared_ptr<subscriber>& target) {
+            return target->matcher.filter().empty();
+        });
+
+    if (!everything) {
+        if (targets.size() == 1) {
+            stages.match(targets.front()->matcher.filter());
+        } else {
+            bsoncxx::builder::basic::array any;
+            for (const auto& target : targets) {
+                any.append(target->matcher.filter());
+            }
+            stages.match(make_document(kvp("$or", any.extract())));
+        }
+    }
+
+    options::change_stream options;
+    options.max_await_time(max_await_time);
+    if (full_document) {
+        options.full_document(*full_document);
+    }
+    if (batch_size) {
+        options.batch_size(*batch_size);
+    }
+    if (collation) {
+        options.collation(collation->view());
+    }
+    if (token) {
+        options.resume_after(token->view());
+    }
+
+    return (*watch_client)[db_name][collection_name].watch(stages, options);
+}
+
+bool change_stream_hub::impl::deliver(const event& shared, std::unique_lock<std::mutex>& lock) {
+    // Filters never change, so the subscribers to deliver to are found before taking the lock.
+    std::vector<std::shared_ptr<subscriber>> matched;
+    {
+        const auto targets = subscribers;
+        lock.unlock();
+        for (const auto& target : targets) {
+            if (target->matcher.matches(shared->view())) {
+                matched.push_back(target);
+            }
+        }
+        lock.lock();
+    }
+
+    for (const auto& target : matched) {
+        if (target->disconnected) {
+            continue;
+        }
+
+        if (target->queue.size() >= target->max_queued_events) {
+            switch (target->policy) {
+                case overflow_policy::k_block:
+                    room.wait(lock, [&] {
+                        return stopping || target->disconnected ||
+                               target->queue.size() < target->max_queued_events;
+                    });
+                    if (stopping) {
+                        return false;
+                    }
+                    if (target->disconnected) {
+                        continue;
+                    }
+                    break;
+                case overflow_policy::k_drop_oldest:
+                    target->queue.pop_front();
+                    ++target->dropped;
+                    break;
+                case overflow_policy::k_disconnect:
+                    disconnect(target);
+                    continue;
+            }
+        }
+
+        target->queue.push_back(shared);
+        target->event_queued.notify_one();
+    }
+
+    return true;
+}
+
+void change_stream_hub::impl::disconnect(const std::shared_ptr<subscriber>& target) {
+    target->disconnected = true;
+    target->event_queued.notify_all();
+    room.notify_all();
+    stream_opened.notify_all();
+
+    const auto it = std::find(subscribers.begin(), subscribers.end(), target);
+    if (it != subscribers.end()) {
+        subscribers.erase(it);
+        ++pipeline_generation;
+    }
+}
+
+void change_stream_hub::impl::run() {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        if (subscribers.empty() && stream) {
+            // Nobody is listening; the next subscriber starts from the present.
+            auto closing = std::move(stream);
+            stream = stdx::nullopt;
+            token = stdx::nullopt;
+            lock.unlock();
+            closing = stdx::nullopt;
+            lock.lock();
+            continue;
+        }
+
+        subscribers_changed.wait(lock, [&] { return stopping || !subscribers.empty(); });
+        if (stopping) {
+            return;
+        }
+
+        const auto generation = pipeline_generation;
+        const bool reopen = generation != opened_generation || !stream;
+        const auto targets = subscribers;
+        lock.unlock();
+
+        std::vector<bsoncxx::document::value> events;
+        try {
+            if (reopen) {
+                stream = stdx::nullopt;
+                stream = open_change_stream(targets);
+
+                std::lock_guard<std::mutex> opened{mutex};
+                opened_generation = generation;
+                stream_opened.notify_all();
+            }
+
+            events = stream->next_batch(k_max_batch_size, k_batch_wait);
+
+            const auto latest = stream->get_resume_token();
+            if (latest) {
+                token = bsoncxx::document::value{*latest};
+            }
+        } catch (...) {
+            stream = stdx::nullopt;
+            lock.lock();
+            error = std::current_exception();
+            while (!subscribers.empty()) {
+                disconnect(subscribers.back());
+            }
+            return;
+        }
+
+        lock.lock();
+        for (auto&& e : events) {
+            const auto operation_type = e.view()["operationType"];
+            const bool invalidate = operation_type &&
+                                    operation_type.type() == bsoncxx::type::k_string &&
+                                    operation_type.get_string().value == "invalidate";
+
+            if (!deliver(std::make_shared<const bsoncxx::document::value>(std::move(e)), lock)) {
+                return;
+            }
+
+            if (invalidate) {
+                // The change stream cannot be resumed past an invalidate event.
+                while (!subscribers.empty()) {
+                    disconnect(subscribers.back());
+                }
+                break;
+            }
+        }
+    }
+}
+
+change_stream_hub::subscription::subscription(std::unique_ptr<impl> impl)
+    : _impl(std::move(impl)) {}
+
+change_stream_hub::subscription::subscription(subscription&&) noexcept = default;
+change_stream_hub::subscription& change_stream_hub::subscription::operator=(
+    subscription&&) noexcept = default;
+change_stream_hub::subscription::~subscription() = default;
+
+change_stream_hub::subscription::impl::~impl() {
+    std::lock_guard<std::mutex> lock{hub->mutex};
+    hub->disconnect(state);
+}
+
+change_stream_hub::event change_stream_hub::subscription::next(
+    std::chrono::milliseconds max_wait) {
+    auto& hub = *_impl->hub;
+    auto& state = *_impl->state;
+
+    std::unique_lock<std::mutex> lock{hub.mutex};
+    state.event_queued.wait_for(
+        lock, max_wait, [&] { return !state.queue.empty() || state.disconnected; });
+
+    if (state.queue.empty()) {
+        return nullptr;
+    }
+
+    event next = std::move(state.queue.front());
+    state.queue.pop_front();
+    hub.room.notify_all();
+    return next;
+}
+
+bool change_stream_hub::subscription::disconnected() const {
+    std::lock_guard<std::mutex> lock{_impl->hub->mutex};
+    return _impl->state->disconnected;
+}
+
+std::uint64_t change_stream_hub::subscription::dropped() const {
+    std::lock_guard<std::mutex> lock{_impl->hub->mutex};
+    return _impl->state->dropped;
+}
+
+change_stream_hub::change_stream_hub(class pool& pool,
+                                     bsoncxx::string::view_or_value db_name,
+                                     bsoncxx::string::view_or_value collection_name,
+                                     const options::change_stream& options) {
+    if (options.resume_after() || options.start_after()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "a change_stream_hub resumes its change stream itself"};
+    }
+
+    stdx::optional<std::string> full_document;
+    if (options.full_document()) {
+        const auto view = options.full_document()->view();
+        full_document = std::string{view.data(), view.size()};
+    }
+
+    stdx::optional<bsoncxx::document::value> collation;
+    if (options.collation()) {
+        collation = bsoncxx::document::value{options.collation()->view()};
+    }
+
+    _impl = stdx::make_unique<impl>(pool,
+                                    db_name.terminated().data(),
+                                    collection_name.terminated().data(),
+                                    std::move(full_document),
+                                    options.batch_size(),
+                                    std::move(collation),
+                                    options.max_await_time().value_or(k_default_max_await_time));
+
+    _impl->watcher = std::thread{[this] { _impl->run(); }};
+}
+
+change_stream_hub::~change_stream_hub() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stopping = true;
+        while (!_impl->subscribers.empty()) {
+            _impl->disconnect(_impl->subscribers.back());
+        }
+    }
+    _impl->subscribers_changed.notify_one();
+    _impl->watcher.join();
+}
+
+change_stream_hub::subscription change_stream_hub::subscribe(
+    bsoncxx::document::view_or_value filter,
+    std::size_t max_queued_events,
+    overflow_policy policy) {
+    if (max_queued_events == 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for max_queued_events"};
+    }
+
+    auto state = std::make_shared<impl::subscriber>(
+        bsoncxx::matcher{std::move(filter)}, max_queued_events, policy);
+
+    {
+        std::unique_lock<std::mutex> lock{_impl->mutex};
+        if (_impl->stopping || _impl->error) {
+            state->disconnected = true;
+        } else {
+            _impl->subscribers.push_back(state);
+            const auto generation = ++_impl->pipeline_generation;
+            _impl->subscribers_changed.notify_one();
+
+            // Events are delivered from the time the change stream including the filter is open.
+            _impl->stream_opened.wait(lock, [&] {
+                return _impl->opened_generation >= generation || state->disconnected;
+            });
+        }
+    }
+
+    return subscription{stdx::make_unique<subscription::impl>(_impl.get(), std::move(state))};
+}
+
+void change_stream_hub::rethrow_if_failed() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    if (_impl->error) {
+        std::rethrow_exception(_impl->error);
+    }
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,182 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class sharing one change stream on a collection between many subscribers in a process.
+///
+/// Each subscriber registers a filter, which is a $match expression over change events. The hub
+/// watches the collection with the union of the filters, so the server only returns events that
+/// at least one subscriber is interested in, then evaluates each filter on the client and queues
+/// the matching events for their subscribers. Events are shared between subscribers without
+/// copying.
+///
+/// When the set of subscribers changes, the hub reopens the change stream with the new union,
+/// resuming after the last event it read, so existing subscribers miss no event. A new subscriber
+/// may receive events from shortly before it subscribed.
+///
+/// Filters are evaluated on the client with bsoncxx::matcher, which supports the common query
+/// operators; see its documentation.
+///
+/// The hub uses a client acquired from a pool on a background thread. Subscriptions must be
+/// destroyed before the hub.
+///
+class MONGOCXX_API change_stream_hub {
+   public:
+    ///
+    /// A change event shared between subscribers.
+    ///
+    using event = std::shared_ptr<const bsoncxx::document::value>;
+
+    ///
+    /// What the hub does with an event for a subscriber whose queue is full.
+    ///
+    enum class overflow_policy {
+        /// Wait for the subscriber to take an event, which delays every subscriber.
+        k_block,
+
+        /// Discard the oldest queued event.
+        k_drop_oldest,
+
+        /// Stop delivering events to the subscriber, which can still take the events queued.
+        k_disconnect,
+    };
+
+    ///
+    /// Class representing the registration of a subscriber. Destroying it unsubscribes.
+    ///
+    class MONGOCXX_API subscription {
+       public:
+        subscription(subscription&&) noexcept;
+        subscription& operator=(subscription&&) noexcept;
+        ~subscription();
+
+        ///
+        /// Takes the next event queued for the subscriber, waiting for one if none is queued.
+        ///
+        /// @param max_wait
+        ///   How long to wait for an event.
+        ///
+        /// @return
+        ///   The next event, or a null pointer if none was queued within max_wait or the
+        ///   subscription is disconnected and its queue is empty.
+        ///
+        event next(std::chrono::milliseconds max_wait);
+
+        ///
+        /// Gets whether the hub stopped delivering events to the subscriber, because its queue
+        /// overflowed with overflow_policy::k_disconnect, the change stream failed or was
+        /// invalidated, or the hub was destroyed.
+        ///
+        bool disconnected() const;
+
+        ///
+        /// Gets the number of events discarded with overflow_policy::k_drop_oldest.
+        ///
+        std::uint64_t dropped() const;
+
+       private:
+        friend class change_stream_hub;
+
+        class MONGOCXX_PRIVATE impl;
+
+        MONGOCXX_PRIVATE explicit subscription(std::unique_ptr<impl> impl);
+
+        std::unique_ptr<impl> _impl;
+    };
+
+    ///
+    /// Constructs a change_stream_hub. The change stream is opened when the first subscriber
+    /// subscribes.
+    ///
+    /// @param pool
+    ///   The pool from which the background thread acquires its client. It must outlive the hub.
+    /// @param db_name
+    ///   The name of the database holding the collection.
+    /// @param collection_name
+    ///   The name of the collection to watch.
+    /// @param options
+    ///   Optional arguments for the change stream, of which full_document, batch_size, collation
+    ///   and max_await_time are used. The hub resumes the change stream itself, so resume_after
+    ///   and start_after must not be set. max_await_time bounds how long subscribing and
+    ///   destroying the hub wait for a request in progress, and defaults to 500 milliseconds.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    ///
+    change_stream_hub(pool& pool,
+                      bsoncxx::string::view_or_value db_name,
+                      bsoncxx::string::view_or_value collection_name,
+                      const options::change_stream& options = {});
+
+    ///
+    /// Stops the background thread and disconnects every subscriber.
+    ///
+    ~change_stream_hub();
+
+    change_stream_hub(const change_stream_hub&) = delete;
+    change_stream_hub& operator=(const change_stream_hub&) = delete;
+
+    ///
+    /// Registers a subscriber.
+    ///
+    /// @param filter
+    ///   The $match expression selecting the events delivered to the subscriber. An empty filter
+    ///   selects every event.
+    /// @param max_queued_events
+    ///   The maximum number of events queued for the subscriber. Must be positive.
+    /// @param policy
+    ///   What to do with an event when the queue is full.
+    ///
+    /// @return The subscription, which receives events until it is destroyed.
+    ///
+    /// @throws mongocxx::logic_error if max_queued_events is zero.
+    /// @throws bsoncxx::exception if the filter uses an operator bsoncxx::matcher does not support.
+    ///
+    subscription subscribe(bsoncxx::document::view_or_value filter,
+                           std::size_t max_queued_events = 1000,
+                           overflow_policy policy = overflow_policy::k_block);
+
+    ///
+    /// Rethrows the exception which stopped the change stream, if any.
+    ///
+    /// @throws mongocxx::query_exception if the change stream failed.
+    ///
+    void rethrow_if_failed() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
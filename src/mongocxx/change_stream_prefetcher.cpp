@@ -0,0 +1,147 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/change_stream_prefetcher.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/private/change_stream_prefetcher.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+const std::int32_t k_default_max_batch_size = 1000;
+const std::chrono::milliseconds k_default_max_wait{100};
+const std::int32_t k_default_max_queued_batches = 2;
+
+}  // namespace
+
+void change_stream_prefetcher::impl::run() {
+    stdx::optional<bsoncxx::document::value> last_token;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            batch_taken.wait(lock, [&] { return stopping || queue.size() < max_queued_batches; });
+            if (stopping) {
+                return;
+            }
+        }
+
+        batch fetched;
+        try {
+            fetched.events = stream.next_batch(max_batch_size, max_wait);
+
+            const auto token = stream.get_resume_token();
+            if (token) {
+                fetched.resume_token = bsoncxx::document::value{*token};
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock{mutex};
+                error = std::current_exception();
+            }
+            batch_queued.notify_one();
+            return;
+        }
+
+        const bool advanced = fetched.resume_token &&
+                              (!last_token || last_token->view() != fetched.resume_token->view());
+        if (fetched.events.empty() && !advanced) {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (stopping) {
+                return;
+            }
+            continue;
+        }
+
+        if (advanced) {
+            last_token = fetched.resume_token;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            queue.push_back(std::move(fetched));
+        }
+        batch_queued.notify_one();
+    }
+}
+
+change_stream_prefetcher::change_stream_prefetcher(
+    change_stream stream, const options::change_stream_prefetcher& options) {
+    const auto max_batch_size = options.max_batch_size().value_or(k_default_max_batch_size);
+    if (max_batch_size <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_prefetcher::max_batch_size()"};
+    }
+
+    const auto max_wait = options.max_wait().value_or(k_default_max_wait);
+    if (max_wait.count() < 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "non-negative value required for options::change_stream_prefetcher::max_wait()"};
+    }
+
+    const auto max_queued_batches =
+        options.max_queued_batches().value_or(k_default_max_queued_batches);
+    if (max_queued_batches <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::change_stream_prefetcher::max_queued_batches()"};
+    }
+
+    _impl = stdx::make_unique<impl>(std::move(stream),
+                                    static_cast<std::size_t>(max_batch_size),
+                                    max_wait,
+                                    static_cast<std::size_t>(max_queued_batches));
+    _impl->fetcher = std::thread{[this] { _impl->run(); }};
+}
+
+change_stream_prefetcher::~change_stream_prefetcher() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stopping = true;
+    }
+    _impl->batch_taken.notify_one();
+    _impl->fetcher.join();
+}
+
+stdx::optional<change_stream_prefetcher::batch> change_stream_prefetcher::next_batch(
+    std::chrono::milliseconds max_wait) {
+    std::unique_lock<std::mutex> lock{_impl->mutex};
+
+    if (!_impl->batch_queued.wait_for(
+            lock, max_wait, [&] { return !_impl->queue.empty() || _impl->error; })) {
+        return stdx::nullopt;
+    }
+
+    if (_impl->queue.empty()) {
+        std::rethrow_exception(_impl->error);
+    }
+
+    batch taken = std::move(_impl->queue.front());
+    _impl->queue.pop_front();
+    lock.unlock();
+
+    _impl->batch_taken.notify_one();
+    return stdx::optional<batch>{std::move(taken)};
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
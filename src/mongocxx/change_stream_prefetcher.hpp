@@ -0,0 +1,102 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/options/change_stream_prefetcher.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class consuming a change stream from a background thread, so that the next batch of
+/// notifications is requested from the server while the previous one is processed.
+///
+/// The prefetching thread collects notifications with change_stream::next_batch and queues them,
+/// together with the resume token from which to resume once they have been processed. Fetching
+/// pauses while the queue is full. Batches with no notification are queued only when they advance
+/// the resume token, so that consumers checkpointing their progress can observe it.
+///
+/// A change_stream_prefetcher takes ownership of its change stream. It must be consumed from a
+/// single thread.
+///
+class MONGOCXX_API change_stream_prefetcher {
+   public:
+    ///
+    /// A batch of notifications.
+    ///
+    struct batch {
+        /// The notifications, in the order of the change stream.
+        std::vector<bsoncxx::document::value> events;
+
+        /// The token from which to resume the change stream after the notifications, if any.
+        stdx::optional<bsoncxx::document::value> resume_token;
+    };
+
+    ///
+    /// Constructs a change_stream_prefetcher and starts its prefetching thread.
+    ///
+    /// @param stream
+    ///   The change stream to consume.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::change_stream_prefetcher.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    ///
+    explicit change_stream_prefetcher(change_stream stream,
+                                      const options::change_stream_prefetcher& options = {});
+
+    ///
+    /// Stops the prefetching thread, waiting for a request in progress to return, and destroys the
+    /// change stream.
+    ///
+    ~change_stream_prefetcher();
+
+    change_stream_prefetcher(const change_stream_prefetcher&) = delete;
+    change_stream_prefetcher& operator=(const change_stream_prefetcher&) = delete;
+
+    ///
+    /// Takes the next batch of notifications from the queue, waiting for one if the queue is
+    /// empty.
+    ///
+    /// @param max_wait
+    ///   How long to wait for a batch.
+    ///
+    /// @return
+    ///   The next batch, or a disengaged optional if none was queued within max_wait.
+    ///
+    /// @throws mongocxx::query_exception if the change stream failed, once every batch queued
+    ///   before the failure has been taken.
+    ///
+    stdx::optional<batch> next_batch(std::chrono::milliseconds max_wait);
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -171,6 +171,8 @@ class MONGOCXX_API client_session {
     friend class collection;
     friend class database;
     friend class index_view;
+    friend class prepared_aggregate;
+    friend class prepared_find;
 
     class MONGOCXX_PRIVATE impl;
 
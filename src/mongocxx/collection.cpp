@@ -42,6 +42,7 @@
 #include <mongocxx/exception/write_exception.hpp>
 #include <mongocxx/hint.hpp>
 #include <mongocxx/model/write.hpp>
+#include <mongocxx/options/private/find.hh>
 #include <mongocxx/private/bulk_write.hh>
 #include <mongocxx/private/client_session.hh>
 #include <mongocxx/private/collection.hh>
@@ -294,94 +295,6 @@ bulk_write collection::create_bulk_write(const client_session& session,
     return writes;
 }
 
-namespace {
-
-bsoncxx::builder::basic::document build_find_options_document(const options::find& options) {
-    bsoncxx::builder::basic::document options_builder;
-
-    if (options.allow_disk_use()) {
-        options_builder.append(kvp("allowDiskUse", *options.allow_disk_use()));
-    }
-
-    if (options.allow_partial_results()) {
-        options_builder.append(kvp("allowPartialResults", *options.allow_partial_results()));
-    }
-
-    if (options.batch_size()) {
-        options_builder.append(kvp("batchSize", *options.batch_size()));
-    }
-
-    if (options.collation()) {
-        options_builder.append(kvp("collation", *options.collation()));
-    }
-
-    if (options.comment()) {
-        options_builder.append(kvp("comment", *options.comment()));
-    }
-
-    if (options.cursor_type()) {
-        if (*options.cursor_type() == cursor::type::k_tailable) {
-            options_builder.append(kvp("tailable", bsoncxx::types::b_bool{true}));
-        } else if (*options.cursor_type() == cursor::type::k_tailable_await) {
-            options_builder.append(kvp("tailable", bsoncxx::types::b_bool{true}));
-            options_builder.append(kvp("awaitData", bsoncxx::types::b_bool{true}));
-        } else if (*options.cursor_type() == cursor::type::k_non_tailable) {
-        } else {
-            throw logic_error{error_code::k_invalid_parameter};
-        }
-    }
-
-    if (options.hint()) {
-        options_builder.append(kvp("hint", options.hint()->to_value()));
-    }
-
-    if (options.limit()) {
-        options_builder.append(kvp("limit", *options.limit()));
-    }
-
-    if (options.max()) {
-        options_builder.append(kvp("max", *options.max()));
-    }
-
-    if (options.max_time()) {
-        options_builder.append(
-            kvp("maxTimeMS", bsoncxx::types::b_int64{options.max_time()->count()}));
-    }
-
-    if (options.min()) {
-        options_builder.append(kvp("min", *options.min()));
-    }
-
-    if (options.no_cursor_timeout()) {
-        options_builder.append(kvp("noCursorTimeout", *options.no_cursor_timeout()));
-    }
-
-    if (options.projection()) {
-        options_builder.append(
-            kvp("projection", bsoncxx::types::b_document{*options.projection()}));
-    }
-
-    if (options.return_key()) {
-        options_builder.append(kvp("returnKey", *options.return_key()));
-    }
-
-    if (options.show_record_id()) {
-        options_builder.append(kvp("showRecordId", *options.show_record_id()));
-    }
-
-    if (options.skip()) {
-        options_builder.append(kvp("skip", *options.skip()));
-    }
-
-    if (options.sort()) {
-        options_builder.append(kvp("sort", bsoncxx::types::b_document{*options.sort()}));
-    }
-
-    return options_builder;
-}
-
-}  // namespace
-
 cursor collection::_find(const client_session* session,
                          view_or_value filter,
                          const options::find& options) {
@@ -392,7 +305,8 @@ cursor collection::_find(const client_session* session,
         rp_ptr = options.read_preference()->_impl->read_preference_t;
     }
 
-    bsoncxx::builder::basic::document options_builder{build_find_options_document(options)};
+    bsoncxx::builder::basic::document options_builder{
+        options::build_find_options_document(options)};
     if (session) {
         options_builder.append(
             bsoncxx::builder::concatenate_doc{session->_get_impl().to_document()});
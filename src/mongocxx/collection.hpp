@@ -1826,6 +1826,9 @@ class MONGOCXX_API collection {
    private:
     friend class bulk_write;
     friend class database;
+    friend class prepared_aggregate;
+    friend class prepared_find;
+    friend class request_coalescer;
 
     MONGOCXX_PRIVATE collection(const database& database,
                                 bsoncxx::string::view_or_value collection_name);
@@ -17,5 +17,9 @@
 
 #undef MONGOCXX_ENABLE_SSL
 #pragma pop_macro("MONGOCXX_ENABLE_SSL")
+#undef MONGOCXX_ENABLE_ZSTD
+#pragma pop_macro("MONGOCXX_ENABLE_ZSTD")
+#undef MONGOCXX_ENABLE_LZ4
+#pragma pop_macro("MONGOCXX_ENABLE_LZ4")
 
 #include <mongocxx/config/postlude.hpp>
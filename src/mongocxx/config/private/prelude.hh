@@ -19,5 +19,9 @@
 
 #pragma push_macro("MONGOCXX_ENABLE_SSL")
 #undef MONGOCXX_ENABLE_SSL
+#pragma push_macro("MONGOCXX_ENABLE_ZSTD")
+#undef MONGOCXX_ENABLE_ZSTD
+#pragma push_macro("MONGOCXX_ENABLE_LZ4")
+#undef MONGOCXX_ENABLE_LZ4
 
 #include <mongocxx/config/private/config.hh>
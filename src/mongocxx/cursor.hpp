@@ -83,6 +83,8 @@ class MONGOCXX_API cursor {
     friend class client;
     friend class database;
     friend class index_view;
+    friend class prepared_aggregate;
+    friend class prepared_find;
     friend class cursor::iterator;
 
     MONGOCXX_PRIVATE cursor(void* cursor_ptr,
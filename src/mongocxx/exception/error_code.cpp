@@ -84,6 +84,8 @@ class error_category final : public std::error_category {
                 return "an invalid client session was provided";
             case error_code::k_invalid_transaction_options_object:
                 return "an invalid transactions options object was provided";
+            case error_code::k_gridfs_codec_not_supported:
+                return "the GridFS chunk codec is not supported by this build of the driver";
             default:
                 return "unknown mongocxx error";
         }
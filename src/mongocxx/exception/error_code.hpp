@@ -90,6 +90,9 @@ enum class error_code : std::int32_t {
     /// A moved-from mongocxx::options::transaction object has been used.
     k_invalid_transaction_options_object,
 
+    /// A GridFS chunk codec which the driver was built without was requested.
+    k_gridfs_codec_not_supported,
+
     // Add new constant string message to error_code.cpp as well!
 };
 
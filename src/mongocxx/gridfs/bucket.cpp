@@ -14,21 +14,50 @@
 
 #include <mongocxx/config/private/prelude.hh>
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
 #include <ios>
+#include <istream>
+#include <memory>
 #include <string>
+#include <system_error>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+// std::min and std::max are used below.
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/oid.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
 #include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/to_string.hpp>
 #include <mongocxx/database.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
 #include <mongocxx/gridfs/private/bucket.hh>
+#include <mongocxx/gridfs/private/codec.hh>
+#include <mongocxx/gridfs/private/dedup.hh>
+#include <mongocxx/gridfs/private/uploader.hh>
 #include <mongocxx/options/delete.hpp>
+#include <mongocxx/options/find_one_and_delete.hpp>
 #include <mongocxx/options/index.hpp>
 #include <mongocxx/stdx.hpp>
 
@@ -36,6 +65,223 @@ namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
+namespace {
+
+// The number of bytes of a mapped file handed to the uploader at a time by upload_from_file.
+constexpr std::size_t k_upload_slice_bytes = 16 * 1000 * 1000;
+
+// Files of a known length are stored in about this many chunks when the chunk size adapts to their
+// length, with a chunk size which is a multiple of the granularity and at most the largest size.
+// The largest chunk size leaves room in a chunk document for its other fields.
+constexpr std::int64_t k_adaptive_chunks_per_file = 1024;
+constexpr std::int64_t k_adaptive_chunk_granularity = 256 * 1024;
+constexpr std::int64_t k_max_adaptive_chunk_size = 15 * 1024 * 1024;
+
+// Picks the chunk size of a file of a known length, which is never below the bucket's chunk size.
+std::int32_t adaptive_chunk_size(std::int64_t length, std::int32_t min_chunk_size) {
+    if (length <= min_chunk_size * k_adaptive_chunks_per_file) {
+        return min_chunk_size;
+    }
+
+    auto chunk_size = (length + k_adaptive_chunks_per_file - 1) / k_adaptive_chunks_per_file;
+    chunk_size = (chunk_size + k_adaptive_chunk_granularity - 1) / k_adaptive_chunk_granularity *
+                 k_adaptive_chunk_granularity;
+    chunk_size = std::min(chunk_size, k_max_adaptive_chunk_size);
+
+    return static_cast<std::int32_t>(std::max<std::int64_t>(chunk_size, min_chunk_size));
+}
+
+// Returns the number of bytes left in a seekable stream, or a disengaged optional if the stream
+// cannot seek. The position and state of the stream are restored.
+stdx::optional<std::int64_t> remaining_length(std::istream* source) {
+    const auto state = source->rdstate();
+    const auto start = source->tellg();
+    if (start == std::istream::pos_type(-1)) {
+        source->clear(state);
+        return stdx::nullopt;
+    }
+
+    source->seekg(0, std::ios::end);
+    const auto end = source->tellg();
+    source->clear();
+    source->seekg(start);
+    source->clear(state);
+
+    if (end == std::istream::pos_type(-1) || end < start) {
+        return stdx::nullopt;
+    }
+
+    return static_cast<std::int64_t>(end - start);
+}
+
+// A read-only mapping of a whole file, unmapped when destroyed.
+class mapped_file {
+   public:
+    explicit mapped_file(const std::string& path) {
+#if defined(_WIN32)
+        _file = ::CreateFileA(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              NULL,
+                              OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN,
+                              NULL);
+        if (_file == INVALID_HANDLE_VALUE) {
+            throw_last_error("cannot open " + path);
+        }
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(_file, &size)) {
+            throw_last_error("cannot get the size of " + path);
+        }
+        _size = static_cast<std::size_t>(size.QuadPart);
+
+        if (_size == 0) {
+            return;
+        }
+
+        _mapping = ::CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!_mapping) {
+            throw_last_error("cannot map " + path);
+        }
+
+        _data = static_cast<const std::uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!_data) {
+            throw_last_error("cannot map " + path);
+        }
+#else
+        _fd = ::open(path.c_str(), O_RDONLY);
+        if (_fd < 0) {
+            throw std::system_error{errno, std::generic_category(), "cannot open " + path};
+        }
+
+        struct stat info;
+        if (::fstat(_fd, &info) != 0) {
+            const int error = errno;
+            ::close(_fd);
+            throw std::system_error{error, std::generic_category(), "cannot stat " + path};
+        }
+        _size = static_cast<std::size_t>(info.st_size);
+
+        if (_size != 0) {
+            void* data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                ::close(_fd);
+                throw std::system_error{error, std::generic_category(), "cannot map " + path};
+            }
+
+            // The file is read once from start to end, so the kernel can read ahead aggressively.
+            ::madvise(data, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const std::uint8_t*>(data);
+        }
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    ~mapped_file() {
+#if defined(_WIN32)
+        release();
+#else
+        if (_data) {
+            ::munmap(const_cast<std::uint8_t*>(_data), _size);
+        }
+        ::close(_fd);
+#endif
+    }
+
+    const std::uint8_t* data() const {
+        return _data;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+   private:
+#if defined(_WIN32)
+    void release() {
+        if (_data) {
+            ::UnmapViewOfFile(_data);
+        }
+        if (_mapping) {
+            ::CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE) {
+            ::CloseHandle(_file);
+        }
+    }
+
+    [[noreturn]] void throw_last_error(const std::string& what) {
+        const auto error = static_cast<int>(::GetLastError());
+        release();
+        throw std::system_error{error, std::system_category(), what};
+    }
+
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = NULL;
+#else
+    int _fd = -1;
+#endif
+    const std::uint8_t* _data = nullptr;
+    std::size_t _size = 0;
+};
+
+// Opens a file for writing, creating or truncating it.
+int open_for_writing(const std::string& path) {
+#if defined(_WIN32)
+    const int fd = ::_open(path.c_str(),
+                           _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY,
+                           _S_IREAD | _S_IWRITE);
+#else
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+#endif
+    if (fd < 0) {
+        throw std::system_error{errno, std::generic_category(), "cannot open " + path};
+    }
+
+    return fd;
+}
+
+// Sets the size of a newly created file so that its blocks are allocated up front and chunks can
+// be written at their offsets in any order.
+void preallocate(int fd, std::int64_t size, const std::string& path) {
+    if (size == 0) {
+        return;
+    }
+
+    int error = 0;
+#if defined(_WIN32)
+    error = ::_chsize_s(fd, size);
+#else
+#if defined(__linux__)
+    error = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+    // Some filesystems cannot allocate blocks up front, in which case the file is only extended.
+    if (error == EINVAL || error == EOPNOTSUPP) {
+        error = 0;
+    }
+#endif
+    if (!error && ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        error = errno;
+    }
+#endif
+    if (error) {
+        throw std::system_error{error, std::generic_category(), "cannot allocate " + path};
+    }
+}
+
+int close_fd(int fd) {
+#if defined(_WIN32)
+    return ::_close(fd);
+#else
+    return ::close(fd);
+#endif
+}
+
+}  // namespace
+
 bucket::bucket(const database& db, const options::gridfs::bucket& options) {
     std::string bucket_name = "fs";
     if (auto name = options.bucket_name()) {
@@ -56,25 +302,65 @@ bucket::bucket(const database& db, const options::gridfs::bucket& options) {
                           "positive value for chunk_size_bytes required"};
     }
 
+    const auto chunk_codec = options.codec().value_or(options::gridfs::chunk_codec::k_none);
+    if (!codec::supported(chunk_codec)) {
+        throw logic_error{error_code::k_gridfs_codec_not_supported};
+    }
+    const auto codec_level = options.codec_level().value_or(codec::default_level(chunk_codec));
+
+    const bool deduplicate = options.deduplicate().value_or(false);
+    if (deduplicate && chunk_codec != options::gridfs::chunk_codec::k_none) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "a chunk codec cannot be used with deduplication"};
+    }
+
+    if (options.cache_bytes() && *options.cache_bytes() <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for cache_bytes"};
+    }
+
+    const auto revalidate_after =
+        options.cache_revalidate_after().value_or(std::chrono::milliseconds{0});
+    if (revalidate_after.count() < 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "non-negative value required for cache_revalidate_after"};
+    }
+
     collection chunks = db[bucket_name + ".chunks"];
     collection files = db[bucket_name + ".files"];
-
-    _impl = stdx::make_unique<impl>(
-        std::move(bucket_name), default_chunk_size_bytes, std::move(chunks), std::move(files));
+    collection blobs = db[bucket_name + ".blobs"];
+
+    _impl = stdx::make_unique<impl>(bsoncxx::string::to_string(db.name()),
+                                    std::move(bucket_name),
+                                    default_chunk_size_bytes,
+                                    chunk_codec,
+                                    codec_level,
+                                    deduplicate,
+                                    options.adaptive_chunk_size().value_or(false),
+                                    std::move(chunks),
+                                    std::move(files),
+                                    std::move(blobs));
+
+    if (auto cache_bytes = options.cache_bytes()) {
+        _get_impl().cache = std::make_shared<file_cache>(*cache_bytes, revalidate_after);
+    }
 
     if (auto read_concern = options.read_concern()) {
         _get_impl().files.read_concern(*read_concern);
         _get_impl().chunks.read_concern(*read_concern);
+        _get_impl().blobs.read_concern(*read_concern);
     }
 
     if (auto read_preference = options.read_preference()) {
         _get_impl().files.read_preference(*read_preference);
         _get_impl().chunks.read_preference(*read_preference);
+        _get_impl().blobs.read_preference(*read_preference);
     }
 
     if (auto write_concern = options.write_concern()) {
         _get_impl().files.write_concern(*write_concern);
         _get_impl().chunks.write_concern(*write_concern);
+        _get_impl().blobs.write_concern(*write_concern);
     }
 }
 
@@ -120,7 +406,8 @@ uploader bucket::open_upload_stream(const client_session& session,
 uploader bucket::_open_upload_stream_with_id(const client_session* session,
                                              bsoncxx::types::bson_value::view id,
                                              stdx::string_view filename,
-                                             const options::gridfs::upload& options) {
+                                             const options::gridfs::upload& options,
+                                             stdx::optional<std::int64_t> known_length) {
     std::int32_t chunk_size_bytes = _get_impl().default_chunk_size_bytes;
 
     if (auto chunk_size = options.chunk_size_bytes()) {
@@ -131,17 +418,58 @@ uploader bucket::_open_upload_stream_with_id(const client_session* session,
         }
 
         chunk_size_bytes = *chunk_size;
+    } else if (known_length && _get_impl().adaptive_chunk_size && !_get_impl().deduplicate) {
+        // The chunk size of a deduplicated file is the average size of its chunks, which only
+        // depends on their content.
+        chunk_size_bytes = adaptive_chunk_size(*known_length, chunk_size_bytes);
+    }
+
+    auto chunk_codec = _get_impl().default_codec;
+    auto codec_level = _get_impl().default_codec_level;
+    if (auto requested = options.codec()) {
+        if (!codec::supported(*requested)) {
+            throw logic_error{error_code::k_gridfs_codec_not_supported};
+        }
+
+        if (_get_impl().deduplicate && *requested != options::gridfs::chunk_codec::k_none) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "a chunk codec cannot be used with deduplication"};
+        }
+
+        chunk_codec = *requested;
+        codec_level = codec::default_level(chunk_codec);
+    }
+
+    if (auto level = options.codec_level()) {
+        codec_level = *level;
+    }
+
+    if (options.flush_pool() && session) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "options::gridfs::upload::flush_pool() cannot be used with a client session"};
     }
 
     create_indexes_if_nonexistent(session);
 
+    stdx::optional<collection> blobs;
+    if (_get_impl().deduplicate) {
+        blobs = _get_impl().blobs;
+    }
+
     return uploader{session,
                     id,
                     filename,
                     _get_impl().files,
                     _get_impl().chunks,
                     chunk_size_bytes,
-                    std::move(options.metadata())};
+                    std::move(options.metadata()),
+                    options.flush_pool().value_or(nullptr),
+                    _get_impl().database_name,
+                    options.digest(),
+                    chunk_codec,
+                    codec_level,
+                    std::move(blobs)};
 }
 
 uploader bucket::open_upload_stream_with_id(bsoncxx::types::bson_value::view id,
@@ -161,8 +489,7 @@ result::gridfs::upload bucket::upload_from_stream(stdx::string_view filename,
                                                   std::istream* source,
                                                   const options::gridfs::upload& options) {
     auto id = bsoncxx::types::bson_value::view{bsoncxx::types::b_oid{}};
-    upload_from_stream_with_id(id, filename, source, options);
-    return id;
+    return _upload_from_stream_with_id(nullptr, id, filename, source, options);
 }
 
 result::gridfs::upload bucket::upload_from_stream(const client_session& session,
@@ -170,16 +497,66 @@ result::gridfs::upload bucket::upload_from_stream(const client_session& session,
                                                   std::istream* source,
                                                   const options::gridfs::upload& options) {
     auto id = bsoncxx::types::bson_value::view{bsoncxx::types::b_oid{}};
-    upload_from_stream_with_id(session, id, filename, source, options);
-    return id;
+    return _upload_from_stream_with_id(&session, id, filename, source, options);
 }
 
-void bucket::_upload_from_stream_with_id(const client_session* session,
-                                         bsoncxx::types::bson_value::view id,
-                                         stdx::string_view filename,
-                                         std::istream* source,
-                                         const options::gridfs::upload& options) {
-    uploader upload_stream = _open_upload_stream_with_id(session, id, filename, options);
+result::gridfs::upload bucket::_upload_from_file(const client_session* session,
+                                                 stdx::string_view filename,
+                                                 const std::string& path,
+                                                 const options::gridfs::upload& options) {
+    const mapped_file source{path};
+
+    auto id = bsoncxx::types::bson_value::view{bsoncxx::types::b_oid{}};
+    uploader upload_stream = _open_upload_stream_with_id(
+        session, id, filename, options, static_cast<std::int64_t>(source.size()));
+
+    // Slices are a whole number of chunks, so the uploader builds every chunk but the last straight
+    // from the mapping.
+    const auto chunk_size = static_cast<std::size_t>(upload_stream.chunk_size());
+    const std::size_t slice_size =
+        std::max(chunk_size, k_upload_slice_bytes / chunk_size * chunk_size);
+    const auto& progress = options.progress();
+
+    for (std::size_t offset = 0; offset < source.size();) {
+        const std::size_t length = std::min(slice_size, source.size() - offset);
+        upload_stream.write(source.data() + offset, length);
+        offset += length;
+
+        if (progress) {
+            progress(static_cast<std::int64_t>(offset), static_cast<std::int64_t>(source.size()));
+        }
+    }
+
+    return upload_stream.close();
+}
+
+result::gridfs::upload bucket::upload_from_file(stdx::string_view filename,
+                                                const std::string& path,
+                                                const options::gridfs::upload& options) {
+    return _upload_from_file(nullptr, filename, path, options);
+}
+
+result::gridfs::upload bucket::upload_from_file(const client_session& session,
+                                                stdx::string_view filename,
+                                                const std::string& path,
+                                                const options::gridfs::upload& options) {
+    return _upload_from_file(&session, filename, path, options);
+}
+
+result::gridfs::upload bucket::_upload_from_stream_with_id(
+    const client_session* session,
+    bsoncxx::types::bson_value::view id,
+    stdx::string_view filename,
+    std::istream* source,
+    const options::gridfs::upload& options) {
+    // Measuring the stream only pays off when the chunk size may depend on its length.
+    stdx::optional<std::int64_t> known_length;
+    if (_get_impl().adaptive_chunk_size && !options.chunk_size_bytes()) {
+        known_length = remaining_length(source);
+    }
+
+    uploader upload_stream =
+        _open_upload_stream_with_id(session, id, filename, options, known_length);
     std::int32_t chunk_size = upload_stream.chunk_size();
     std::unique_ptr<std::uint8_t[]> buffer =
         stdx::make_unique<std::uint8_t[]>(static_cast<std::size_t>(chunk_size));
@@ -197,14 +574,14 @@ void bucket::_upload_from_stream_with_id(const client_session* session,
         MONGOCXX_UNREACHABLE;
     }
 
-    upload_stream.close();
+    return upload_stream.close();
 }
 
 void bucket::upload_from_stream_with_id(bsoncxx::types::bson_value::view id,
                                         stdx::string_view filename,
                                         std::istream* source,
                                         const options::gridfs::upload& options) {
-    return _upload_from_stream_with_id(nullptr, id, filename, source, options);
+    _upload_from_stream_with_id(nullptr, id, filename, source, options);
 }
 
 void bucket::upload_from_stream_with_id(const client_session& session,
@@ -212,13 +589,101 @@ void bucket::upload_from_stream_with_id(const client_session& session,
                                         stdx::string_view filename,
                                         std::istream* source,
                                         const options::gridfs::upload& options) {
-    return _upload_from_stream_with_id(&session, id, filename, source, options);
+    _upload_from_stream_with_id(&session, id, filename, source, options);
+}
+
+std::vector<result::gridfs::upload> bucket::_upload_many(const client_session* session,
+                                                         const std::vector<upload_source>& sources,
+                                                         const options::gridfs::upload& options) {
+    upload_batch batch{session, _get_impl().chunks, _get_impl().files};
+    std::vector<result::gridfs::upload> results;
+    results.reserve(sources.size());
+
+    std::int64_t total_length = 0;
+    for (const auto& source : sources) {
+        total_length += static_cast<std::int64_t>(source.length);
+    }
+
+    const auto& progress = options.progress();
+    std::int64_t uploaded = 0;
+
+    for (const auto& source : sources) {
+        options::gridfs::upload file_options = options;
+        file_options.on_progress({});
+        if (source.metadata) {
+            file_options.metadata(*source.metadata);
+        }
+
+        auto id = source.id.value_or(bsoncxx::types::bson_value::view{bsoncxx::types::b_oid{}});
+        uploader upload_stream = _open_upload_stream_with_id(
+            session, id, source.filename, file_options, static_cast<std::int64_t>(source.length));
+
+        // The chunks and the files document are inserted with those of the other files.
+        upload_stream._get_impl().batch = &batch;
+        upload_stream._get_impl().flush_pool = nullptr;
+
+        upload_stream.write(source.data, source.length);
+        results.push_back(upload_stream.close());
+
+        uploaded += static_cast<std::int64_t>(source.length);
+        if (progress) {
+            progress(uploaded, total_length);
+        }
+    }
+
+    batch.flush();
+
+    return results;
+}
+
+std::vector<result::gridfs::upload> bucket::upload_many(const std::vector<upload_source>& sources,
+                                                        const options::gridfs::upload& options) {
+    return _upload_many(nullptr, sources, options);
+}
+
+std::vector<result::gridfs::upload> bucket::upload_many(const client_session& session,
+                                                        const std::vector<upload_source>& sources,
+                                                        const options::gridfs::upload& options) {
+    return _upload_many(&session, sources, options);
 }
 
 downloader bucket::_open_download_stream(const client_session* session,
-                                         bsoncxx::types::bson_value::view id) {
+                                         bsoncxx::types::bson_value::view id,
+                                         const options::gridfs::download& options) {
     using namespace bsoncxx;
 
+    if (options.workers() && *options.workers() <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for options::gridfs::download::workers()"};
+    }
+
+    if (options.window_chunks() && *options.window_chunks() <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::gridfs::download::window_chunks()"};
+    }
+
+    if (options.cached_chunks() && *options.cached_chunks() < 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "non-negative value required for options::gridfs::download::cached_chunks()"};
+    }
+
+    if (options.fetch_pool() && session) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "options::gridfs::download::fetch_pool() cannot be used with a client session"};
+    }
+
+    // A file validated recently enough is served from the cache without querying the server.
+    std::string cache_key;
+    if (_get_impl().cache) {
+        cache_key = file_cache::key(id);
+        if (auto file = _get_impl().cache->find_fresh(cache_key)) {
+            return downloader{std::move(file), options};
+        }
+    }
+
     builder::basic::document files_filter;
     files_filter.append(builder::basic::kvp("_id", id));
 
@@ -245,71 +710,201 @@ downloader bucket::_open_download_stream(const client_session* session,
         return downloader{stdx::nullopt, *files_doc};
     }
 
-    builder::basic::document chunks_filter;
-    chunks_filter.append(builder::basic::kvp("files_id", id));
+    // The chunks of a deduplicated file are read from the blobs collection.
+    const auto& chunks = files_doc_view["manifest"] ? _get_impl().blobs : _get_impl().chunks;
 
-    builder::basic::document chunks_sort;
-    chunks_sort.append(builder::basic::kvp("n", 1));
+    if (_get_impl().cache &&
+        _get_impl().cache->admits(length.type() == type::k_int64 ? length.get_int64().value
+                                                                 : length.get_int32().value)) {
+        auto file = _get_impl().cache->find_valid(cache_key, files_doc_view);
 
-    options::find chunks_options;
-    chunks_options.sort(chunks_sort.extract());
+        // A file which is not cached yet is read whole before the download starts.
+        if (!file) {
+            downloader source{*files_doc, session, _get_impl().database_name, chunks, options};
+            file = _get_impl().cache->insert(cache_key, *files_doc, source.read_all_chunks());
+        }
 
-    auto cursor = session
-                      ? _get_impl().chunks.find(*session, chunks_filter.extract(), chunks_options)
-                      : _get_impl().chunks.find(chunks_filter.extract(), chunks_options);
+        return downloader{std::move(file), options};
+    }
 
-    return downloader{std::move(cursor), *files_doc};
+    return downloader{*files_doc, session, _get_impl().database_name, chunks, options};
 }
 
-downloader bucket::open_download_stream(bsoncxx::types::bson_value::view id) {
-    return _open_download_stream(nullptr, id);
+downloader bucket::open_download_stream(bsoncxx::types::bson_value::view id,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(nullptr, id, options);
 }
 
 downloader bucket::open_download_stream(const client_session& session,
-                                        bsoncxx::types::bson_value::view id) {
-    return _open_download_stream(&session, id);
+                                        bsoncxx::types::bson_value::view id,
+                                        const options::gridfs::download& options) {
+    return _open_download_stream(&session, id, options);
 }
 
 void bucket::_download_to_stream(const client_session* session,
                                  bsoncxx::types::bson_value::view id,
-                                 std::ostream* destination) {
-    downloader download_stream = _open_download_stream(session, id);
-    std::int32_t chunk_size = download_stream.chunk_size();
-    std::unique_ptr<std::uint8_t[]> buffer =
-        stdx::make_unique<std::uint8_t[]>(static_cast<std::size_t>(chunk_size));
-    std::size_t bytes_read;
-
-    while ((bytes_read =
-                download_stream.read(buffer.get(), static_cast<std::size_t>(chunk_size))) != 0) {
-        destination->write(reinterpret_cast<char*>(buffer.get()),
-                           static_cast<std::streamsize>(bytes_read));
+                                 std::ostream* destination,
+                                 const options::gridfs::download& options) {
+    downloader download_stream = _open_download_stream(session, id, options);
+
+    // Each chunk is written straight from the chunk document rather than copied into a buffer.
+    for (auto bytes = download_stream.next_chunk(); bytes.size;
+         bytes = download_stream.next_chunk()) {
+        destination->write(reinterpret_cast<const char*>(bytes.data),
+                           static_cast<std::streamsize>(bytes.size));
     }
 
     download_stream.close();
 }
 
-void bucket::download_to_stream(bsoncxx::types::bson_value::view id, std::ostream* destination) {
-    _download_to_stream(nullptr, id, destination);
+void bucket::download_to_stream(bsoncxx::types::bson_value::view id,
+                                std::ostream* destination,
+                                const options::gridfs::download& options) {
+    _download_to_stream(nullptr, id, destination, options);
 }
 
 void bucket::download_to_stream(const client_session& session,
                                 bsoncxx::types::bson_value::view id,
-                                std::ostream* destination) {
-    _download_to_stream(&session, id, destination);
+                                std::ostream* destination,
+                                const options::gridfs::download& options) {
+    _download_to_stream(&session, id, destination, options);
+}
+
+void bucket::_download_to_fd(const client_session* session,
+                             bsoncxx::types::bson_value::view id,
+                             int fd,
+                             const options::gridfs::download& options) {
+    downloader download_stream = _open_download_stream(session, id, options);
+    download_stream.write_to_fd(fd, false, options.progress());
+    download_stream.close();
+}
+
+void bucket::download_to_fd(bsoncxx::types::bson_value::view id,
+                            int fd,
+                            const options::gridfs::download& options) {
+    _download_to_fd(nullptr, id, fd, options);
+}
+
+void bucket::download_to_fd(const client_session& session,
+                            bsoncxx::types::bson_value::view id,
+                            int fd,
+                            const options::gridfs::download& options) {
+    _download_to_fd(&session, id, fd, options);
+}
+
+void bucket::_download_to_file(const client_session* session,
+                               bsoncxx::types::bson_value::view id,
+                               const std::string& path,
+                               const options::gridfs::download& options) {
+    downloader download_stream = _open_download_stream(session, id, options);
+
+    const int fd = open_for_writing(path);
+
+    try {
+        preallocate(fd, download_stream.file_length(), path);
+        download_stream.write_to_fd(fd, true, options.progress());
+        download_stream.close();
+    } catch (...) {
+        close_fd(fd);
+        std::remove(path.c_str());
+        throw;
+    }
+
+    if (close_fd(fd) != 0) {
+        const int error = errno;
+        std::remove(path.c_str());
+        throw std::system_error{error, std::generic_category(), "cannot close " + path};
+    }
+}
+
+void bucket::download_to_file(bsoncxx::types::bson_value::view id,
+                              const std::string& path,
+                              const options::gridfs::download& options) {
+    _download_to_file(nullptr, id, path, options);
+}
+
+void bucket::download_to_file(const client_session& session,
+                              bsoncxx::types::bson_value::view id,
+                              const std::string& path,
+                              const options::gridfs::download& options) {
+    _download_to_file(&session, id, path, options);
 }
 
 void bucket::_delete_file(const client_session* session, bsoncxx::types::bson_value::view id) {
     using namespace bsoncxx;
 
+    const bool acknowledged = _get_impl().files.write_concern().is_acknowledged();
+
+    // Files without a manifest are deleted as GridFS specifies. A bucket without deduplication
+    // expects none, so it restricts the delete to them and only looks for a manifest when nothing
+    // was deleted.
+    if (!_get_impl().deduplicate) {
+        builder::basic::document files_builder;
+        files_builder.append(builder::basic::kvp("_id", id));
+        files_builder.append(builder::basic::kvp(
+            "manifest", builder::basic::make_document(builder::basic::kvp("$exists", false))));
+
+        auto result = session ? _get_impl().files.delete_one(*session, files_builder.extract())
+                              : _get_impl().files.delete_one(files_builder.extract());
+        if (result && result->deleted_count() == 1) {
+            _delete_chunks(session, id);
+            return;
+        }
+    }
+
+    // The manifest of a deduplicated file lists the chunks whose references it holds. Any bucket
+    // can read deduplicated files, so whether to release them depends on the file rather than on
+    // the bucket's options.
     builder::basic::document files_builder;
     files_builder.append(builder::basic::kvp("_id", id));
 
-    auto result = session ? _get_impl().files.delete_one(*session, files_builder.extract())
-                          : _get_impl().files.delete_one(files_builder.extract());
-    if (result) {
-        if (result->deleted_count() == 0) {
+    options::find_one_and_delete find_options;
+    find_options.projection(builder::basic::make_document(builder::basic::kvp("manifest", 1)));
+
+    auto files_doc =
+        session ? _get_impl().files.find_one_and_delete(
+                      *session, files_builder.extract(), find_options)
+                : _get_impl().files.find_one_and_delete(files_builder.extract(), find_options);
+
+    // An unacknowledged delete returns no document, whether or not the file existed.
+    if (!files_doc) {
+        if (acknowledged) {
             throw gridfs_exception{error_code::k_gridfs_file_not_found};
         }
+
+        _delete_chunks(session, id);
+        return;
+    }
+
+    auto manifest = files_doc->view()["manifest"];
+    if (!manifest) {
+        _delete_chunks(session, id);
+        return;
+    }
+
+    if (manifest.type() != type::k_binary ||
+        manifest.get_binary().size % dedup::k_entry_size != 0) {
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                               "expected the manifest in the files document to be a "
+                               "binary value listing whole entries"};
+    }
+
+    if (_get_impl().cache) {
+        _get_impl().cache->erase(file_cache::key(id));
+    }
+
+    // A deduplicated file has no documents in the chunks collection.
+    dedup::release_blobs(_get_impl().blobs,
+                         session,
+                         manifest.get_binary().bytes,
+                         manifest.get_binary().size / dedup::k_entry_size);
+}
+
+void bucket::_delete_chunks(const client_session* session, bsoncxx::types::bson_value::view id) {
+    using namespace bsoncxx;
+
+    if (_get_impl().cache) {
+        _get_impl().cache->erase(file_cache::key(id));
     }
 
     builder::basic::document chunks_builder;
@@ -356,11 +951,14 @@ void bucket::create_indexes_if_nonexistent(const client_session* session) {
     auto find_options =
         options::find{}.projection(filter.view()).read_preference(read_preference{});
 
+    // A bucket which already holds files is left as it is, and need not be checked again.
     if (session) {
         if (_get_impl().files.find_one(*session, {}, find_options)) {
+            _get_impl().indexes_created = true;
             return;
         }
     } else if (_get_impl().files.find_one({}, find_options)) {
+        _get_impl().indexes_created = true;
         return;
     }
 
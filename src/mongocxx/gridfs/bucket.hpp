@@ -16,10 +16,15 @@
 
 #include <mongocxx/config/prelude.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <istream>
 #include <memory>
 #include <ostream>
+#include <string>
+#include <vector>
 
+#include <bsoncxx/document/view.hpp>
 #include <bsoncxx/document/view_or_value.hpp>
 #include <bsoncxx/stdx/string_view.hpp>
 #include <bsoncxx/types/bson_value/view.hpp>
@@ -28,6 +33,7 @@
 #include <mongocxx/gridfs/uploader.hpp>
 #include <mongocxx/options/find.hpp>
 #include <mongocxx/options/gridfs/bucket.hpp>
+#include <mongocxx/options/gridfs/download.hpp>
 #include <mongocxx/options/gridfs/upload.hpp>
 #include <mongocxx/result/gridfs/upload.hpp>
 #include <mongocxx/stdx.hpp>
@@ -61,6 +67,24 @@ namespace gridfs {
 ///
 class MONGOCXX_API bucket {
    public:
+    ///
+    /// A file to upload with bucket::upload_many(), whose bytes are held by the caller.
+    ///
+    struct upload_source {
+        /// The name of the file.
+        stdx::string_view filename;
+
+        /// The bytes of the file, which must remain valid until bucket::upload_many() returns.
+        const std::uint8_t* data;
+        std::size_t length;
+
+        /// The id of the file, or a disengaged optional to generate an ObjectId.
+        stdx::optional<bsoncxx::types::bson_value::view> id;
+
+        /// Metadata for the file, which takes precedence over options::gridfs::upload::metadata().
+        stdx::optional<bsoncxx::document::view> metadata;
+    };
+
     ///
     /// Default constructs a bucket object. The bucket is equivalent to the state of a moved from
     /// bucket. The only valid actions to take with a default constructed bucket are to assign to
@@ -333,6 +357,200 @@ class MONGOCXX_API bucket {
     /// @}
     ///
 
+    ///
+    /// @{
+    ///
+    /// Creates a new GridFS file by uploading the contents of a file on the local filesystem. The
+    /// file is mapped into memory and each chunk is built straight from the mapping, without
+    /// reading it through an intermediate buffer. The id of the file will be automatically
+    /// generated as an ObjectId.
+    ///
+    /// @param filename
+    ///   The name of the file to be uploaded. A bucket can contain multiple files with the same
+    ///   name.
+    ///
+    /// @param path
+    ///   The path of the local file to upload.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::upload. The progress callback, if set, is
+    ///   called after each slice of the file has been handed to the uploader.
+    ///
+    /// @return
+    ///   The id of the uploaded file.
+    ///
+    /// @note
+    ///   If this GridFS bucket does not already exist in the database, it will be implicitly
+    ///   created and initialized with GridFS indexes.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::bulk_write_exception
+    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///
+    /// @throws std::system_error if the local file cannot be opened or mapped.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the uploader requires more than 2^31-1 chunks to store the file at the requested chunk
+    ///   size.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    /// @throws mongocxx::operation_exception if an error occurs when building GridFS indexes.
+    ///
+    result::gridfs::upload upload_from_file(stdx::string_view filename,
+                                            const std::string& path,
+                                            const options::gridfs::upload& options = {});
+
+    ///
+    /// Creates a new GridFS file by uploading the contents of a file on the local filesystem. The
+    /// file is mapped into memory and each chunk is built straight from the mapping, without
+    /// reading it through an intermediate buffer. The id of the file will be automatically
+    /// generated as an ObjectId.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the upload.
+    ///
+    /// @param filename
+    ///   The name of the file to be uploaded. A bucket can contain multiple files with the same
+    ///   name.
+    ///
+    /// @param path
+    ///   The path of the local file to upload.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::upload. The progress callback, if set, is
+    ///   called after each slice of the file has been handed to the uploader.
+    ///
+    /// @return
+    ///   The id of the uploaded file.
+    ///
+    /// @note
+    ///   If this GridFS bucket does not already exist in the database, it will be implicitly
+    ///   created and initialized with GridFS indexes.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::bulk_write_exception
+    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///
+    /// @throws std::system_error if the local file cannot be opened or mapped.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the uploader requires more than 2^31-1 chunks to store the file at the requested chunk
+    ///   size.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    /// @throws mongocxx::operation_exception if an error occurs when building GridFS indexes.
+    ///
+    result::gridfs::upload upload_from_file(const client_session& session,
+                                            stdx::string_view filename,
+                                            const std::string& path,
+                                            const options::gridfs::upload& options = {});
+    ///
+    /// @}
+    ///
+
+    ///
+    /// @{
+    ///
+    /// Creates new GridFS files from buffers in memory, inserting the chunks and files documents
+    /// of many files with few calls to the server. Files documents and chunks are gathered in
+    /// batches of about 16 MB, and the chunks of a batch are inserted before its files documents,
+    /// so that a files document is never visible before its chunks. This suits many small files,
+    /// each of which would otherwise take at least two round trips.
+    ///
+    /// @param sources
+    ///   The files to upload.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::upload. They apply to every file. The progress
+    ///   callback, if set, is called after each file has been handed to its uploader, with the
+    ///   number of bytes handed over so far and the total length of the files. The flush pool, if
+    ///   set, is not used.
+    ///
+    /// @return
+    ///   The ids of the uploaded files, in the order of `sources`.
+    ///
+    /// @note
+    ///   If this GridFS bucket does not already exist in the database, it will be implicitly
+    ///   created and initialized with GridFS indexes.
+    ///
+    /// @note
+    ///   If an error occurs, the files of the batches already inserted remain in the bucket, and
+    ///   chunks of the failed batch may remain without a files document.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::bulk_write_exception
+    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the uploader requires more than 2^31-1 chunks to store a file at the requested chunk
+    ///   size.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    /// @throws mongocxx::operation_exception if an error occurs when building GridFS indexes.
+    ///
+    std::vector<result::gridfs::upload> upload_many(const std::vector<upload_source>& sources,
+                                                    const options::gridfs::upload& options = {});
+
+    ///
+    /// Creates new GridFS files from buffers in memory, inserting the chunks and files documents
+    /// of many files with few calls to the server. Files documents and chunks are gathered in
+    /// batches of about 16 MB, and the chunks of a batch are inserted before its files documents,
+    /// so that a files document is never visible before its chunks. This suits many small files,
+    /// each of which would otherwise take at least two round trips.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the upload.
+    ///
+    /// @param sources
+    ///   The files to upload.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::upload. They apply to every file. The progress
+    ///   callback, if set, is called after each file has been handed to its uploader, with the
+    ///   number of bytes handed over so far and the total length of the files. The flush pool, if
+    ///   set, is not used.
+    ///
+    /// @return
+    ///   The ids of the uploaded files, in the order of `sources`.
+    ///
+    /// @note
+    ///   If this GridFS bucket does not already exist in the database, it will be implicitly
+    ///   created and initialized with GridFS indexes.
+    ///
+    /// @note
+    ///   If an error occurs, the files of the batches already inserted remain in the bucket, and
+    ///   chunks of the failed batch may remain without a files document.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::bulk_write_exception
+    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the uploader requires more than 2^31-1 chunks to store a file at the requested chunk
+    ///   size.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files collection for this bucket.
+    ///
+    /// @throws mongocxx::operation_exception if an error occurs when building GridFS indexes.
+    ///
+    std::vector<result::gridfs::upload> upload_many(const client_session& session,
+                                                    const std::vector<upload_source>& sources,
+                                                    const options::gridfs::upload& options = {});
+    ///
+    /// @}
+    ///
+
     ///
     /// @{
     ///
@@ -440,16 +658,22 @@ class MONGOCXX_API bucket {
     /// @param id
     ///   The id of the file to read.
     ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
     /// @return
     ///   The gridfs::downloader from which the GridFS file should be read.
     ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
     /// @throws mongocxx::query_exception
     ///   if an error occurs when reading from the files collection for this bucket.
     ///
-    downloader open_download_stream(bsoncxx::types::bson_value::view id);
+    downloader open_download_stream(bsoncxx::types::bson_value::view id,
+                                    const options::gridfs::download& options = {});
 
     ///
     /// Opens a gridfs::downloader to read a GridFS file.
@@ -461,9 +685,14 @@ class MONGOCXX_API bucket {
     /// @param id
     ///   The id of the file to read.
     ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download. A fetch pool may not be set.
+    ///
     /// @return
     ///   The gridfs::downloader from which the GridFS file should be read.
     ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
@@ -471,7 +700,8 @@ class MONGOCXX_API bucket {
     ///   if an error occurs when reading from the files collection for this bucket.
     ///
     downloader open_download_stream(const client_session& session,
-                                    bsoncxx::types::bson_value::view id);
+                                    bsoncxx::types::bson_value::view id,
+                                    const options::gridfs::download& options = {});
     ///
     /// @}
     ///
@@ -487,6 +717,11 @@ class MONGOCXX_API bucket {
     /// @param destination
     ///   The non-null stream to which the GridFS file should be written.
     ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
@@ -498,7 +733,9 @@ class MONGOCXX_API bucket {
     ///   `badbit`, any exception thrown during execution of `destination::write()` will be
     ///   re-thrown.
     ///
-    void download_to_stream(bsoncxx::types::bson_value::view id, std::ostream* destination);
+    void download_to_stream(bsoncxx::types::bson_value::view id,
+                            std::ostream* destination,
+                            const options::gridfs::download& options = {});
 
     ///
     /// Downloads the contents of a stored GridFS file from the bucket and writes it to a stream.
@@ -512,6 +749,11 @@ class MONGOCXX_API bucket {
     /// @param destination
     ///   The non-null stream to which the GridFS file should be written.
     ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
     /// @throws mongocxx::gridfs_exception
     ///   if the requested file does not exist, or if the requested file has been corrupted.
     ///
@@ -525,7 +767,144 @@ class MONGOCXX_API bucket {
     ///
     void download_to_stream(const client_session& session,
                             bsoncxx::types::bson_value::view id,
-                            std::ostream* destination);
+                            std::ostream* destination,
+                            const options::gridfs::download& options = {});
+    ///
+    /// @}
+    ///
+
+    ///
+    /// @{
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket and writes it to a file
+    /// descriptor. Each chunk is written straight from the chunk document received from the
+    /// server, without intermediate copies.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param fd
+    ///   The file descriptor, open for writing, to which the GridFS file should be written, for
+    ///   example a file or a socket. Writes start at its current position.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files or chunks collections for this bucket.
+    ///
+    /// @throws std::system_error if writing to `fd` fails.
+    ///
+    void download_to_fd(bsoncxx::types::bson_value::view id,
+                        int fd,
+                        const options::gridfs::download& options = {});
+
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket and writes it to a file
+    /// descriptor. Each chunk is written straight from the chunk document received from the
+    /// server, without intermediate copies.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the download.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param fd
+    ///   The file descriptor, open for writing, to which the GridFS file should be written, for
+    ///   example a file or a socket. Writes start at its current position.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files or chunks collections for this bucket.
+    ///
+    /// @throws std::system_error if writing to `fd` fails.
+    ///
+    void download_to_fd(const client_session& session,
+                        bsoncxx::types::bson_value::view id,
+                        int fd,
+                        const options::gridfs::download& options = {});
+    ///
+    /// @}
+    ///
+
+    ///
+    /// @{
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket and writes it to a file on
+    /// the local filesystem. The file is created, or truncated if it exists, and allocated to the
+    /// length of the GridFS file up front. Each chunk is then written at its offset, straight from
+    /// the chunk document received from the server; when a fetch pool is set, windows of chunks
+    /// are written in the order in which their queries complete rather than in file order.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param path
+    ///   The path of the local file to write. It is removed if the download fails.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files or chunks collections for this bucket.
+    ///
+    /// @throws std::system_error if the local file cannot be created or written.
+    ///
+    void download_to_file(bsoncxx::types::bson_value::view id,
+                          const std::string& path,
+                          const options::gridfs::download& options = {});
+
+    ///
+    /// Downloads the contents of a stored GridFS file from the bucket and writes it to a file on
+    /// the local filesystem. The file is created, or truncated if it exists, and allocated to the
+    /// length of the GridFS file up front. Each chunk is then written at its offset, straight from
+    /// the chunk document received from the server; when a fetch pool is set, windows of chunks
+    /// are written in the order in which their queries complete rather than in file order.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the download.
+    ///
+    /// @param id
+    ///   The id of the file to read.
+    ///
+    /// @param path
+    ///   The path of the local file to write. It is removed if the download fails.
+    ///
+    /// @param options
+    ///   Optional arguments; see options::gridfs::download.
+    ///
+    /// @throws mongocxx::logic_error if `options` are invalid.
+    ///
+    /// @throws mongocxx::gridfs_exception
+    ///   if the requested file does not exist, or if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading from the files or chunks collections for this bucket.
+    ///
+    /// @throws std::system_error if the local file cannot be created or written.
+    ///
+    void download_to_file(const client_session& session,
+                          bsoncxx::types::bson_value::view id,
+                          const std::string& path,
+                          const options::gridfs::download& options = {});
     ///
     /// @}
     ///
@@ -631,27 +1010,57 @@ class MONGOCXX_API bucket {
 
     MONGOCXX_PRIVATE void create_indexes_if_nonexistent(const client_session* session);
 
-    MONGOCXX_PRIVATE uploader _open_upload_stream_with_id(const client_session* session,
-                                                          bsoncxx::types::bson_value::view id,
-                                                          stdx::string_view filename,
-                                                          const options::gridfs::upload& options);
+    // The length of the file, when known, lets the bucket pick a larger chunk size for it.
+    MONGOCXX_PRIVATE uploader _open_upload_stream_with_id(
+        const client_session* session,
+        bsoncxx::types::bson_value::view id,
+        stdx::string_view filename,
+        const options::gridfs::upload& options,
+        stdx::optional<std::int64_t> known_length = {});
 
-    MONGOCXX_PRIVATE void _upload_from_stream_with_id(const client_session* session,
-                                                      bsoncxx::types::bson_value::view id,
-                                                      stdx::string_view filename,
-                                                      std::istream* source,
-                                                      const options::gridfs::upload& options);
+    MONGOCXX_PRIVATE result::gridfs::upload _upload_from_stream_with_id(
+        const client_session* session,
+        bsoncxx::types::bson_value::view id,
+        stdx::string_view filename,
+        std::istream* source,
+        const options::gridfs::upload& options);
+
+    MONGOCXX_PRIVATE result::gridfs::upload _upload_from_file(
+        const client_session* session,
+        stdx::string_view filename,
+        const std::string& path,
+        const options::gridfs::upload& options);
+
+    MONGOCXX_PRIVATE std::vector<result::gridfs::upload> _upload_many(
+        const client_session* session,
+        const std::vector<upload_source>& sources,
+        const options::gridfs::upload& options);
 
     MONGOCXX_PRIVATE downloader _open_download_stream(const client_session* session,
-                                                      bsoncxx::types::bson_value::view id);
+                                                      bsoncxx::types::bson_value::view id,
+                                                      const options::gridfs::download& options);
 
     MONGOCXX_PRIVATE void _download_to_stream(const client_session* session,
                                               bsoncxx::types::bson_value::view id,
-                                              std::ostream* destination);
+                                              std::ostream* destination,
+                                              const options::gridfs::download& options);
+
+    MONGOCXX_PRIVATE void _download_to_fd(const client_session* session,
+                                          bsoncxx::types::bson_value::view id,
+                                          int fd,
+                                          const options::gridfs::download& options);
+
+    MONGOCXX_PRIVATE void _download_to_file(const client_session* session,
+                                            bsoncxx::types::bson_value::view id,
+                                            const std::string& path,
+                                            const options::gridfs::download& options);
 
     MONGOCXX_PRIVATE void _delete_file(const client_session* session,
                                        bsoncxx::types::bson_value::view id);
 
+    MONGOCXX_PRIVATE void _delete_chunks(const client_session* session,
+                                         bsoncxx::types::bson_value::view id);
+
     class MONGOCXX_PRIVATE impl;
 
     MONGOCXX_PRIVATE impl& _get_impl();
@@ -15,23 +15,122 @@
 #include <mongocxx/config/private/prelude.hh>
 
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
 #include <cstring>
+#include <map>
 #include <sstream>
-
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
 #include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 #include <mongocxx/gridfs/downloader.hpp>
+#include <mongocxx/gridfs/private/codec.hh>
+#include <mongocxx/gridfs/private/dedup.hh>
 #include <mongocxx/gridfs/private/downloader.hh>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
+namespace {
+
+constexpr std::int32_t k_default_workers = 4;
+
+// Like the batches of chunks inserted by the uploader, a window holds about 16 MB of chunks by
+// default.
+constexpr std::int32_t k_default_window_bytes = 16 * 1000 * 1000;
+
+constexpr std::int32_t k_default_cached_chunks = 4;
+
+// Writes all of the bytes to a file descriptor, retrying partial and interrupted writes.
+void write_fully(int fd, const std::uint8_t* data, std::size_t size) {
+    while (size > 0) {
+#if defined(_WIN32)
+        const int written =
+            _write(fd, data, static_cast<unsigned int>(std::min<std::size_t>(size, INT_MAX)));
+#else
+        const auto written = ::write(fd, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{
+                errno, std::generic_category(), "cannot write GridFS file to file descriptor"};
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+}
+
+// Writes all of the bytes to a file descriptor at an offset.
+void write_fully_at(int fd, std::int64_t offset, const std::uint8_t* data, std::size_t size) {
+#if defined(_WIN32)
+    if (_lseeki64(fd, offset, SEEK_SET) < 0) {
+        throw std::system_error{errno, std::generic_category(), "cannot seek in file descriptor"};
+    }
+
+    write_fully(fd, data, size);
+#else
+    while (size > 0) {
+        const auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error{
+                errno, std::generic_category(), "cannot write GridFS file to file descriptor"};
+        }
+
+        data += written;
+        size -= static_cast<std::size_t>(written);
+        offset += written;
+    }
+#endif
+}
+
+}  // namespace
+
 downloader::downloader(stdx::optional<cursor> chunks, bsoncxx::document::value files_doc)
     : _impl{stdx::make_unique<impl>(std::move(chunks), std::move(files_doc))} {}
 
+downloader::downloader(bsoncxx::document::value files_doc,
+                       const client_session* session,
+                       stdx::string_view database_name,
+                       const collection& chunks,
+                       const options::gridfs::download& options)
+    : _impl{stdx::make_unique<impl>(stdx::nullopt, std::move(files_doc))} {
+    _impl->open(session, database_name, chunks, options);
+}
+
+downloader::downloader(std::shared_ptr<const cached_file> file,
+                       const options::gridfs::download& options)
+    : _impl{stdx::make_unique<impl>(stdx::nullopt,
+                                    bsoncxx::document::value{file->files_doc.view()})} {
+    _impl->cached = std::move(file);
+    _impl->prepare(options);
+}
+
 downloader::downloader() noexcept = default;
 downloader::downloader(downloader&&) noexcept = default;
 downloader& downloader::operator=(downloader&&) noexcept = default;
@@ -71,12 +170,146 @@ std::size_t downloader::read(std::uint8_t* buffer, std::size_t length_requested)
     return bytes_read;
 }
 
+downloader::bytes_view downloader::next_chunk() {
+    if (_get_impl().closed) {
+        throw logic_error{error_code::k_gridfs_stream_not_open};
+    }
+
+    if (_get_impl().chunk_buffer_offset == _get_impl().chunk_buffer_len) {
+        if (_get_impl().chunks_seen == _get_impl().file_chunk_count) {
+            return bytes_view{nullptr, 0};
+        }
+
+        fetch_chunk();
+    }
+
+    bytes_view bytes{&_get_impl().chunk_buffer_ptr[_get_impl().chunk_buffer_offset],
+                     _get_impl().chunk_buffer_len - _get_impl().chunk_buffer_offset};
+    _get_impl().chunk_buffer_offset = _get_impl().chunk_buffer_len;
+
+    return bytes;
+}
+
+void downloader::seek(std::int64_t offset) {
+    if (_get_impl().closed) {
+        throw logic_error{error_code::k_gridfs_stream_not_open};
+    }
+
+    if (offset < 0 || offset > _get_impl().file_len) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "offset passed to downloader::seek() is outside of the file"};
+    }
+
+    const auto chunk = _get_impl().chunk_at(offset);
+    const auto chunk_offset = static_cast<std::size_t>(offset - _get_impl().chunk_start(chunk));
+
+    // Seeking within the current chunk only moves the offset into it.
+    if (_get_impl().chunk_buffer_ptr && _get_impl().chunks_seen - 1 == chunk) {
+        _get_impl().chunk_buffer_offset = chunk_offset;
+        return;
+    }
+
+    _get_impl().cache_current_chunk();
+
+    _get_impl().chunk_buffer_ptr = nullptr;
+    _get_impl().chunk_buffer_len = 0;
+    _get_impl().chunk_buffer_offset = 0;
+    _get_impl().chunks_seen = chunk;
+
+    // The end of a file whose last chunk is full has no chunk to fetch.
+    if (chunk == _get_impl().file_chunk_count) {
+        return;
+    }
+
+    fetch_chunk();
+    _get_impl().chunk_buffer_offset = chunk_offset;
+}
+
+std::size_t downloader::read_at(std::int64_t offset, std::uint8_t* buffer, std::size_t length) {
+    seek(offset);
+    return read(buffer, length);
+}
+
+void downloader::write_to_fd(int fd,
+                             bool positioned,
+                             const std::function<void(std::int64_t, std::int64_t)>& progress) {
+    if (_get_impl().closed) {
+        throw logic_error{error_code::k_gridfs_stream_not_open};
+    }
+
+    std::int64_t bytes_written = 0;
+
+    // When writing at offsets, windows fetched concurrently are written as soon as they arrive
+    // rather than in order, so a slow query does not hold back the others. This requires the
+    // downloader not to have been read from yet, and not to be verifying a digest, which needs
+    // the chunks in order.
+    if (positioned && _get_impl().fetch_pool && _get_impl().chunks_seen == 0 &&
+        !_get_impl().digest) {
+        while (_get_impl().windows_taken != _get_impl().window_count) {
+            const std::int32_t index = _get_impl().take_window(true);
+            const std::int32_t first =
+                _get_impl().windows_first_chunk + index * _get_impl().window_chunks;
+            const std::int32_t count = std::min(_get_impl().window_chunks,
+                                                _get_impl().file_chunk_count - first);
+
+            if (_get_impl().window.size() != static_cast<std::size_t>(count)) {
+                std::ostringstream err;
+                err << "expected chunks #" << first << " to #" << first + count - 1
+                    << " to exist, but query to chunks collection returned "
+                    << _get_impl().window.size() << " chunk(s)";
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+            }
+
+            for (std::int32_t i = 0; i < count; ++i) {
+                const auto chunk_doc = _get_impl().window[static_cast<std::size_t>(i)].view();
+                const auto data = _get_impl().validate_chunk(chunk_doc, first + i);
+                write_fully_at(fd, _get_impl().chunk_start(first + i), data.bytes, data.size);
+                bytes_written += static_cast<std::int64_t>(data.size);
+            }
+
+            if (progress) {
+                progress(bytes_written, _get_impl().file_len);
+            }
+        }
+
+        _get_impl().window.clear();
+        _get_impl().chunks_seen = _get_impl().file_chunk_count;
+        return;
+    }
+
+    // The offset in the file of the next byte to be read.
+    std::int64_t offset = _get_impl().chunk_start(_get_impl().chunks_seen);
+    if (_get_impl().chunk_buffer_ptr) {
+        offset = _get_impl().chunk_start(_get_impl().chunks_seen - 1) +
+                 static_cast<std::int64_t>(_get_impl().chunk_buffer_offset);
+    }
+
+    for (auto bytes = next_chunk(); bytes.size; bytes = next_chunk()) {
+        if (positioned) {
+            write_fully_at(fd, offset, bytes.data, bytes.size);
+        } else {
+            write_fully(fd, bytes.data, bytes.size);
+        }
+
+        offset += static_cast<std::int64_t>(bytes.size);
+        bytes_written += static_cast<std::int64_t>(bytes.size);
+
+        if (progress) {
+            progress(bytes_written, _get_impl().file_len);
+        }
+    }
+}
+
 void downloader::close() {
     if (_get_impl().closed) {
         throw logic_error{error_code::k_gridfs_stream_not_open};
     }
 
+    _get_impl().stop_fetch();
+    _get_impl().fetched_windows.clear();
+    _get_impl().window.clear();
     _get_impl().chunks = {};
+    _get_impl().cached.reset();
     _get_impl().closed = true;
 }
 
@@ -93,7 +326,9 @@ bsoncxx::document::view downloader::files_document() const {
 }
 
 void downloader::fetch_chunk() {
-    if (_get_impl().chunks_curr == _get_impl().chunks_end) {
+    auto next_chunk_doc = _get_impl().next_chunk_document();
+
+    if (!next_chunk_doc) {
         std::ostringstream err;
         err << "expected file to have " << _get_impl().file_chunk_count
             << " chunk(s), but query to chunks collection only returned " << _get_impl().chunks_seen
@@ -101,65 +336,577 @@ void downloader::fetch_chunk() {
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
     }
 
-    if (_get_impl().chunks_seen) {
-        ++(*_get_impl().chunks_curr);
+    bsoncxx::document::view chunk_doc = *next_chunk_doc;
+
+    auto binary_data = _get_impl().validate_chunk(chunk_doc, _get_impl().chunks_seen);
+
+    if (_get_impl().digest) {
+        _get_impl().update_digest(_get_impl().chunks_seen, binary_data);
     }
 
-    bsoncxx::document::view chunk_doc = **_get_impl().chunks_curr;
+    ++_get_impl().chunks_seen;
+
+    _get_impl().chunk_doc = chunk_doc;
+    _get_impl().chunk_buffer_ptr = binary_data.bytes;
+    _get_impl().chunk_buffer_len = binary_data.size;
+    _get_impl().chunk_buffer_offset = 0;
+}
 
+std::vector<bsoncxx::document::value> downloader::read_all_chunks() {
+    std::vector<bsoncxx::document::value> chunks;
+    chunks.reserve(static_cast<std::size_t>(_get_impl().file_chunk_count));
+
+    while (_get_impl().chunks_seen != _get_impl().file_chunk_count) {
+        fetch_chunk();
+        chunks.emplace_back(_get_impl().chunk_doc);
+    }
+
+    return chunks;
+}
+
+bsoncxx::types::b_binary downloader::impl::validate_chunk(bsoncxx::document::view chunk_doc,
+                                                          std::int32_t n) const {
     auto chunk_n_ele = chunk_doc["n"];
     if (!chunk_n_ele || chunk_n_ele.type() != bsoncxx::type::k_int32 ||
-        chunk_n_ele.get_int32().value != _get_impl().chunks_seen) {
+        chunk_n_ele.get_int32().value != n) {
         std::ostringstream err;
-        err << "chunk #" << _get_impl().chunks_seen
-            << ": expected to find field \"n\" with k_int32 type";
+        err << "chunk #" << n << ": expected to find field \"n\" with k_int32 type";
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
     }
 
-    if (_get_impl().chunks_seen == std::numeric_limits<std::int32_t>::max()) {
+    if (n == std::numeric_limits<std::int32_t>::max()) {
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, "file has too many chunks"};
     }
 
     auto chunk_data_ele = chunk_doc["data"];
     if (!chunk_data_ele || chunk_data_ele.type() != bsoncxx::type::k_binary) {
         std::ostringstream err;
-        err << "chunk #" << _get_impl().chunks_seen
-            << ": expected to find field \"data\" with k_binary type";
+        err << "chunk #" << n << ": expected to find field \"data\" with k_binary type";
         throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
     }
 
     auto binary_data = chunk_data_ele.get_binary();
 
-    if (_get_impl().chunks_seen != _get_impl().file_chunk_count - 1) {
-        if (binary_data.size != static_cast<std::uint32_t>(_get_impl().chunk_size)) {
+    const auto expected_size = chunk_length(n);
+    if (binary_data.size != expected_size) {
+        std::ostringstream err;
+        err << "chunk #" << n << ": expected size of chunk to be " << expected_size
+            << " bytes, but actual size of chunk is " << binary_data.size << " bytes";
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+    }
+
+    return binary_data;
+}
+
+std::int64_t downloader::impl::chunk_start(std::int32_t n) const {
+    if (manifest) {
+        return chunk_offsets[static_cast<std::size_t>(n)];
+    }
+
+    return static_cast<std::int64_t>(n) * chunk_size;
+}
+
+std::size_t downloader::impl::chunk_length(std::int32_t n) const {
+    if (manifest) {
+        return dedup::entry_length(manifest + static_cast<std::size_t>(n) * dedup::k_entry_size);
+    }
+
+    return static_cast<std::size_t>(
+        std::min(static_cast<std::int64_t>(chunk_size), file_len - chunk_start(n)));
+}
+
+std::int32_t downloader::impl::chunk_at(std::int64_t offset) const {
+    if (manifest) {
+        const auto next =
+            std::upper_bound(chunk_offsets.begin(), chunk_offsets.end(), offset);
+        return static_cast<std::int32_t>(next - chunk_offsets.begin() - 1);
+    }
+
+    return static_cast<std::int32_t>(offset / chunk_size);
+}
+
+void downloader::impl::open(const client_session* session,
+                            stdx::string_view database_name,
+                            const collection& chunks,
+                            const options::gridfs::download& options) {
+    this->session = session;
+    chunks_collection = chunks;
+
+    if (options.fetch_pool()) {
+        fetch_pool = *options.fetch_pool();
+        fetch_database_name = bsoncxx::string::to_string(database_name);
+        fetch_collection_name = bsoncxx::string::to_string(chunks.name());
+        fetch_read_concern = chunks.read_concern();
+        fetch_read_preference = chunks.read_preference();
+
+        read_ahead = options.workers().value_or(k_default_workers);
+    }
+
+    prepare(options);
+    position_source(0);
+}
+
+void downloader::impl::prepare(const options::gridfs::download& options) {
+    // Every chunk of a cached file is already in memory.
+    max_cached_chunks =
+        cached ? 0
+               : static_cast<std::size_t>(options.cached_chunks().value_or(k_default_cached_chunks));
+
+    window_chunks = options.window_chunks().value_or(
+        std::max(std::int32_t{1}, k_default_window_bytes / chunk_size));
+
+    if (auto recorded = files_doc.view()["manifest"]) {
+        if (recorded.type() != bsoncxx::type::k_binary ||
+            recorded.get_binary().size % dedup::k_entry_size != 0) {
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                                   "expected the manifest in the files document to be a binary "
+                                   "value listing whole entries"};
+        }
+
+        manifest = recorded.get_binary().bytes;
+
+        // A manifest fits in a files document, so its number of entries fits in an int32.
+        const auto entries = recorded.get_binary().size / dedup::k_entry_size;
+
+        chunk_offsets.reserve(entries + 1);
+        chunk_offsets.push_back(0);
+        for (std::size_t i = 0; i < entries; ++i) {
+            const auto length = dedup::entry_length(manifest + i * dedup::k_entry_size);
+            if (length == 0 || length > dedup::k_max_chunk_size) {
+                std::ostringstream err;
+                err << "manifest lists chunk #" << i << " with unexpected size of " << length
+                    << " bytes";
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+            }
+
+            chunk_offsets.push_back(chunk_offsets.back() + length);
+        }
+
+        if (chunk_offsets.back() != file_len) {
             std::ostringstream err;
-            err << "chunk #" << _get_impl().chunks_seen << ": expected size of chunk to be "
-                << _get_impl().chunk_size << " bytes, but actual size of chunk is "
-                << binary_data.size << " bytes";
+            err << "manifest lists chunks totalling " << chunk_offsets.back()
+                << " bytes, but file length is " << file_len << " bytes";
             throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
         }
-    } else {
-        auto expected_size =
-            _get_impl().file_len % static_cast<std::int64_t>(_get_impl().chunk_size);
 
-        if (expected_size == 0) {
-            expected_size = static_cast<std::int64_t>(_get_impl().chunk_size);
+        file_chunk_count = static_cast<std::int32_t>(entries);
+    }
+
+    if (auto recorded = files_doc.view()["codec"]) {
+        if (recorded.type() != bsoncxx::type::k_utf8) {
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                                   "expected the codec in the files document to be a string"};
         }
 
-        if (binary_data.size != static_cast<std::uint32_t>(expected_size)) {
+        codec = codec::from_name(recorded.get_utf8().value);
+        if (!codec) {
             std::ostringstream err;
-            err << "chunk #" << _get_impl().chunks_seen << ": expected size of chunk to be "
-                << expected_size << " bytes, but actual size of chunk is " << binary_data.size
-                << " bytes";
+            err << "files document names unknown codec: " << recorded.get_utf8().value;
             throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
         }
+
+        if (!codec::supported(*codec)) {
+            throw gridfs_exception{error_code::k_gridfs_codec_not_supported};
+        }
     }
 
-    ++_get_impl().chunks_seen;
+    if (options.verify_digest().value_or(false)) {
+        if (auto algorithm = digest::find(files_doc.view())) {
+            const auto recorded = files_doc.view()[digest::field_name(*algorithm)];
+            if (recorded.type() != bsoncxx::type::k_utf8) {
+                throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                                       "expected the digest in the files document to be a string"};
+            }
 
-    _get_impl().chunk_buffer_ptr = binary_data.bytes;
-    _get_impl().chunk_buffer_len = binary_data.size;
-    _get_impl().chunk_buffer_offset = 0;
+            digest.emplace(*algorithm);
+            expected_digest = bsoncxx::string::to_string(recorded.get_utf8().value);
+        }
+    }
+}
+
+void downloader::impl::update_digest(std::int32_t n, const bsoncxx::types::b_binary& data) {
+    // Chunks fetched again after a seek back were already added.
+    if (n < digest_chunks) {
+        return;
+    }
+
+    // A seek skipped chunks, so the digest of the file cannot be computed.
+    if (n > digest_chunks) {
+        digest = stdx::nullopt;
+        return;
+    }
+
+    digest->update(data.bytes, data.size);
+    ++digest_chunks;
+
+    if (digest_chunks != file_chunk_count) {
+        return;
+    }
+
+    const auto actual = digest->finish();
+    digest = stdx::nullopt;
+
+    if (actual != expected_digest) {
+        std::ostringstream err;
+        err << "expected file to have digest " << expected_digest << ", but its chunks have digest "
+            << actual;
+        throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+    }
+}
+
+void downloader::impl::position_source(std::int32_t first) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    next_source_chunk = first;
+
+    if (fetch_pool) {
+        stop_fetch();
+
+        fetched_windows.clear();
+        window.clear();
+        window_offset = 0;
+
+        windows_first_chunk = first;
+        window_count = static_cast<std::int32_t>(
+            (static_cast<std::int64_t>(file_chunk_count) - first + window_chunks - 1) /
+            window_chunks);
+        windows_started = 0;
+        windows_taken = 0;
+        stopping = false;
+
+        const auto workers = std::min(read_ahead, window_count);
+        for (std::int32_t i = 0; i < workers; ++i) {
+            fetch_threads.emplace_back([this] { run_fetch(); });
+        }
+
+        return;
+    }
+
+    if (manifest) {
+        window.clear();
+        window_offset = 0;
+        return;
+    }
+
+    bsoncxx::builder::basic::document filter;
+    filter.append(kvp("files_id", files_doc.view()["_id"].get_value()));
+    if (first) {
+        filter.append(kvp("n", make_document(kvp("$gte", first))));
+    }
+
+    options::find find_options;
+    find_options.sort(make_document(kvp("n", 1)));
+
+    chunks = session ? chunks_collection->find(*session, filter.extract(), find_options)
+                     : chunks_collection->find(filter.extract(), find_options);
+    chunks_curr = chunks->begin();
+    chunks_end = chunks->end();
+    chunks_curr_unread = true;
+}
+
+void downloader::impl::cache_current_chunk() {
+    if (!chunk_buffer_ptr || !max_cached_chunks) {
+        return;
+    }
+
+    const std::int32_t n = chunks_seen - 1;
+
+    for (auto&& cached : cached_chunks) {
+        if (cached.first == n) {
+            return;
+        }
+    }
+
+    cached_chunks.emplace_front(n, bsoncxx::document::value{chunk_doc});
+
+    if (cached_chunks.size() > max_cached_chunks) {
+        cached_chunks.pop_back();
+    }
+}
+
+void downloader::impl::stop_fetch() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    window_taken.notify_all();
+
+    for (auto&& thread : fetch_threads) {
+        thread.join();
+    }
+
+    fetch_threads.clear();
+}
+
+void downloader::impl::run_fetch() {
+    // A client is only acquired once there is a window to fetch, and is kept for the next ones.
+    stdx::optional<pool::entry> fetch_client;
+
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        window_taken.wait(lock, [this] {
+            return stopping || windows_started == window_count ||
+                   windows_started - windows_taken < read_ahead;
+        });
+
+        if (stopping || windows_started == window_count) {
+            return;
+        }
+
+        const std::int32_t index = windows_started++;
+        lock.unlock();
+
+        fetched_window fetched;
+        try {
+            if (!fetch_client) {
+                fetch_client = fetch_pool->acquire();
+            }
+            fetched.chunks = fetch_window(**fetch_client, index);
+        } catch (...) {
+            fetched.error = std::current_exception();
+        }
+
+        lock.lock();
+        fetched_windows.emplace(index, std::move(fetched));
+        window_fetched.notify_all();
+    }
+}
+
+std::vector<bsoncxx::document::value> downloader::impl::fetch_window(client& client,
+                                                                     std::int32_t index) {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    const std::int32_t first = static_cast<std::int32_t>(
+        std::min(windows_first_chunk + static_cast<std::int64_t>(index) * window_chunks,
+                 static_cast<std::int64_t>(file_chunk_count)));
+    const std::int32_t last = static_cast<std::int32_t>(
+        std::min(static_cast<std::int64_t>(first) + window_chunks,
+                 static_cast<std::int64_t>(file_chunk_count)));
+
+    auto coll = client[fetch_database_name][fetch_collection_name];
+    coll.read_concern(fetch_read_concern);
+    coll.read_preference(fetch_read_preference);
+
+    if (manifest) {
+        return fetch_blobs(coll, nullptr, first, last);
+    }
+
+    options::find find_options;
+    find_options.sort(make_document(kvp("n", 1)));
+
+    // The chunks are validated by the reader as they are read, exactly as when they are read from a
+    // single cursor, so a missing or extra chunk surfaces as a sequence error.
+    std::vector<bsoncxx::document::value> chunks;
+    chunks.reserve(static_cast<std::size_t>(last - first));
+
+    // Compressed chunks are decompressed here, on the fetching thread.
+    for (auto&& chunk :
+         coll.find(make_document(kvp("files_id", files_doc.view()["_id"].get_value()),
+                                 kvp("n", make_document(kvp("$gte", first), kvp("$lt", last)))),
+                   find_options)) {
+        if (codec) {
+            chunks.push_back(decompress_chunk(chunk));
+        } else {
+            chunks.emplace_back(chunk);
+        }
+    }
+
+    return chunks;
+}
+
+std::int32_t downloader::impl::take_window(bool any_order) {
+    fetched_window fetched;
+    std::int32_t index;
+
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+
+        window_fetched.wait(lock, [&] {
+            return any_order ? !fetched_windows.empty() : fetched_windows.count(windows_taken) != 0;
+        });
+
+        auto it = any_order ? fetched_windows.begin() : fetched_windows.find(windows_taken);
+        index = it->first;
+        fetched = std::move(it->second);
+        fetched_windows.erase(it);
+        ++windows_taken;
+    }
+
+    window_taken.notify_all();
+
+    if (fetched.error) {
+        std::rethrow_exception(fetched.error);
+    }
+
+    window = std::move(fetched.chunks);
+    window_offset = 0;
+
+    return index;
+}
+
+bsoncxx::document::value downloader::impl::decompress_chunk(
+    bsoncxx::document::view chunk_doc) const {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    const auto n_ele = chunk_doc["n"];
+    const auto data_ele = chunk_doc["data"];
+    if (!n_ele || n_ele.type() != bsoncxx::type::k_int32 || n_ele.get_int32().value < 0 ||
+        n_ele.get_int32().value >= file_chunk_count || !data_ele ||
+        data_ele.type() != bsoncxx::type::k_binary) {
+        return bsoncxx::document::value{chunk_doc};
+    }
+
+    const std::int32_t n = n_ele.get_int32().value;
+    const auto compressed = data_ele.get_binary();
+    const auto length = chunk_length(n);
+
+    std::vector<std::uint8_t> data(length);
+    codec::decompress(*codec, compressed.bytes, compressed.size, data.data(), data.size());
+
+    bsoncxx::types::b_binary binary{
+        bsoncxx::binary_sub_type::k_binary, static_cast<std::uint32_t>(length), data.data()};
+
+    return make_document(kvp("n", n), kvp("data", binary));
+}
+
+std::vector<bsoncxx::document::value> downloader::impl::fetch_blobs(
+    collection& blobs,
+    const client_session* session,
+    std::int32_t first,
+    std::int32_t last) const {
+    using bsoncxx::builder::basic::kvp;
+    using bsoncxx::builder::basic::make_document;
+
+    const auto hash = [this](std::int32_t n) {
+        return manifest + static_cast<std::size_t>(n) * dedup::k_entry_size;
+    };
+
+    bsoncxx::builder::basic::array ids;
+    for (std::int32_t n = first; n < last; ++n) {
+        ids.append(dedup::hash_value(hash(n)));
+    }
+
+    const auto filter = make_document(kvp("_id", make_document(kvp("$in", ids.extract()))));
+
+    // A chunk which appears several times in the window is returned once.
+    std::map<std::string, bsoncxx::document::value> found;
+    for (auto&& blob : session ? blobs.find(*session, filter.view()) : blobs.find(filter.view())) {
+        const auto id = blob["_id"];
+        if (id && id.type() == bsoncxx::type::k_binary &&
+            id.get_binary().size == dedup::k_hash_size) {
+            found.emplace(std::string(reinterpret_cast<const char*>(id.get_binary().bytes),
+                                      dedup::k_hash_size),
+                          bsoncxx::document::value{blob});
+        }
+    }
+
+    std::vector<bsoncxx::document::value> chunks;
+    chunks.reserve(static_cast<std::size_t>(last - first));
+
+    for (std::int32_t n = first; n < last; ++n) {
+        const auto it =
+            found.find(std::string(reinterpret_cast<const char*>(hash(n)), dedup::k_hash_size));
+        if (it == found.end()) {
+            std::ostringstream err;
+            err << "chunk #" << n << ": expected to find chunk in blobs collection";
+            throw gridfs_exception{error_code::k_gridfs_file_corrupted, err.str()};
+        }
+
+        // The chunk document is validated by the reader like any other.
+        bsoncxx::builder::basic::document chunk;
+        chunk.append(kvp("n", n));
+        if (const auto data = it->second.view()["data"]) {
+            chunk.append(kvp("data", data.get_value()));
+        }
+
+        if (codec) {
+            chunks.push_back(decompress_chunk(chunk.view()));
+        } else {
+            chunks.push_back(chunk.extract());
+        }
+    }
+
+    return chunks;
+}
+
+stdx::optional<bsoncxx::document::view> downloader::impl::next_chunk_document() {
+    // A cached file holds every chunk, already validated and decompressed.
+    if (cached) {
+        if (chunks_seen == file_chunk_count) {
+            return stdx::nullopt;
+        }
+
+        next_source_chunk = chunks_seen + 1;
+        return cached->chunks[static_cast<std::size_t>(chunks_seen)].view();
+    }
+    // Chunks read before a seek are kept in most recently used order.
+    for (auto it = cached_chunks.begin(); it != cached_chunks.end(); ++it) {
+        if (it->first == chunks_seen) {
+            if (it != cached_chunks.begin()) {
+                auto cached = std::move(*it);
+                cached_chunks.erase(it);
+                cached_chunks.push_front(std::move(cached));
+            }
+            return cached_chunks.front().second.view();
+        }
+    }
+
+    if (next_source_chunk != chunks_seen) {
+        position_source(chunks_seen);
+    }
+
+    stdx::optional<bsoncxx::document::view> chunk;
+
+    if (fetch_pool) {
+        while (window_offset == window.size()) {
+            if (windows_taken == window_count) {
+                return stdx::nullopt;
+            }
+            take_window(false);
+        }
+
+        chunk = window[window_offset++].view();
+    } else if (manifest) {
+        if (window_offset == window.size()) {
+            if (next_source_chunk == file_chunk_count) {
+                return stdx::nullopt;
+            }
+
+            const auto last = std::min(static_cast<std::int64_t>(next_source_chunk) + window_chunks,
+                                       static_cast<std::int64_t>(file_chunk_count));
+            window = fetch_blobs(*chunks_collection,
+                                 session,
+                                 next_source_chunk,
+                                 static_cast<std::int32_t>(last));
+            window_offset = 0;
+        }
+
+        chunk = window[window_offset++].view();
+    } else {
+        if (!chunks_curr_unread) {
+            ++(*chunks_curr);
+        }
+        chunks_curr_unread = false;
+
+        if (*chunks_curr == *chunks_end) {
+            return stdx::nullopt;
+        }
+
+        chunk = **chunks_curr;
+
+        if (codec) {
+            decompressed_chunk = decompress_chunk(*chunk);
+            chunk = decompressed_chunk->view();
+        }
+    }
+
+    ++next_source_chunk;
+    return chunk;
 }
 
 const downloader::impl& downloader::_get_impl() const {
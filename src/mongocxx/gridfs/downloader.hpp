@@ -18,24 +18,42 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include <bsoncxx/document/value.hpp>
 #include <bsoncxx/document/view.hpp>
 #include <bsoncxx/stdx/optional.hpp>
 #include <bsoncxx/types/bson_value/view.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
 #include <mongocxx/cursor.hpp>
+#include <mongocxx/options/gridfs/download.hpp>
 #include <mongocxx/stdx.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class client_session;
+class collection;
+
 namespace gridfs {
 
+class cached_file;
+
 ///
 /// Class used to download a GridFS file.
 ///
 class MONGOCXX_API downloader {
    public:
+    ///
+    /// A view of contiguous bytes of the file, held by the downloader.
+    ///
+    struct bytes_view {
+        const std::uint8_t* data;
+        std::size_t size;
+    };
+
     ///
     /// Default constructs a downloader object. The downloader is equivalent to the state of a moved
     /// from downloader. The only valid actions to take with a default constructed downloader are to
@@ -86,12 +104,80 @@ class MONGOCXX_API downloader {
     /// @throws mongocxx::gridfs_exception if the requested file has been corrupted.
     ///
     /// @throws mongocxx::query_exception
-    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///   if an error occurs when reading chunk data from the database for the requested file,
+    ///   including on a background thread when the downloader fetches chunks concurrently.
     ///
     std::size_t read(std::uint8_t* buffer, std::size_t length);
 
     ///
-    /// Closes the downloader stream.
+    /// Reads the bytes of the file up to the end of the current chunk without copying them,
+    /// fetching the next chunk first if the current one has been read entirely. Mixing calls to
+    /// next_chunk() with calls to read() is allowed: each one continues where the other stopped.
+    ///
+    /// @return
+    ///   A view of the bytes read, which points into the chunk document held by the downloader and
+    ///   is valid until the next call to a member function of the downloader other than its
+    ///   accessors, or until the downloader is destroyed. If its size is zero, the downloader has
+    ///   reached the end of the file.
+    ///
+    /// @throws mongocxx::logic_error if the download stream was already closed.
+    ///
+    /// @throws mongocxx::gridfs_exception if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///
+    bytes_view next_chunk();
+
+    ///
+    /// Moves the position from which the next bytes are read. Only the chunk containing the new
+    /// position is fetched: the chunks are queried again starting from it, unless it is the chunk
+    /// being read or one of the few chunks which were being read before previous seeks, which the
+    /// downloader keeps in memory. See options::gridfs::download::cached_chunks.
+    ///
+    /// @param offset
+    ///   The offset in bytes from the start of the file, at most the length of the file.
+    ///
+    /// @throws mongocxx::logic_error
+    ///   if the download stream was already closed, or if the offset is outside of the file.
+    ///
+    /// @throws mongocxx::gridfs_exception if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///
+    void seek(std::int64_t offset);
+
+    ///
+    /// Reads a specified number of bytes from a given offset of the GridFS file being downloaded.
+    /// Equivalent to seek() followed by read(): subsequent reads continue after the bytes read.
+    ///
+    /// @param offset
+    ///   The offset in bytes from the start of the file, at most the length of the file.
+    ///
+    /// @param buffer
+    ///   A pointer to a buffer to store the bytes read from the file.
+    ///
+    /// @param length
+    ///   The number of bytes to read from the file.
+    ///
+    /// @return
+    ///   The number of bytes actually read, which is only less than `length` at the end of the
+    ///   file.
+    ///
+    /// @throws mongocxx::logic_error
+    ///   if the download stream was already closed, or if the offset is outside of the file.
+    ///
+    /// @throws mongocxx::gridfs_exception if the requested file has been corrupted.
+    ///
+    /// @throws mongocxx::query_exception
+    ///   if an error occurs when reading chunk data from the database for the requested file.
+    ///
+    std::size_t read_at(std::int64_t offset, std::uint8_t* buffer, std::size_t length);
+
+    ///
+    /// Closes the downloader stream. When the downloader fetches chunks concurrently, waits for the
+    /// queries in progress to complete.
     ///
     /// @throws mongocxx::logic_error if the download stream was already closed.
     ///
@@ -136,8 +222,63 @@ class MONGOCXX_API downloader {
     //
     MONGOCXX_PRIVATE downloader(stdx::optional<cursor> chunks, bsoncxx::document::value files_doc);
 
+    //
+    // Constructs a new downloader stream which queries the chunks itself, either with a single
+    // query or, if `options` sets a fetch pool, in windows fetched concurrently with clients
+    // acquired from the pool.
+    //
+    // @param files_doc
+    //   The files collection document of the file being downloaded. The length of the file must be
+    //   non-zero.
+    //
+    // @param session
+    //   The client session with which to query the chunks, or null. Must be null if `options`
+    //   sets a fetch pool.
+    //
+    // @param database_name
+    //   The name of the database holding the bucket.
+    //
+    // @param chunks
+    //   The chunks collection of the bucket.
+    //
+    // @param options
+    //   The validated options for the download.
+    //
+    MONGOCXX_PRIVATE downloader(bsoncxx::document::value files_doc,
+                                const client_session* session,
+                                stdx::string_view database_name,
+                                const collection& chunks,
+                                const options::gridfs::download& options);
+
+    //
+    // Constructs a new downloader stream which reads a file held in the cache of a bucket, without
+    // querying the server.
+    //
+    // @param file
+    //   The cached file, which the downloader shares until it is closed or destroyed.
+    //
+    // @param options
+    //   The validated options for the download.
+    //
+    MONGOCXX_PRIVATE downloader(std::shared_ptr<const cached_file> file,
+                                const options::gridfs::download& options);
+
     MONGOCXX_PRIVATE void fetch_chunk();
 
+    //
+    // Reads every chunk of the file from the start, and returns copies of the validated chunk
+    // documents, in order, to be cached.
+    //
+    MONGOCXX_PRIVATE std::vector<bsoncxx::document::value> read_all_chunks();
+
+    //
+    // Writes the rest of the file to a file descriptor, at the current position of the descriptor
+    // or, if `positioned`, at the offset of each byte in the file. Calls `progress`, if set, after
+    // each write.
+    //
+    MONGOCXX_PRIVATE void write_to_fd(
+        int fd, bool positioned, const std::function<void(std::int64_t, std::int64_t)>& progress);
+
     class MONGOCXX_PRIVATE impl;
 
     MONGOCXX_PRIVATE impl& _get_impl();
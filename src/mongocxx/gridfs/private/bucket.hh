@@ -17,10 +17,13 @@
 #include <mongocxx/config/private/prelude.hh>
 
 #include <cstddef>
+#include <memory>
 #include <string>
 
 #include <mongocxx/collection.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
+#include <mongocxx/gridfs/private/file_cache.hh>
+#include <mongocxx/options/gridfs/chunk_codec.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
@@ -28,30 +31,61 @@ namespace gridfs {
 
 class bucket::impl {
    public:
-    impl(std::string bucket_name,
+    impl(std::string database_name,
+         std::string bucket_name,
          std::int32_t default_chunk_size_bytes,
+         options::gridfs::chunk_codec default_codec,
+         std::int32_t default_codec_level,
+         bool deduplicate,
+         bool adaptive_chunk_size,
          collection chunks,
-         collection files)
-        : bucket_name{std::move(bucket_name)},
+         collection files,
+         collection blobs)
+        : database_name{std::move(database_name)},
+          bucket_name{std::move(bucket_name)},
           default_chunk_size_bytes{default_chunk_size_bytes},
+          default_codec{default_codec},
+          default_codec_level{default_codec_level},
+          deduplicate{deduplicate},
+          adaptive_chunk_size{adaptive_chunk_size},
           chunks{std::move(chunks)},
           files{std::move(files)},
+          blobs{std::move(blobs)},
           indexes_created{false} {}
 
+    // The name of the database holding the bucket.
+    std::string database_name;
+
     // The name of the bucket.
     std::string bucket_name;
 
     // The default size of the chunks.
     std::int32_t default_chunk_size_bytes;
 
+    // The default codec with which to compress chunks, and its level.
+    options::gridfs::chunk_codec default_codec;
+    std::int32_t default_codec_level;
+
+    // Whether files uploaded through the bucket are deduplicated.
+    bool deduplicate;
+
+    // Whether uploads of a known length pick a chunk size from it.
+    bool adaptive_chunk_size;
+
     // The collection holding the chunks.
     collection chunks;
 
     // The collection holding the files.
     collection files;
 
+    // The collection holding the chunks of deduplicated files, by hash.
+    collection blobs;
+
     // Whether the required indexes have been created.
     bool indexes_created;
+
+    // The cache of the files read through the bucket, shared with its copies, or null.
+    std::shared_ptr<file_cache> cache;
 };
 
 }  // namespace gridfs
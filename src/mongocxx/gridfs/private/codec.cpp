@@ -0,0 +1,196 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <limits>
+
+#if defined(MONGOCXX_ENABLE_ZSTD)
+#include <zstd.h>
+#endif
+
+#if defined(MONGOCXX_ENABLE_LZ4)
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/gridfs_exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/private/codec.hh>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+namespace codec {
+
+namespace {
+
+[[noreturn]] void throw_corrupted_chunk() {
+    throw gridfs_exception{error_code::k_gridfs_file_corrupted,
+                           "chunk data could not be decompressed to the expected length"};
+}
+
+}  // namespace
+
+stdx::string_view name(chunk_codec codec) {
+    switch (codec) {
+        case chunk_codec::k_zstd:
+            return "zstd";
+        case chunk_codec::k_lz4:
+            return "lz4";
+        case chunk_codec::k_none:
+            break;
+    }
+
+    return {};
+}
+
+stdx::optional<chunk_codec> from_name(stdx::string_view name) {
+    for (const auto codec : {chunk_codec::k_zstd, chunk_codec::k_lz4}) {
+        if (name == codec::name(codec)) {
+            return codec;
+        }
+    }
+
+    return stdx::nullopt;
+}
+
+bool supported(chunk_codec codec) {
+    switch (codec) {
+        case chunk_codec::k_none:
+            return true;
+        case chunk_codec::k_zstd:
+#if defined(MONGOCXX_ENABLE_ZSTD)
+            return true;
+#else
+            return false;
+#endif
+        case chunk_codec::k_lz4:
+#if defined(MONGOCXX_ENABLE_LZ4)
+            return true;
+#else
+            return false;
+#endif
+    }
+
+    return false;
+}
+
+std::int32_t default_level(chunk_codec codec) {
+    return codec == chunk_codec::k_zstd ? 3 : 1;
+}
+
+std::vector<std::uint8_t> compress(chunk_codec codec,
+                                   std::int32_t level,
+                                   const std::uint8_t* data,
+                                   std::size_t length) {
+    std::vector<std::uint8_t> out;
+
+    // The level is unused when the driver is built without any codec.
+    static_cast<void>(level);
+
+    switch (codec) {
+        case chunk_codec::k_zstd: {
+#if defined(MONGOCXX_ENABLE_ZSTD)
+            out.resize(ZSTD_compressBound(length));
+            const auto size = ZSTD_compress(out.data(), out.size(), data, length, level);
+            if (ZSTD_isError(size)) {
+                throw logic_error{error_code::k_invalid_parameter, ZSTD_getErrorName(size)};
+            }
+            out.resize(size);
+            return out;
+#else
+            break;
+#endif
+        }
+        case chunk_codec::k_lz4: {
+#if defined(MONGOCXX_ENABLE_LZ4)
+            // Chunks are at most 16MB, well within the int range of the LZ4 API.
+            const int input_size = static_cast<int>(length);
+            out.resize(static_cast<std::size_t>(LZ4_compressBound(input_size)));
+            const auto src = reinterpret_cast<const char*>(data);
+            const auto dst = reinterpret_cast<char*>(out.data());
+            const int capacity = static_cast<int>(out.size());
+            const int size = level > 1
+                                 ? LZ4_compress_HC(src, dst, input_size, capacity, level)
+                                 : LZ4_compress_default(src, dst, input_size, capacity);
+            if (size <= 0 && length > 0) {
+                throw logic_error{error_code::k_invalid_parameter, "LZ4 compression failed"};
+            }
+            out.resize(static_cast<std::size_t>(size));
+            return out;
+#else
+            break;
+#endif
+        }
+        case chunk_codec::k_none:
+            out.assign(data, data + length);
+            return out;
+    }
+
+    throw logic_error{error_code::k_gridfs_codec_not_supported};
+}
+
+void decompress(chunk_codec codec,
+                const std::uint8_t* data,
+                std::size_t length,
+                std::uint8_t* out,
+                std::size_t out_length) {
+    switch (codec) {
+        case chunk_codec::k_zstd: {
+#if defined(MONGOCXX_ENABLE_ZSTD)
+            const auto size = ZSTD_decompress(out, out_length, data, length);
+            if (ZSTD_isError(size) || size != out_length) {
+                throw_corrupted_chunk();
+            }
+            return;
+#else
+            break;
+#endif
+        }
+        case chunk_codec::k_lz4: {
+#if defined(MONGOCXX_ENABLE_LZ4)
+            if (length > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+                throw_corrupted_chunk();
+            }
+            const int size = LZ4_decompress_safe(reinterpret_cast<const char*>(data),
+                                                 reinterpret_cast<char*>(out),
+                                                 static_cast<int>(length),
+                                                 static_cast<int>(out_length));
+            if (size < 0 || static_cast<std::size_t>(size) != out_length) {
+                throw_corrupted_chunk();
+            }
+            return;
+#else
+            break;
+#endif
+        }
+        case chunk_codec::k_none:
+            if (length != out_length) {
+                throw_corrupted_chunk();
+            }
+            std::copy(data, data + length, out);
+            return;
+    }
+
+    throw gridfs_exception{error_code::k_gridfs_codec_not_supported};
+}
+
+}  // namespace codec
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
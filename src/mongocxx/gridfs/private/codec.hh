@@ -0,0 +1,66 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <mongocxx/options/gridfs/chunk_codec.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+namespace codec {
+
+using options::gridfs::chunk_codec;
+
+// Returns the name recorded in the "codec" field of the files document for a codec.
+stdx::string_view name(chunk_codec codec);
+
+// Returns the codec with a recorded name, or a disengaged optional if the name is unknown.
+stdx::optional<chunk_codec> from_name(stdx::string_view name);
+
+// Returns whether the driver was built with support for a codec.
+bool supported(chunk_codec codec);
+
+// Returns the level used when none is set.
+std::int32_t default_level(chunk_codec codec);
+
+// Compresses the data of a chunk.
+std::vector<std::uint8_t> compress(chunk_codec codec,
+                                   std::int32_t level,
+                                   const std::uint8_t* data,
+                                   std::size_t length);
+
+// Decompresses the data of a chunk into `out`, which holds exactly the uncompressed length of the
+// chunk. Throws a gridfs_exception if the data is not a valid compressed chunk of that length.
+void decompress(chunk_codec codec,
+                const std::uint8_t* data,
+                std::size_t length,
+                std::uint8_t* out,
+                std::size_t out_length);
+
+}  // namespace codec
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,304 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <mongocxx/bulk_write.hpp>
+#include <mongocxx/gridfs/private/dedup.hh>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/options/bulk_write.hpp>
+#include <mongocxx/options/find.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+namespace dedup {
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+// The number of distinct chunks named by a single query or bulk write.
+constexpr std::size_t k_max_hashes_per_command = 10000;
+
+// The random values which the gear hash adds for each byte. They are derived from a fixed seed with
+// SplitMix64, so every build cuts the same data at the same boundaries.
+const std::uint64_t* gear_table() {
+    static const std::array<std::uint64_t, 256> table = [] {
+        std::array<std::uint64_t, 256> values;
+        std::uint64_t state = 0x6d6f6e676f646221;
+        for (auto& value : values) {
+            state += 0x9e3779b97f4a7c15;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            value = z ^ (z >> 31);
+        }
+        return values;
+    }();
+
+    return table.data();
+}
+
+// Returns a mask of the `bits` most significant bits, which depend on the last 64 bytes hashed.
+std::uint64_t top_bits(int bits) {
+    return bits <= 0 ? 0 : ~std::uint64_t{0} << (64 - bits);
+}
+
+std::string hash_key(const std::uint8_t* hash) {
+    return std::string(reinterpret_cast<const char*>(hash), k_hash_size);
+}
+
+const std::uint8_t* key_hash(const std::string& key) {
+    return reinterpret_cast<const std::uint8_t*>(key.data());
+}
+
+bsoncxx::types::b_binary data_value(const blob& chunk) {
+    return bsoncxx::types::b_binary{bsoncxx::binary_sub_type::k_binary,
+                                    static_cast<std::uint32_t>(chunk.data.size()),
+                                    chunk.data.data()};
+}
+
+// Calls `run` with each group of at most k_max_hashes_per_command consecutive entries of a map
+// keyed by hash.
+template <typename map_type, typename function_type>
+void for_each_group(const map_type& map, function_type run) {
+    auto it = map.begin();
+    while (it != map.end()) {
+        auto end = it;
+        std::advance(end,
+                     std::min<std::size_t>(k_max_hashes_per_command,
+                                           static_cast<std::size_t>(std::distance(it, map.end()))));
+        run(it, end);
+        it = end;
+    }
+}
+
+}  // namespace
+
+chunker::chunker(std::int32_t average_size) {
+    _average_size = std::min(static_cast<std::size_t>(average_size), k_max_chunk_size);
+    _min_size = std::max<std::size_t>(1, _average_size / 4);
+    _max_size = std::min(_average_size * 4, k_max_chunk_size);
+
+    int bits = 0;
+    while ((std::size_t{2} << bits) <= _average_size) {
+        ++bits;
+    }
+
+    // One more bit before the average size and one fewer after it, as with FastCDC's normalized
+    // chunking at level 1.
+    _small_mask = top_bits(bits + 1);
+    _large_mask = top_bits(bits - 1);
+}
+
+std::size_t chunker::cut(const std::uint8_t* data, std::size_t length) const {
+    if (length <= _min_size) {
+        return length;
+    }
+
+    const std::uint64_t* gear = gear_table();
+    const std::size_t end = std::min(length, _max_size);
+    const std::size_t normal = std::min(end, _average_size);
+
+    // The bytes before the minimum size are never a boundary, so hashing starts there.
+    std::uint64_t hash = 0;
+    std::size_t i = _min_size;
+
+    for (; i < normal; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & _small_mask)) {
+            return i + 1;
+        }
+    }
+
+    for (; i < end; ++i) {
+        hash = (hash << 1) + gear[data[i]];
+        if (!(hash & _large_mask)) {
+            return i + 1;
+        }
+    }
+
+    return end;
+}
+
+bsoncxx::types::b_binary hash_value(const std::uint8_t* hash) {
+    return bsoncxx::types::b_binary{
+        bsoncxx::binary_sub_type::k_binary, static_cast<std::uint32_t>(k_hash_size), hash};
+}
+
+void append_entry(std::vector<std::uint8_t>& manifest,
+                  const std::uint8_t* hash,
+                  std::uint32_t length) {
+    manifest.insert(manifest.end(), hash, hash + k_hash_size);
+    for (int i = 0; i < 4; ++i) {
+        manifest.push_back(static_cast<std::uint8_t>(length >> (8 * i)));
+    }
+}
+
+std::uint32_t entry_length(const std::uint8_t* entry) {
+    std::uint32_t length = 0;
+    for (int i = 0; i < 4; ++i) {
+        length |= static_cast<std::uint32_t>(entry[k_hash_size + i]) << (8 * i);
+    }
+    return length;
+}
+
+void store_blobs(collection& blobs, const client_session* session, const std::vector<blob>& batch) {
+    // The number of references which the batch adds to each distinct chunk, and the first chunk
+    // of the batch with that hash.
+    std::map<std::string, std::pair<std::int64_t, const blob*>> refs;
+    for (auto&& chunk : batch) {
+        auto& entry = refs[hash_key(chunk.hash)];
+        if (entry.first++ == 0) {
+            entry.second = &chunk;
+        }
+    }
+
+    using iterator = decltype(refs)::const_iterator;
+
+    for_each_group(refs, [&](iterator begin, iterator end) {
+        // Only the chunks which the server does not hold yet are sent.
+        bsoncxx::builder::basic::array ids;
+        for (auto it = begin; it != end; ++it) {
+            ids.append(hash_value(key_hash(it->first)));
+        }
+
+        const auto filter = make_document(kvp("_id", make_document(kvp("$in", ids.extract()))));
+
+        options::find find_options;
+        find_options.projection(make_document(kvp("_id", 1)));
+
+        std::set<std::string> existing;
+        auto cursor = session ? blobs.find(*session, filter.view(), find_options)
+                              : blobs.find(filter.view(), find_options);
+        for (auto&& doc : cursor) {
+            const auto id = doc["_id"];
+            if (id && id.type() == bsoncxx::type::k_binary &&
+                id.get_binary().size == k_hash_size) {
+                existing.insert(hash_key(id.get_binary().bytes));
+            }
+        }
+
+        options::bulk_write bulk_options;
+        bulk_options.ordered(false);
+
+        auto bulk = session ? blobs.create_bulk_write(*session, bulk_options)
+                            : blobs.create_bulk_write(bulk_options);
+
+        // The chunk of each write, and whether the write carries its data.
+        std::vector<std::pair<const blob*, bool>> writes;
+
+        for (auto it = begin; it != end; ++it) {
+            const blob& chunk = *it->second.second;
+            const bool send_data = existing.count(it->first) == 0;
+
+            bsoncxx::builder::basic::document update;
+            update.append(kvp("$inc", make_document(kvp("refs", it->second.first))));
+            if (send_data) {
+                update.append(
+                    kvp("$setOnInsert", make_document(kvp("data", data_value(chunk)))));
+            }
+
+            // Even a chunk which was found is upserted, in case it has been deleted since.
+            model::update_one write{make_document(kvp("_id", hash_value(chunk.hash))),
+                                    update.extract()};
+            write.upsert(true);
+            bulk.append(write);
+            writes.emplace_back(&chunk, send_data);
+        }
+
+        const auto result = bulk.execute();
+        if (!result) {
+            return;
+        }
+
+        // A chunk deleted after it was found was inserted again without data, which is added now.
+        for (auto&& upserted : result->upserted_ids()) {
+            const auto& write = writes[upserted.first];
+            if (write.second) {
+                continue;
+            }
+
+            const blob& chunk = *write.first;
+            auto chunk_filter = make_document(kvp("_id", hash_value(chunk.hash)));
+            auto chunk_update =
+                make_document(kvp("$set", make_document(kvp("data", data_value(chunk)))));
+
+            if (session) {
+                blobs.update_one(*session, chunk_filter.view(), chunk_update.view());
+            } else {
+                blobs.update_one(chunk_filter.view(), chunk_update.view());
+            }
+        }
+    });
+}
+
+void release_blobs(collection& blobs,
+                   const client_session* session,
+                   const std::uint8_t* manifest,
+                   std::size_t entries) {
+    std::map<std::string, std::int64_t> refs;
+    for (std::size_t i = 0; i < entries; ++i) {
+        ++refs[hash_key(manifest + i * k_entry_size)];
+    }
+
+    using iterator = decltype(refs)::const_iterator;
+
+    for_each_group(refs, [&](iterator begin, iterator end) {
+        options::bulk_write bulk_options;
+        bulk_options.ordered(false);
+
+        auto bulk = session ? blobs.create_bulk_write(*session, bulk_options)
+                            : blobs.create_bulk_write(bulk_options);
+
+        bsoncxx::builder::basic::array ids;
+
+        for (auto it = begin; it != end; ++it) {
+            ids.append(hash_value(key_hash(it->first)));
+            bulk.append(model::update_one{
+                make_document(kvp("_id", hash_value(key_hash(it->first)))),
+                make_document(kvp("$inc", make_document(kvp("refs", -it->second))))});
+        }
+
+        bulk.execute();
+
+        // A chunk which an upload refers to again in the meantime has a positive count, and stays.
+        auto filter = make_document(kvp("_id", make_document(kvp("$in", ids.extract()))),
+                                    kvp("refs", make_document(kvp("$lte", 0))));
+
+        if (session) {
+            blobs.delete_many(*session, filter.view());
+        } else {
+            blobs.delete_many(filter.view());
+        }
+    });
+}
+
+}  // namespace dedup
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
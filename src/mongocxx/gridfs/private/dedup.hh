@@ -0,0 +1,101 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client_session.hpp>
+#include <mongocxx/collection.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+namespace dedup {
+
+// The size of the SHA-256 identifying a chunk in the blobs collection.
+constexpr std::size_t k_hash_size = 32;
+
+// The size of an entry of a manifest: the hash of a chunk followed by its length as a
+// little-endian 32-bit integer.
+constexpr std::size_t k_entry_size = k_hash_size + 4;
+
+// The largest chunk, which leaves room in its blob document for the other fields.
+constexpr std::size_t k_max_chunk_size = 15 * 1000 * 1000;
+
+// Cuts data into chunks at content-defined boundaries, following FastCDC: a gear hash rolls over
+// the data and a boundary is placed where its top bits are zero. Boundaries are harder to find
+// before the average size and easier after it, which keeps most chunks close to the average.
+class chunker {
+   public:
+    explicit chunker(std::int32_t average_size);
+
+    // Returns the length of the chunk at the start of `data`. A chunk is never longer than
+    // max_size(), and only shorter than min_size() when `length` is.
+    std::size_t cut(const std::uint8_t* data, std::size_t length) const;
+
+    std::size_t max_size() const {
+        return _max_size;
+    }
+
+   private:
+    std::size_t _min_size;
+    std::size_t _average_size;
+    std::size_t _max_size;
+
+    // The masks of the hash bits which must be zero at a boundary before and after the average
+    // size.
+    std::uint64_t _small_mask;
+    std::uint64_t _large_mask;
+};
+
+// A chunk waiting to be stored in the blobs collection.
+struct blob {
+    std::uint8_t hash[k_hash_size];
+    std::vector<std::uint8_t> data;
+};
+
+// Returns the BSON value identifying a chunk in the blobs collection.
+bsoncxx::types::b_binary hash_value(const std::uint8_t* hash);
+
+// Appends an entry to a manifest.
+void append_entry(std::vector<std::uint8_t>& manifest,
+                  const std::uint8_t* hash,
+                  std::uint32_t length);
+
+// Returns the length of the chunk of a manifest entry.
+std::uint32_t entry_length(const std::uint8_t* entry);
+
+// Adds a reference to each chunk of a batch. Chunks which the blobs collection already holds only
+// have their reference count incremented; the others are inserted.
+void store_blobs(collection& blobs, const client_session* session, const std::vector<blob>& batch);
+
+// Removes a reference to each chunk listed by the entries of a manifest, and deletes the chunks
+// which are no longer referred to.
+void release_blobs(collection& blobs,
+                   const client_session* session,
+                   const std::uint8_t* manifest,
+                   std::size_t entries);
+
+}  // namespace dedup
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
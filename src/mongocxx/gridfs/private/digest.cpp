@@ -0,0 +1,430 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#include <mongocxx/gridfs/private/digest.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+const char k_hex_digits[] = "0123456789abcdef";
+
+std::uint32_t load_be32(const std::uint8_t* in) {
+    return static_cast<std::uint32_t>(in[0]) << 24 | static_cast<std::uint32_t>(in[1]) << 16 |
+           static_cast<std::uint32_t>(in[2]) << 8 | static_cast<std::uint32_t>(in[3]);
+}
+
+std::uint32_t load_le32(const std::uint8_t* in) {
+    return static_cast<std::uint32_t>(in[0]) | static_cast<std::uint32_t>(in[1]) << 8 |
+           static_cast<std::uint32_t>(in[2]) << 16 | static_cast<std::uint32_t>(in[3]) << 24;
+}
+
+std::uint64_t load_le64(const std::uint8_t* in) {
+    return static_cast<std::uint64_t>(load_le32(in)) |
+           static_cast<std::uint64_t>(load_le32(in + 4)) << 32;
+}
+
+std::uint32_t rotr32(std::uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+}
+
+std::uint64_t rotl64(std::uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// Formats the low `bytes` bytes of a value as big-endian hex.
+std::string to_hex(std::uint64_t value, int bytes) {
+    std::string hex(static_cast<std::size_t>(bytes) * 2, '0');
+    for (int i = bytes * 2 - 1; i >= 0; --i) {
+        hex[static_cast<std::size_t>(i)] = k_hex_digits[value & 0xf];
+        value >>= 4;
+    }
+    return hex;
+}
+
+const std::uint32_t k_sha256_round_constants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+const std::uint64_t k_xxhash64_prime1 = 11400714785074694791ULL;
+const std::uint64_t k_xxhash64_prime2 = 14029467366897019727ULL;
+const std::uint64_t k_xxhash64_prime3 = 1609587929392839161ULL;
+const std::uint64_t k_xxhash64_prime4 = 9650029242287828579ULL;
+const std::uint64_t k_xxhash64_prime5 = 2870177450012600261ULL;
+
+std::uint64_t xxhash64_round(std::uint64_t acc, std::uint64_t input) {
+    acc += input * k_xxhash64_prime2;
+    acc = rotl64(acc, 31);
+    return acc * k_xxhash64_prime1;
+}
+
+std::uint64_t xxhash64_merge_round(std::uint64_t acc, std::uint64_t value) {
+    acc ^= xxhash64_round(0, value);
+    return acc * k_xxhash64_prime1 + k_xxhash64_prime4;
+}
+
+// Tables for computing CRC32C eight bytes at a time in software.
+struct crc32c_tables {
+    crc32c_tables() {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+            }
+            table[0][i] = crc;
+        }
+
+        for (std::size_t k = 1; k < 8; ++k) {
+            for (std::size_t i = 0; i < 256; ++i) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff];
+            }
+        }
+    }
+
+    std::uint32_t table[8][256];
+};
+
+std::uint32_t crc32c_software(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    static const crc32c_tables tables;
+    const auto& t = tables.table;
+
+    for (; length >= 8; data += 8, length -= 8) {
+        const std::uint64_t word = load_le64(data) ^ crc;
+        crc = t[7][word & 0xff] ^ t[6][(word >> 8) & 0xff] ^ t[5][(word >> 16) & 0xff] ^
+              t[4][(word >> 24) & 0xff] ^ t[3][(word >> 32) & 0xff] ^ t[2][(word >> 40) & 0xff] ^
+              t[1][(word >> 48) & 0xff] ^ t[0][word >> 56];
+    }
+
+    for (; length > 0; ++data, --length) {
+        crc = t[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// The SSE 4.2 CRC32 instruction computes CRC32C. It is selected at runtime so that builds for
+// generic x86-64 targets still use it where the CPU supports it.
+__attribute__((target("sse4.2"))) std::uint32_t crc32c_hardware(std::uint32_t crc,
+                                                                  const std::uint8_t* data,
+                                                                  std::size_t length) {
+    std::uint64_t crc64 = crc;
+    for (; length >= 8; data += 8, length -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    crc = static_cast<std::uint32_t>(crc64);
+    for (; length > 0; ++data, --length) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+
+    return crc;
+}
+
+std::uint32_t crc32c_update(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    static const bool has_sse42 = __builtin_cpu_supports("sse4.2");
+    return has_sse42 ? crc32c_hardware(crc, data, length) : crc32c_software(crc, data, length);
+}
+#elif defined(__ARM_FEATURE_CRC32)
+std::uint32_t crc32c_update(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    for (; length >= 8; data += 8, length -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+    }
+
+    for (; length > 0; ++data, --length) {
+        crc = __crc32cb(crc, *data);
+    }
+
+    return crc;
+}
+#else
+std::uint32_t crc32c_update(std::uint32_t crc, const std::uint8_t* data, std::size_t length) {
+    return crc32c_software(crc, data, length);
+}
+#endif
+
+}  // namespace
+
+digest::digest(algorithm algo)
+    : _algorithm{algo},
+      _length{0},
+      _block_length{0},
+      _sha256{0x6a09e667,
+              0xbb67ae85,
+              0x3c6ef372,
+              0xa54ff53a,
+              0x510e527f,
+              0x9b05688c,
+              0x1f83d9ab,
+              0x5be0cd19},
+      _xxhash64{k_xxhash64_prime1 + k_xxhash64_prime2, k_xxhash64_prime2, 0, 0 - k_xxhash64_prime1},
+      _crc32c{0xffffffff} {}
+
+stdx::string_view digest::field_name(algorithm algo) {
+    switch (algo) {
+        case algorithm::k_sha256:
+            return "sha256";
+        case algorithm::k_xxhash64:
+            return "xxhash64";
+        case algorithm::k_crc32c:
+            return "crc32c";
+    }
+
+    return {};
+}
+
+stdx::optional<digest::algorithm> digest::find(bsoncxx::document::view files_doc) {
+    for (const auto algo : {algorithm::k_sha256, algorithm::k_xxhash64, algorithm::k_crc32c}) {
+        if (files_doc[field_name(algo)]) {
+            return algo;
+        }
+    }
+
+    return stdx::nullopt;
+}
+
+void digest::update(const std::uint8_t* data, std::size_t length) {
+    _length += length;
+
+    switch (_algorithm) {
+        case algorithm::k_sha256:
+            sha256_update(data, length);
+            break;
+        case algorithm::k_xxhash64:
+            xxhash64_update(data, length);
+            break;
+        case algorithm::k_crc32c:
+            _crc32c = crc32c_update(_crc32c, data, length);
+            break;
+    }
+}
+
+std::string digest::finish() {
+    switch (_algorithm) {
+        case algorithm::k_sha256:
+            return sha256_finish();
+        case algorithm::k_xxhash64:
+            return xxhash64_finish();
+        case algorithm::k_crc32c:
+            return to_hex(_crc32c ^ 0xffffffff, 4);
+    }
+
+    return {};
+}
+
+void digest::sha256_update(const std::uint8_t* data, std::size_t length) {
+    if (_block_length) {
+        const std::size_t taken = std::min(length, sizeof(_block) - _block_length);
+        std::memcpy(_block + _block_length, data, taken);
+        _block_length += taken;
+        data += taken;
+        length -= taken;
+
+        if (_block_length < sizeof(_block)) {
+            return;
+        }
+
+        sha256_compress(_block);
+        _block_length = 0;
+    }
+
+    for (; length >= 64; data += 64, length -= 64) {
+        sha256_compress(data);
+    }
+
+    std::memcpy(_block, data, length);
+    _block_length = length;
+}
+
+void digest::sha256_compress(const std::uint8_t* block) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = load_be32(block + 4 * i);
+    }
+    for (int i = 16; i < 64; ++i) {
+        const std::uint32_t s0 = rotr32(w[i - 15], 7) ^ rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const std::uint32_t s1 = rotr32(w[i - 2], 17) ^ rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    std::uint32_t a = _sha256[0], b = _sha256[1], c = _sha256[2], d = _sha256[3];
+    std::uint32_t e = _sha256[4], f = _sha256[5], g = _sha256[6], h = _sha256[7];
+
+    for (int i = 0; i < 64; ++i) {
+        const std::uint32_t s1 = rotr32(e, 6) ^ rotr32(e, 11) ^ rotr32(e, 25);
+        const std::uint32_t ch = (e & f) ^ (~e & g);
+        const std::uint32_t t1 = h + s1 + ch + k_sha256_round_constants[i] + w[i];
+        const std::uint32_t s0 = rotr32(a, 2) ^ rotr32(a, 13) ^ rotr32(a, 22);
+        const std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        const std::uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    _sha256[0] += a;
+    _sha256[1] += b;
+    _sha256[2] += c;
+    _sha256[3] += d;
+    _sha256[4] += e;
+    _sha256[5] += f;
+    _sha256[6] += g;
+    _sha256[7] += h;
+}
+
+void digest::sha256(const std::uint8_t* data, std::size_t length, std::uint8_t* out) {
+    digest sha256{algorithm::k_sha256};
+    sha256.update(data, length);
+    sha256.sha256_pad();
+
+    for (const auto word : sha256._sha256) {
+        for (int i = 0; i < 4; ++i) {
+            *out++ = static_cast<std::uint8_t>(word >> (24 - 8 * i));
+        }
+    }
+}
+
+void digest::sha256_pad() {
+    const std::uint64_t bit_length = _length * 8;
+
+    _block[_block_length++] = 0x80;
+    if (_block_length > 56) {
+        std::memset(_block + _block_length, 0, sizeof(_block) - _block_length);
+        sha256_compress(_block);
+        _block_length = 0;
+    }
+
+    std::memset(_block + _block_length, 0, 56 - _block_length);
+    for (int i = 0; i < 8; ++i) {
+        _block[56 + i] = static_cast<std::uint8_t>(bit_length >> (56 - 8 * i));
+    }
+    sha256_compress(_block);
+}
+
+std::string digest::sha256_finish() {
+    sha256_pad();
+
+    std::string hex;
+    for (const auto word : _sha256) {
+        hex += to_hex(word, 4);
+    }
+
+    return hex;
+}
+
+void digest::xxhash64_update(const std::uint8_t* data, std::size_t length) {
+    // Each stripe of 32 bytes feeds the four accumulators, eight bytes each.
+    if (_block_length) {
+        const std::size_t taken = std::min(length, std::size_t{32} - _block_length);
+        std::memcpy(_block + _block_length, data, taken);
+        _block_length += taken;
+        data += taken;
+        length -= taken;
+
+        if (_block_length < 32) {
+            return;
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            _xxhash64[i] = xxhash64_round(_xxhash64[i], load_le64(_block + 8 * i));
+        }
+        _block_length = 0;
+    }
+
+    for (; length >= 32; data += 32, length -= 32) {
+        for (int i = 0; i < 4; ++i) {
+            _xxhash64[i] = xxhash64_round(_xxhash64[i], load_le64(data + 8 * i));
+        }
+    }
+
+    std::memcpy(_block, data, length);
+    _block_length = length;
+}
+
+std::string digest::xxhash64_finish() {
+    std::uint64_t hash;
+
+    if (_length >= 32) {
+        hash = rotl64(_xxhash64[0], 1) + rotl64(_xxhash64[1], 7) + rotl64(_xxhash64[2], 12) +
+               rotl64(_xxhash64[3], 18);
+        for (const auto acc : _xxhash64) {
+            hash = xxhash64_merge_round(hash, acc);
+        }
+    } else {
+        hash = k_xxhash64_prime5;
+    }
+
+    hash += _length;
+
+    const std::uint8_t* tail = _block;
+    std::size_t remaining = _block_length;
+
+    for (; remaining >= 8; tail += 8, remaining -= 8) {
+        hash ^= xxhash64_round(0, load_le64(tail));
+        hash = rotl64(hash, 27) * k_xxhash64_prime1 + k_xxhash64_prime4;
+    }
+
+    if (remaining >= 4) {
+        hash ^= static_cast<std::uint64_t>(load_le32(tail)) * k_xxhash64_prime1;
+        hash = rotl64(hash, 23) * k_xxhash64_prime2 + k_xxhash64_prime3;
+        tail += 4;
+        remaining -= 4;
+    }
+
+    for (; remaining > 0; ++tail, --remaining) {
+        hash ^= *tail * k_xxhash64_prime5;
+        hash = rotl64(hash, 11) * k_xxhash64_prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= k_xxhash64_prime2;
+    hash ^= hash >> 29;
+    hash *= k_xxhash64_prime3;
+    hash ^= hash >> 32;
+
+    return to_hex(hash, 8);
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
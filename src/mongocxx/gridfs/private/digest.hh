@@ -0,0 +1,89 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <mongocxx/options/gridfs/upload.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// A digest of the contents of a GridFS file, computed incrementally as the file is written or
+// read.
+class digest {
+   public:
+    using algorithm = options::gridfs::upload::digest_algorithm;
+
+    explicit digest(algorithm algo);
+
+    // Returns the name of the files document field holding a digest computed with `algo`.
+    static stdx::string_view field_name(algorithm algo);
+
+    // Finds a digest recorded in a files document, returning the algorithm with which it was
+    // computed, or a disengaged optional if the document holds none.
+    static stdx::optional<algorithm> find(bsoncxx::document::view files_doc);
+
+    // Computes the SHA-256 of a buffer, writing its 32 bytes to `out`.
+    static void sha256(const std::uint8_t* data, std::size_t length, std::uint8_t* out);
+
+    // Adds bytes to the digest.
+    void update(const std::uint8_t* data, std::size_t length);
+
+    // Returns the digest of every byte added so far, as a lowercase hex string. No bytes may be
+    // added afterwards.
+    std::string finish();
+
+   private:
+    void sha256_update(const std::uint8_t* data, std::size_t length);
+    void sha256_compress(const std::uint8_t* block);
+    void sha256_pad();
+    std::string sha256_finish();
+
+    void xxhash64_update(const std::uint8_t* data, std::size_t length);
+    std::string xxhash64_finish();
+
+    algorithm _algorithm;
+
+    // The number of bytes added so far.
+    std::uint64_t _length;
+
+    // Input which does not yet fill a block: 64 bytes for SHA-256, 32 bytes for xxHash64.
+    std::uint8_t _block[64];
+    std::size_t _block_length;
+
+    // The state of SHA-256.
+    std::uint32_t _sha256[8];
+
+    // The four accumulators of xxHash64.
+    std::uint64_t _xxhash64[4];
+
+    // The running CRC32C, not yet inverted.
+    std::uint32_t _crc32c;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -16,10 +16,27 @@
 
 #include <mongocxx/config/private/prelude.hh>
 
+#include <condition_variable>
 #include <cstdlib>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <mongocxx/collection.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/gridfs/downloader.hpp>
+#include <mongocxx/gridfs/private/digest.hh>
+#include <mongocxx/gridfs/private/file_cache.hh>
+#include <mongocxx/options/gridfs/chunk_codec.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/read_concern.hpp>
+#include <mongocxx/read_preference.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
@@ -92,11 +109,26 @@ class downloader::impl {
           chunks_curr{chunks ? stdx::make_optional<cursor::iterator>(chunks->begin())
                              : stdx::nullopt},
           chunks_end{chunks ? stdx::make_optional<cursor::iterator>(chunks->end()) : stdx::nullopt},
+          chunks_curr_unread{true},
           chunks_seen{0},
           chunk_size{read_chunk_size_from_files_document(files_doc.view())},
           closed{false},
           file_chunk_count{0},
-          file_len{read_length_from_files_document(files_doc.view())} {
+          file_len{read_length_from_files_document(files_doc.view())},
+          session{nullptr},
+          next_source_chunk{0},
+          manifest{nullptr},
+          max_cached_chunks{0},
+          digest_chunks{0},
+          window_offset{0},
+          fetch_pool{nullptr},
+          windows_first_chunk{0},
+          window_chunks{0},
+          window_count{0},
+          windows_started{0},
+          windows_taken{0},
+          read_ahead{0},
+          stopping{false} {
         if (chunk_size) {
             std::lldiv_t num_chunks_div = std::lldiv(file_len, chunk_size);
             if (num_chunks_div.rem) {
@@ -115,6 +147,79 @@ class downloader::impl {
         }
     }
 
+    // A window of consecutive chunks fetched by a single query when chunks are fetched
+    // concurrently, or the error raised by the query.
+    struct fetched_window {
+        std::vector<bsoncxx::document::value> chunks;
+        std::exception_ptr error;
+    };
+
+    ~impl() {
+        stop_fetch();
+    }
+
+    // Records how to query the chunks, and positions the source of chunks at the first one.
+    void open(const client_session* session,
+              stdx::string_view database_name,
+              const collection& chunks,
+              const options::gridfs::download& options);
+
+    // Reads the layout of the file from the files document, and the options which do not depend
+    // on how the chunks are queried.
+    void prepare(const options::gridfs::download& options);
+
+    // Positions the source of chunks, either `chunks` or the windows fetched concurrently, so that
+    // the next chunk it returns is `first`.
+    void position_source(std::int32_t first);
+
+    // Keeps a copy of the chunk being read, which is about to be left by a seek.
+    void cache_current_chunk();
+
+    // Stops the threads fetching windows of chunks, waiting for the queries in progress.
+    void stop_fetch();
+
+    // Runs on each thread fetching windows of chunks.
+    void run_fetch();
+
+    // Queries the chunks of a window.
+    std::vector<bsoncxx::document::value> fetch_window(client& client, std::int32_t index);
+
+    // Waits for the next window to be fetched, or for any window if `any_order`, makes it the
+    // current one and returns its index.
+    std::int32_t take_window(bool any_order);
+
+    // Checks that a chunk document is chunk `n` of the file and returns its data.
+    bsoncxx::types::b_binary validate_chunk(bsoncxx::document::view chunk_doc,
+                                            std::int32_t n) const;
+
+    // Adds chunk `n` to the digest being verified if it is the next chunk in order, and checks the
+    // digest once every chunk has been added.
+    void update_digest(std::int32_t n, const bsoncxx::types::b_binary& data);
+
+    // Returns the offset in the file of chunk `n`.
+    std::int64_t chunk_start(std::int32_t n) const;
+
+    // Returns the length of chunk `n`.
+    std::size_t chunk_length(std::int32_t n) const;
+
+    // Returns the chunk holding the byte at an offset, which is the number of chunks for the end
+    // of a file whose last chunk is full.
+    std::int32_t chunk_at(std::int64_t offset) const;
+
+    // Queries the chunks `first` to `last` (excluded) of a deduplicated file from the blobs
+    // collection, and returns them as chunk documents in order.
+    std::vector<bsoncxx::document::value> fetch_blobs(collection& blobs,
+                                                      const client_session* session,
+                                                      std::int32_t first,
+                                                      std::int32_t last) const;
+
+    // Returns a copy of a chunk document whose data is decompressed with `codec`. Documents which
+    // are not well-formed chunks of the file are copied as is, to be reported by validate_chunk().
+    bsoncxx::document::value decompress_chunk(bsoncxx::document::view chunk_doc) const;
+
+    // Returns the next chunk document, or a disengaged optional once the chunks are exhausted.
+    stdx::optional<bsoncxx::document::view> next_chunk_document();
+
     // The files document for the file being downloaded.
     bsoncxx::document::value files_doc;
 
@@ -139,6 +244,10 @@ class downloader::impl {
     // have a value.
     stdx::optional<cursor::iterator> chunks_end;
 
+    // Whether `chunks_curr` points to a chunk document which has not been returned yet, as is the
+    // case right after querying the chunks.
+    bool chunks_curr_unread;
+
     // The number of chunks already downloaded from the server.
     std::int32_t chunks_seen;
 
@@ -153,6 +262,83 @@ class downloader::impl {
 
     // The total length of the file in bytes.
     std::int64_t file_len;
+
+    // The client session and the chunks collection with which to query the chunks again after a
+    // seek.
+    const client_session* session;
+    stdx::optional<collection> chunks_collection;
+
+    // The chunk document being read.
+    bsoncxx::document::view chunk_doc;
+
+    // The number of the chunk which the source of chunks returns next.
+    std::int32_t next_source_chunk;
+
+    // For a deduplicated file, the entries of the manifest within `files_doc`, and the offset of
+    // each chunk in the file followed by the length of the file. Chunks are then fetched from the
+    // blobs collection a window at a time, whether or not a fetch pool is used.
+    const std::uint8_t* manifest;
+    std::vector<std::int64_t> chunk_offsets;
+
+    // Copies of the chunks left by a seek, most recently used first, and their maximum number.
+    std::deque<std::pair<std::int32_t, bsoncxx::document::value>> cached_chunks;
+    std::size_t max_cached_chunks;
+
+    // The digest of the chunks fetched in order so far when verifying the digest recorded in the
+    // files document, the recorded digest, and the number of chunks added to the digest.
+    stdx::optional<class digest> digest;
+    std::string expected_digest;
+    std::int32_t digest_chunks;
+
+    // The codec with which the chunks were compressed, if any, and the current chunk after
+    // decompression when chunks are read from `chunks`.
+    stdx::optional<options::gridfs::chunk_codec> codec;
+    stdx::optional<bsoncxx::document::value> decompressed_chunk;
+
+    // The cached file being read, if any, which holds every chunk. It is shared with the cache of
+    // the bucket and with other downloaders.
+    std::shared_ptr<const cached_file> cached;
+
+    // The window of chunks being read, and the offset of the next chunk to read from it.
+    std::vector<bsoncxx::document::value> window;
+    std::size_t window_offset;
+
+    // The pool from which to acquire clients to fetch windows of chunks, or null if the chunks are
+    // read from `chunks`.
+    pool* fetch_pool;
+
+    // The namespace, read concern and read preference of the queries fetching windows of chunks.
+    std::string fetch_database_name;
+    std::string fetch_collection_name;
+    class read_concern fetch_read_concern;
+    class read_preference fetch_read_preference;
+
+    // The number of the first chunk of the first window, the number of chunks in a window, and the
+    // number of windows from the first one to the end of the file.
+    std::int32_t windows_first_chunk;
+    std::int32_t window_chunks;
+    std::int32_t window_count;
+
+    // Guards the members below, which are shared with the threads fetching windows of chunks.
+    std::mutex mutex;
+
+    // Signalled when a window has been fetched, and when a window has been taken by the reader.
+    std::condition_variable window_fetched;
+    std::condition_variable window_taken;
+
+    // The windows fetched but not yet taken by the reader, by index.
+    std::map<std::int32_t, fetched_window> fetched_windows;
+
+    // The number of windows whose query has started, and the number taken by the reader. A query
+    // only starts for a window less than `read_ahead` windows ahead of the reader.
+    std::int32_t windows_started;
+    std::int32_t windows_taken;
+    std::int32_t read_ahead;
+
+    // Whether the threads fetching windows of chunks have been asked to stop.
+    bool stopping;
+
+    std::vector<std::thread> fetch_threads;
 };
 
 }  // namespace gridfs
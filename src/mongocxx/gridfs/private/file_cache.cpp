@@ -0,0 +1,152 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <iterator>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <mongocxx/gridfs/private/file_cache.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+namespace {
+
+// Files longer than this fraction of the budget are not cached, so that a single file cannot
+// evict all of the others.
+constexpr std::int64_t k_max_file_share = 4;
+
+bool same_field(bsoncxx::document::view a, bsoncxx::document::view b, const char* field) {
+    const auto a_ele = a[field];
+    const auto b_ele = b[field];
+
+    if (!a_ele || !b_ele) {
+        return !a_ele && !b_ele;
+    }
+
+    return a_ele.get_value() == b_ele.get_value();
+}
+
+}  // namespace
+
+cached_file::cached_file(bsoncxx::document::value files_doc,
+                         std::vector<bsoncxx::document::value> chunks)
+    : files_doc{std::move(files_doc)}, chunks{std::move(chunks)} {
+    size = static_cast<std::int64_t>(this->files_doc.view().length());
+    for (auto&& chunk : this->chunks) {
+        size += static_cast<std::int64_t>(chunk.view().length());
+    }
+}
+
+file_cache::file_cache(std::int64_t budget, std::chrono::milliseconds revalidate_after)
+    : _budget{budget}, _revalidate_after{revalidate_after}, _size{0} {}
+
+std::string file_cache::key(bsoncxx::types::bson_value::view id) {
+    // The encoded value includes its type, so ids of different types never share a key.
+    const auto doc = bsoncxx::builder::basic::make_document(bsoncxx::builder::basic::kvp("", id));
+    return std::string(reinterpret_cast<const char*>(doc.view().data()), doc.view().length());
+}
+
+bool file_cache::admits(std::int64_t length) const {
+    return length <= _budget / k_max_file_share;
+}
+
+std::shared_ptr<const cached_file> file_cache::find_fresh(const std::string& key) {
+    if (_revalidate_after.count() <= 0) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto it = _index.find(key);
+    if (it == _index.end() ||
+        std::chrono::steady_clock::now() - it->second->second.validated >= _revalidate_after) {
+        return nullptr;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->second.file;
+}
+
+std::shared_ptr<const cached_file> file_cache::find_valid(const std::string& key,
+                                                          bsoncxx::document::view files_doc) {
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto it = _index.find(key);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+
+    const auto cached = it->second->second.file->files_doc.view();
+    if (!same_field(cached, files_doc, "_id") || !same_field(cached, files_doc, "length") ||
+        !same_field(cached, files_doc, "uploadDate")) {
+        remove(it->second);
+        return nullptr;
+    }
+
+    it->second->second.validated = std::chrono::steady_clock::now();
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return it->second->second.file;
+}
+
+std::shared_ptr<const cached_file> file_cache::insert(
+    const std::string& key,
+    bsoncxx::document::value files_doc,
+    std::vector<bsoncxx::document::value> chunks) {
+    // The file is built outside of the lock, and is handed to the caller even if it does not fit.
+    auto file = std::make_shared<const cached_file>(std::move(files_doc), std::move(chunks));
+
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto existing = _index.find(key);
+    if (existing != _index.end()) {
+        remove(existing->second);
+    }
+
+    if (file->size > _budget) {
+        return file;
+    }
+
+    _entries.emplace_front(key, entry{file, std::chrono::steady_clock::now()});
+    _index.emplace(key, _entries.begin());
+    _size += file->size;
+
+    while (_size > _budget) {
+        remove(std::prev(_entries.end()));
+    }
+
+    return file;
+}
+
+void file_cache::erase(const std::string& key) {
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    const auto it = _index.find(key);
+    if (it != _index.end()) {
+        remove(it->second);
+    }
+}
+
+void file_cache::remove(entry_list::iterator it) {
+    _size -= it->second.file->size;
+    _index.erase(it->first);
+    _entries.erase(it);
+}
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
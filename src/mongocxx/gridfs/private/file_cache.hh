@@ -0,0 +1,110 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace gridfs {
+
+// A file held in memory by the cache of a bucket. It is never modified once cached, and is shared
+// by the downloaders reading it, so a file evicted from the cache is only freed once they are done.
+class cached_file {
+   public:
+    cached_file(bsoncxx::document::value files_doc, std::vector<bsoncxx::document::value> chunks);
+
+    // The files document of the file.
+    bsoncxx::document::value files_doc;
+
+    // The chunk documents of the file, in order, already validated and decompressed.
+    std::vector<bsoncxx::document::value> chunks;
+
+    // The number of bytes held by the documents.
+    std::int64_t size;
+};
+
+// A cache of whole files, bounded by the number of bytes it holds, which evicts the least recently
+// used files first. It is shared by the copies of a bucket, which may be used on several threads.
+class file_cache {
+   public:
+    file_cache(std::int64_t budget, std::chrono::milliseconds revalidate_after);
+
+    // Returns the key under which the file with an id is cached.
+    static std::string key(bsoncxx::types::bson_value::view id);
+
+    // Returns whether a file of a given length is small enough to be cached.
+    bool admits(std::int64_t length) const;
+
+    // Returns the file cached under a key if it was validated less than `revalidate_after` ago, or
+    // null.
+    std::shared_ptr<const cached_file> find_fresh(const std::string& key);
+
+    // Returns the file cached under a key if it has the same "_id", "length" and "uploadDate" as
+    // `files_doc`, which is read from the server, and records that it was validated. A cached file
+    // which differs is removed, and null is returned.
+    std::shared_ptr<const cached_file> find_valid(const std::string& key,
+                                                  bsoncxx::document::view files_doc);
+
+    // Caches a file under a key, replacing any file cached under it, and returns it.
+    std::shared_ptr<const cached_file> insert(const std::string& key,
+                                              bsoncxx::document::value files_doc,
+                                              std::vector<bsoncxx::document::value> chunks);
+
+    // Removes the file cached under a key, if any.
+    void erase(const std::string& key);
+
+   private:
+    struct entry {
+        std::shared_ptr<const cached_file> file;
+        std::chrono::steady_clock::time_point validated;
+    };
+
+    using entry_list = std::list<std::pair<std::string, entry>>;
+
+    // Removes an entry. Must be called with `_mutex` held.
+    void remove(entry_list::iterator it);
+
+    const std::int64_t _budget;
+    const std::chrono::milliseconds _revalidate_after;
+
+    // Guards the members below.
+    std::mutex _mutex;
+
+    // The cached files, most recently used first, their index by key, and the bytes they hold.
+    entry_list _entries;
+    std::unordered_map<std::string, entry_list::iterator> _index;
+    std::int64_t _size;
+};
+
+}  // namespace gridfs
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -16,17 +16,53 @@
 
 #include <mongocxx/config/private/prelude.hh>
 
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <bsoncxx/stdx/make_unique.hpp>
 #include <bsoncxx/string/to_string.hpp>
+#include <mongocxx/gridfs/private/dedup.hh>
+#include <mongocxx/gridfs/private/digest.hh>
 #include <mongocxx/gridfs/uploader.hpp>
+#include <mongocxx/pool.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace gridfs {
 
+// The chunks and files documents of several files uploaded together, inserted with as few calls to
+// the server as possible.
+class upload_batch {
+   public:
+    upload_batch(const client_session* session, collection chunks, collection files);
+
+    // Adds the chunks of a file, inserting the batch once it is full.
+    void add_chunks(std::vector<bsoncxx::document::value>& chunks);
+
+    // Adds the files document of a file whose chunks have all been added, inserting the batch once
+    // it is full.
+    void add_file(bsoncxx::document::value file);
+
+    // Inserts the chunks of the batch, then its files documents, so that no files document is
+    // visible before its chunks.
+    void flush();
+
+   private:
+    const client_session* _session;
+    collection _chunks;
+    collection _files;
+    std::vector<bsoncxx::document::value> _chunk_documents;
+    std::vector<bsoncxx::document::value> _file_documents;
+    std::size_t _bytes;
+};
+
 class uploader::impl {
    public:
     impl(const client_session* session,
@@ -35,7 +71,13 @@ class uploader::impl {
          collection files,
          collection chunks,
          std::int32_t chunk_size,
-         stdx::optional<bsoncxx::document::value> metadata)
+         stdx::optional<bsoncxx::document::value> metadata,
+         pool* flush_pool,
+         stdx::string_view database_name,
+         stdx::optional<options::gridfs::upload::digest_algorithm> digest_algorithm,
+         options::gridfs::chunk_codec chunk_codec,
+         std::int32_t codec_level,
+         stdx::optional<collection> blobs)
         : session{session},
           buffer{stdx::make_unique<std::uint8_t[]>(static_cast<size_t>(chunk_size))},
           buffer_off{0},
@@ -46,7 +88,47 @@ class uploader::impl {
           filename{bsoncxx::string::to_string(filename)},
           files{std::move(files)},
           metadata{std::move(metadata)},
-          result{std::move(result)} {}
+          result{std::move(result)},
+          flush_pool{flush_pool},
+          database_name{bsoncxx::string::to_string(database_name)},
+          digest_algorithm{digest_algorithm},
+          codec_level{codec_level},
+          max_compressing{std::max(1u, std::thread::hardware_concurrency())},
+          blobs{std::move(blobs)},
+          stored_entries{0},
+          pending_bytes{0},
+          dedup_length{0},
+          batch{nullptr} {
+        if (digest_algorithm) {
+            digest.emplace(*digest_algorithm);
+        }
+
+        if (this->blobs) {
+            chunker.emplace(chunk_size);
+        }
+
+        if (chunk_codec != options::gridfs::chunk_codec::k_none) {
+            codec = chunk_codec;
+        }
+    }
+
+    // Inserts a batch of chunks with a client acquired from `flush_pool`. Runs on a background
+    // thread, one batch at a time.
+    void flush(std::vector<bsoncxx::document::value> batch);
+
+    // Waits for the batch of chunks being inserted in the background, if any, and records its
+    // error.
+    void wait_for_flush();
+
+    // Cuts the bytes written to a deduplicated file into chunks, as far as boundaries can be
+    // placed, or all of them at the end of the file.
+    void cut_chunks(bool final);
+
+    // Adds a chunk of a deduplicated file to its manifest and to the chunks waiting to be stored.
+    void add_blob(const std::uint8_t* data, std::size_t length);
+
+    // Stores the chunks of a deduplicated file waiting to be stored.
+    void store_pending_blobs();
 
     // Client session to use for upload operations.
     const client_session* session;
@@ -83,6 +165,61 @@ class uploader::impl {
 
     // Contains the id of the file being written.
     result::gridfs::upload result;
+
+    // The pool from which to acquire a client to insert chunks in the background, or null if
+    // chunks are inserted synchronously.
+    pool* flush_pool;
+
+    // The name of the database holding the chunks collection.
+    std::string database_name;
+
+    // The client acquired from `flush_pool` and the chunks collection through it. Only used by
+    // the batch in flight.
+    stdx::optional<pool::entry> flush_client;
+    stdx::optional<collection> flush_chunks;
+
+    // The algorithm with which to compute a digest of the file, and the digest of the bytes
+    // written so far.
+    stdx::optional<options::gridfs::upload::digest_algorithm> digest_algorithm;
+    stdx::optional<class digest> digest;
+
+    // The codec with which chunks are compressed, if any, and its level.
+    stdx::optional<options::gridfs::chunk_codec> codec;
+    std::int32_t codec_level;
+
+    // The chunks being compressed on worker threads, by chunk number, oldest first, and their
+    // maximum number.
+    std::deque<std::pair<std::int32_t, std::future<std::vector<std::uint8_t>>>> compressing;
+    std::size_t max_compressing;
+
+    // When the file is deduplicated, the blobs collection, the chunker cutting the file, and the
+    // bytes written but not yet cut into chunks.
+    stdx::optional<collection> blobs;
+    stdx::optional<dedup::chunker> chunker;
+    std::vector<std::uint8_t> dedup_buffer;
+
+    // The manifest of the chunks cut so far, and the number of its entries whose chunks have been
+    // stored.
+    std::vector<std::uint8_t> manifest;
+    std::size_t stored_entries;
+
+    // The chunks cut but not yet stored, and their total size.
+    std::vector<dedup::blob> pending_blobs;
+    std::size_t pending_bytes;
+
+    // The number of bytes written to a deduplicated file.
+    std::int64_t dedup_length;
+
+    // The batch to which the chunks and the files document are added when several files are
+    // uploaded together, or null if they are inserted by the uploader.
+    upload_batch* batch;
+
+    // The first error raised when inserting chunks in the background, reported by close().
+    std::exception_ptr flush_error;
+
+    // The batch of chunks being inserted in the background. Declared last so that destroying it
+    // waits for the insert before the members it uses are destroyed.
+    std::future<void> flush_in_flight;
 };
 
 }  // namespace gridfs
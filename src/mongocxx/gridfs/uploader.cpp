@@ -17,14 +17,21 @@
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <exception>
+#include <future>
 #include <limits>
+#include <utility>
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
 #include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/gridfs/private/codec.hh>
+#include <mongocxx/gridfs/private/dedup.hh>
+#include <mongocxx/gridfs/private/digest.hh>
 #include <mongocxx/gridfs/private/uploader.hh>
 #include <mongocxx/gridfs/uploader.hpp>
 
@@ -34,6 +41,16 @@ std::size_t chunks_collection_documents_max_length(std::size_t chunk_size) {
     // to the server has space for the other fields.
     return 16 * 1000 * 1000 / chunk_size;
 }
+
+// The chunks of a deduplicated file are stored in batches of about 16 MB, or of this many chunks.
+constexpr std::size_t k_dedup_batch_bytes = 16 * 1000 * 1000;
+constexpr std::size_t k_dedup_batch_chunks = 10000;
+
+// The largest manifest, which leaves room in the files document for the other fields.
+constexpr std::size_t k_max_manifest_size = 15 * 1000 * 1000;
+
+// The size of the documents gathered by an upload batch before it is inserted.
+constexpr std::size_t k_upload_batch_bytes = 16 * 1000 * 1000;
 }  // namespace
 
 namespace mongocxx {
@@ -46,7 +63,13 @@ uploader::uploader(const client_session* session,
                    collection files,
                    collection chunks,
                    std::int32_t chunk_size,
-                   stdx::optional<bsoncxx::document::view_or_value> metadata)
+                   stdx::optional<bsoncxx::document::view_or_value> metadata,
+                   pool* flush_pool,
+                   stdx::string_view database_name,
+                   stdx::optional<options::gridfs::upload::digest_algorithm> digest,
+                   options::gridfs::chunk_codec chunk_codec,
+                   std::int32_t codec_level,
+                   stdx::optional<collection> blobs)
     : _impl{stdx::make_unique<impl>(session,
                                     id,
                                     filename,
@@ -55,7 +78,13 @@ uploader::uploader(const client_session* session,
                                     chunk_size,
                                     metadata ? stdx::make_optional<bsoncxx::document::value>(
                                                    bsoncxx::document::value{metadata->view()})
-                                             : stdx::nullopt)} {}
+                                             : stdx::nullopt,
+                                    flush_pool,
+                                    database_name,
+                                    digest,
+                                    chunk_codec,
+                                    codec_level,
+                                    std::move(blobs))} {}
 
 uploader::uploader() noexcept = default;
 uploader::uploader(uploader&&) noexcept = default;
@@ -71,7 +100,29 @@ void uploader::write(const std::uint8_t* bytes, std::size_t length) {
         throw logic_error{error_code::k_gridfs_stream_not_open};
     }
 
+    if (_get_impl().digest) {
+        _get_impl().digest->update(bytes, length);
+    }
+
+    if (_get_impl().chunker) {
+        _get_impl().dedup_buffer.insert(_get_impl().dedup_buffer.end(), bytes, bytes + length);
+        _get_impl().dedup_length += static_cast<std::int64_t>(length);
+        _get_impl().cut_chunks(false);
+        return;
+    }
+
+    const auto chunk_size = static_cast<std::size_t>(_get_impl().chunk_size);
+
     while (length > 0) {
+        // Whole chunks are built straight from the caller's bytes rather than copied into the
+        // buffer first.
+        if (_get_impl().buffer_off == 0 && length >= chunk_size) {
+            append_chunk(bytes, chunk_size);
+            bytes = &bytes[chunk_size];
+            length -= chunk_size;
+            continue;
+        }
+
         std::size_t buffer_free_space =
             static_cast<std::size_t>(_get_impl().chunk_size) - _get_impl().buffer_off;
 
@@ -102,9 +153,23 @@ result::gridfs::upload uploader::close() {
                                   static_cast<std::int64_t>(_get_impl().chunk_size);
     std::int64_t leftover = static_cast<std::int64_t>(_get_impl().buffer_off);
 
+    if (_get_impl().chunker) {
+        _get_impl().cut_chunks(true);
+        _get_impl().store_pending_blobs();
+        bytes_uploaded = _get_impl().dedup_length;
+    }
+
     finish_chunk();
+    while (!_get_impl().compressing.empty()) {
+        collect_compressed_chunk();
+    }
     flush_chunks();
 
+    _get_impl().wait_for_flush();
+    if (_get_impl().flush_error) {
+        std::rethrow_exception(_get_impl().flush_error);
+    }
+
     file.append(kvp("_id", _get_impl().result.id()));
     file.append(kvp("length", bytes_uploaded + leftover));
     file.append(kvp("chunkSize", _get_impl().chunk_size));
@@ -115,7 +180,29 @@ result::gridfs::upload uploader::close() {
         file.append(kvp("metadata", *_get_impl().metadata));
     }
 
-    if (_get_impl().session) {
+    if (_get_impl().codec) {
+        file.append(kvp("codec", codec::name(*_get_impl().codec)));
+    }
+
+    // An empty file has no chunks to list.
+    if (!_get_impl().manifest.empty()) {
+        file.append(kvp("manifest",
+                        bsoncxx::types::b_binary{
+                            bsoncxx::binary_sub_type::k_binary,
+                            static_cast<std::uint32_t>(_get_impl().manifest.size()),
+                            _get_impl().manifest.data()}));
+    }
+
+    if (_get_impl().digest) {
+        _get_impl().result = result::gridfs::upload{_get_impl().result.id(),
+                                                    _get_impl().digest->finish()};
+        file.append(kvp(digest::field_name(*_get_impl().digest_algorithm),
+                        *_get_impl().result.digest()));
+    }
+
+    if (_get_impl().batch) {
+        _get_impl().batch->add_file(file.extract());
+    } else if (_get_impl().session) {
         _get_impl().files.insert_one(*_get_impl().session, file.extract());
     } else {
         _get_impl().files.insert_one(file.extract());
@@ -131,6 +218,21 @@ void uploader::abort() {
 
     _get_impl().closed = true;
 
+    // The chunks of a batch being inserted in the background must be on the server before they
+    // can be removed. Its error, if any, is moot, as are those of chunks being compressed.
+    _get_impl().wait_for_flush();
+    _get_impl().compressing.clear();
+
+    // The chunks of a deduplicated file may be shared with other files, so only the references
+    // which it added are removed.
+    if (_get_impl().blobs) {
+        dedup::release_blobs(*_get_impl().blobs,
+                             _get_impl().session,
+                             _get_impl().manifest.data(),
+                             _get_impl().stored_entries);
+        return;
+    }
+
     bsoncxx::builder::basic::document filter;
     filter.append(bsoncxx::builder::basic::kvp("files_id", _get_impl().result.id()));
 
@@ -146,28 +248,63 @@ std::int32_t uploader::chunk_size() const {
 }
 
 void uploader::finish_chunk() {
-    using bsoncxx::builder::basic::kvp;
-
     if (!_get_impl().buffer_off) {
         return;
     }
 
-    bsoncxx::builder::basic::document chunk;
-
-    std::size_t bytes_in_chunk = _get_impl().buffer_off;
+    append_chunk(_get_impl().buffer.get(), _get_impl().buffer_off);
 
-    chunk.append(kvp("files_id", _get_impl().result.id()));
-    chunk.append(kvp("n", _get_impl().chunks_written));
+    _get_impl().buffer_off = 0;
+}
 
+void uploader::append_chunk(const std::uint8_t* bytes, std::size_t bytes_in_chunk) {
     if (_get_impl().chunks_written == std::numeric_limits<std::int32_t>::max()) {
         throw gridfs_exception{error_code::k_gridfs_upload_requires_too_many_chunks};
     }
 
-    ++_get_impl().chunks_written;
+    const std::int32_t n = _get_impl().chunks_written++;
+
+    if (!_get_impl().codec) {
+        add_chunk_document(n, bytes, bytes_in_chunk);
+        return;
+    }
+
+    // Chunks are compressed on worker threads, several at a time, and added to the batch in order
+    // as they complete.
+    if (_get_impl().compressing.size() == _get_impl().max_compressing) {
+        collect_compressed_chunk();
+    }
+
+    const auto algorithm = *_get_impl().codec;
+    const auto level = _get_impl().codec_level;
+
+    _get_impl().compressing.emplace_back(
+        n,
+        std::async(std::launch::async,
+                   [algorithm, level](const std::vector<std::uint8_t>& input) {
+                       return codec::compress(algorithm, level, input.data(), input.size());
+                   },
+                   std::vector<std::uint8_t>(bytes, bytes + bytes_in_chunk)));
+}
+
+void uploader::collect_compressed_chunk() {
+    auto pending = std::move(_get_impl().compressing.front());
+    _get_impl().compressing.pop_front();
+
+    const auto compressed = pending.second.get();
+    add_chunk_document(pending.first, compressed.data(), compressed.size());
+}
 
-    bsoncxx::types::b_binary data{bsoncxx::binary_sub_type::k_binary,
-                                  static_cast<std::uint32_t>(bytes_in_chunk),
-                                  _get_impl().buffer.get()};
+void uploader::add_chunk_document(std::int32_t n, const std::uint8_t* bytes, std::size_t length) {
+    using bsoncxx::builder::basic::kvp;
+
+    bsoncxx::builder::basic::document chunk;
+
+    chunk.append(kvp("files_id", _get_impl().result.id()));
+    chunk.append(kvp("n", n));
+
+    bsoncxx::types::b_binary data{
+        bsoncxx::binary_sub_type::k_binary, static_cast<std::uint32_t>(length), bytes};
 
     chunk.append(kvp("data", data));
     _get_impl().chunks_collection_documents.push_back(chunk.extract());
@@ -178,8 +315,6 @@ void uploader::finish_chunk() {
         chunks_collection_documents_max_length(static_cast<std::size_t>(_get_impl().chunk_size))) {
         flush_chunks();
     }
-
-    _get_impl().buffer_off = 0;
 }
 
 void uploader::flush_chunks() {
@@ -187,6 +322,30 @@ void uploader::flush_chunks() {
         return;
     }
 
+    if (_get_impl().batch) {
+        _get_impl().batch->add_chunks(_get_impl().chunks_collection_documents);
+        _get_impl().chunks_collection_documents.clear();
+        return;
+    }
+
+    if (_get_impl().flush_pool) {
+        // Only one batch is in flight at a time: the next one is filled while it is inserted.
+        _get_impl().wait_for_flush();
+
+        // Once a batch has failed the file cannot be completed, so the remaining chunks are
+        // discarded and the error is reported by close().
+        if (!_get_impl().flush_error) {
+            _get_impl().flush_in_flight =
+                std::async(std::launch::async,
+                           &impl::flush,
+                           &_get_impl(),
+                           std::move(_get_impl().chunks_collection_documents));
+        }
+
+        _get_impl().chunks_collection_documents.clear();
+        return;
+    }
+
     if (_get_impl().session) {
         _get_impl().chunks.insert_many(*_get_impl().session,
                                        _get_impl().chunks_collection_documents);
@@ -197,6 +356,121 @@ void uploader::flush_chunks() {
     _get_impl().chunks_collection_documents.clear();
 }
 
+void uploader::impl::flush(std::vector<bsoncxx::document::value> batch) {
+    if (!flush_client) {
+        flush_client = flush_pool->acquire();
+        flush_chunks = (**flush_client)[database_name][chunks.name()];
+        flush_chunks->write_concern(chunks.write_concern());
+    }
+
+    flush_chunks->insert_many(batch);
+}
+
+void uploader::impl::wait_for_flush() {
+    if (!flush_in_flight.valid()) {
+        return;
+    }
+
+    try {
+        flush_in_flight.get();
+    } catch (...) {
+        if (!flush_error) {
+            flush_error = std::current_exception();
+        }
+    }
+}
+
+void uploader::impl::cut_chunks(bool final) {
+    std::size_t offset = 0;
+
+    // A boundary can only be placed once the longest chunk is buffered, as one found further on
+    // could be preferred.
+    while (offset < dedup_buffer.size() &&
+           (final || dedup_buffer.size() - offset >= chunker->max_size())) {
+        const auto length = chunker->cut(&dedup_buffer[offset], dedup_buffer.size() - offset);
+        add_blob(&dedup_buffer[offset], length);
+        offset += length;
+    }
+
+    dedup_buffer.erase(dedup_buffer.begin(),
+                       dedup_buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+void uploader::impl::add_blob(const std::uint8_t* data, std::size_t length) {
+    if (manifest.size() + dedup::k_entry_size > k_max_manifest_size) {
+        throw gridfs_exception{error_code::k_gridfs_upload_requires_too_many_chunks};
+    }
+
+    dedup::blob chunk;
+    digest::sha256(data, length, chunk.hash);
+    chunk.data.assign(data, data + length);
+
+    dedup::append_entry(manifest, chunk.hash, static_cast<std::uint32_t>(length));
+
+    pending_blobs.push_back(std::move(chunk));
+    pending_bytes += length;
+
+    if (pending_bytes >= k_dedup_batch_bytes || pending_blobs.size() >= k_dedup_batch_chunks) {
+        store_pending_blobs();
+    }
+}
+
+void uploader::impl::store_pending_blobs() {
+    dedup::store_blobs(*blobs, session, pending_blobs);
+
+    stored_entries += pending_blobs.size();
+    pending_blobs.clear();
+    pending_bytes = 0;
+}
+
+upload_batch::upload_batch(const client_session* session, collection chunks, collection files)
+    : _session{session}, _chunks{std::move(chunks)}, _files{std::move(files)}, _bytes{0} {}
+
+void upload_batch::add_chunks(std::vector<bsoncxx::document::value>& chunks) {
+    for (auto& chunk : chunks) {
+        _bytes += chunk.view().length();
+        _chunk_documents.push_back(std::move(chunk));
+    }
+
+    if (_bytes >= k_upload_batch_bytes) {
+        flush();
+    }
+}
+
+void upload_batch::add_file(bsoncxx::document::value file) {
+    _bytes += file.view().length();
+    _file_documents.push_back(std::move(file));
+
+    if (_bytes >= k_upload_batch_bytes) {
+        flush();
+    }
+}
+
+void upload_batch::flush() {
+    // Both lists are cleared even if an insert fails, as the batch cannot be retried.
+    auto chunk_documents = std::move(_chunk_documents);
+    auto file_documents = std::move(_file_documents);
+    _chunk_documents.clear();
+    _file_documents.clear();
+    _bytes = 0;
+
+    if (!chunk_documents.empty()) {
+        if (_session) {
+            _chunks.insert_many(*_session, chunk_documents);
+        } else {
+            _chunks.insert_many(chunk_documents);
+        }
+    }
+
+    if (!file_documents.empty()) {
+        if (_session) {
+            _files.insert_many(*_session, file_documents);
+        } else {
+            _files.insert_many(file_documents);
+        }
+    }
+}
+
 const uploader::impl& uploader::_get_impl() const {
     if (!_impl) {
         throw logic_error{error_code::k_invalid_gridfs_uploader_object};
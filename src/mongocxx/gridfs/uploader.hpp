@@ -27,11 +27,15 @@
 #include <bsoncxx/view_or_value.hpp>
 #include <mongocxx/client_session.hpp>
 #include <mongocxx/collection.hpp>
+#include <mongocxx/options/gridfs/upload.hpp>
 #include <mongocxx/result/gridfs/upload.hpp>
 #include <mongocxx/stdx.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
 namespace gridfs {
 
 ///
@@ -96,7 +100,8 @@ class MONGOCXX_API uploader {
     /// @throws mongocxx::logic_error if the upload stream was already closed.
     ///
     /// @throws mongocxx::bulk_write_exception
-    ///   if an error occurs when writing chunk data or file metadata to the database.
+    ///   if an error occurs when writing chunk data or file metadata to the database, including
+    ///   an error raised earlier when writing chunk data on a background thread.
     ///
     /// @throws mongocxx::gridfs_exception
     ///   if the uploader requires more than 2^31-1 chunks to store the file at the requested chunk
@@ -146,15 +151,46 @@ class MONGOCXX_API uploader {
     // @param metadata
     //   Optional metadata field of the files collection document.
     //
-    MONGOCXX_PRIVATE uploader(const client_session* session,
-                              bsoncxx::types::bson_value::view id,
-                              stdx::string_view filename,
-                              collection files,
-                              collection chunks,
-                              std::int32_t chunk_size,
-                              stdx::optional<bsoncxx::document::view_or_value> metadata = {});
+    // @param flush_pool
+    //   Optional pool from which to acquire a client to insert chunks on a background thread.
+    //
+    // @param database_name
+    //   The name of the database holding the bucket, used to insert chunks through `flush_pool`.
+    //
+    // @param digest
+    //   Optional algorithm with which to compute a digest of the file as it is written.
+    //
+    // @param chunk_codec
+    //   The codec with which to compress each chunk.
+    //
+    // @param codec_level
+    //   The compression level of `chunk_codec`.
+    //
+    // @param blobs
+    //   The blobs collection of the bucket, if the file is deduplicated rather than stored in
+    //   `chunks`.
+    //
+    MONGOCXX_PRIVATE uploader(
+        const client_session* session,
+        bsoncxx::types::bson_value::view id,
+        stdx::string_view filename,
+        collection files,
+        collection chunks,
+        std::int32_t chunk_size,
+        stdx::optional<bsoncxx::document::view_or_value> metadata = {},
+        pool* flush_pool = nullptr,
+        stdx::string_view database_name = {},
+        stdx::optional<options::gridfs::upload::digest_algorithm> digest = {},
+        options::gridfs::chunk_codec chunk_codec = options::gridfs::chunk_codec::k_none,
+        std::int32_t codec_level = 0,
+        stdx::optional<collection> blobs = {});
 
     MONGOCXX_PRIVATE void finish_chunk();
+    MONGOCXX_PRIVATE void append_chunk(const std::uint8_t* bytes, std::size_t length);
+    MONGOCXX_PRIVATE void collect_compressed_chunk();
+    MONGOCXX_PRIVATE void add_chunk_document(std::int32_t n,
+                                             const std::uint8_t* bytes,
+                                             std::size_t length);
     MONGOCXX_PRIVATE void flush_chunks();
 
     class MONGOCXX_PRIVATE impl;
@@ -0,0 +1,231 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <utility>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/id_loader.hpp>
+#include <mongocxx/private/id_loader.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+const std::int32_t k_default_max_batch_size = 100;
+const std::chrono::milliseconds k_default_max_delay{1};
+
+// Returns whether a projection excludes _id, in which case documents cannot be matched to
+// lookups.
+bool excludes_id(bsoncxx::document::view projection) {
+    const auto id = projection["_id"];
+    if (!id) {
+        return false;
+    }
+
+    switch (id.type()) {
+        case bsoncxx::type::k_bool:
+            return !id.get_bool().value;
+        case bsoncxx::type::k_int32:
+        case bsoncxx::type::k_int64:
+        case bsoncxx::type::k_double:
+            return bsoncxx::compare(id.get_value(),
+                                    bsoncxx::types::bson_value::view{
+                                        bsoncxx::types::b_int32{0}}) == 0;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+void id_loader::impl::run() {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    while (true) {
+        pending_changed.wait(lock, [&] { return stopping || !pending.empty(); });
+
+        if (pending.empty()) {
+            return;
+        }
+
+        pending_changed.wait_until(lock, first_queued + max_delay, [&] {
+            return stopping || flush_requested || pending.size() >= max_batch_size;
+        });
+
+        batch lookups;
+        if (pending.size() <= max_batch_size) {
+            lookups.swap(pending);
+            arrival.clear();
+            flush_requested = false;
+        } else {
+            // Backlogs larger than a batch are split, oldest ids first, so that no id waits behind
+            // later ones; the remainder is sent on the next iteration without waiting, since its
+            // first lookup has already waited.
+            for (std::size_t i = 0; i < max_batch_size; ++i) {
+                auto it = pending.find(arrival.front());
+                lookups.insert(std::move(*it));
+                pending.erase(it);
+                arrival.pop_front();
+            }
+        }
+
+        lock.unlock();
+        dispatch(std::move(lookups));
+        lock.lock();
+    }
+}
+
+void id_loader::impl::dispatch(batch lookups) {
+    try {
+        bsoncxx::builder::basic::array ids;
+        for (const auto& lookup : lookups) {
+            ids.append(lookup.first.view());
+        }
+
+        auto client = pool.acquire();
+        auto coll = (*client)[db_name][collection_name];
+        auto filter = make_document(kvp("_id", make_document(kvp("$in", ids.extract()))));
+        auto cursor = coll.find(filter.view(), find_options);
+
+        for (auto&& doc : cursor) {
+            const auto id = doc["_id"];
+            if (!id) {
+                continue;
+            }
+
+            auto it = lookups.find(bsoncxx::types::bson_value::value{id.get_value()});
+            if (it == lookups.end()) {
+                continue;
+            }
+
+            for (auto&& promise : it->second) {
+                promise.set_value(bsoncxx::document::value{doc});
+            }
+            lookups.erase(it);
+        }
+
+        for (auto&& lookup : lookups) {
+            for (auto&& promise : lookup.second) {
+                promise.set_value(stdx::nullopt);
+            }
+        }
+    } catch (...) {
+        // Only the lookups not yet resolved remain in the batch.
+        for (auto&& lookup : lookups) {
+            for (auto&& promise : lookup.second) {
+                promise.set_exception(std::current_exception());
+            }
+        }
+    }
+}
+
+id_loader::id_loader(pool& pool,
+                     bsoncxx::string::view_or_value db_name,
+                     bsoncxx::string::view_or_value collection_name,
+                     const options::id_loader& options) {
+    const auto max_batch_size = options.max_batch_size().value_or(k_default_max_batch_size);
+    if (max_batch_size <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for options::id_loader::max_batch_size()"};
+    }
+
+    const auto max_delay = options.max_delay().value_or(k_default_max_delay);
+    if (max_delay.count() < 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "non-negative value required for options::id_loader::max_delay()"};
+    }
+
+    const auto find_options = options.find_options().value_or(options::find{});
+    if (find_options.limit() || find_options.skip()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "skip and limit are reserved by id_loader"};
+    }
+    if (find_options.projection() && excludes_id(find_options.projection()->view())) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "the projection of an id_loader must not exclude _id"};
+    }
+
+    _impl = stdx::make_unique<impl>(pool,
+                                    db_name.terminated().data(),
+                                    collection_name.terminated().data(),
+                                    find_options,
+                                    static_cast<std::size_t>(max_batch_size),
+                                    max_delay);
+    _impl->dispatcher = std::thread{[this] { _impl->run(); }};
+}
+
+id_loader::~id_loader() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stopping = true;
+    }
+    _impl->pending_changed.notify_one();
+    _impl->dispatcher.join();
+}
+
+std::future<stdx::optional<bsoncxx::document::value>> id_loader::load(
+    bsoncxx::types::bson_value::view id) {
+    std::promise<stdx::optional<bsoncxx::document::value>> promise;
+    auto result = promise.get_future();
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+
+        if (_impl->pending.empty()) {
+            _impl->first_queued = std::chrono::steady_clock::now();
+        }
+
+        auto queued = _impl->pending.emplace(bsoncxx::types::bson_value::value{id},
+                                             impl::promises{});
+        if (queued.second) {
+            _impl->arrival.push_back(queued.first->first);
+        }
+        queued.first->second.push_back(std::move(promise));
+
+        // The dispatcher only needs waking to start timing a new batch or to send a full one.
+        notify = _impl->pending.size() == 1 || _impl->pending.size() >= _impl->max_batch_size;
+    }
+
+    if (notify) {
+        _impl->pending_changed.notify_one();
+    }
+
+    return result;
+}
+
+void id_loader::flush() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->flush_requested = true;
+    }
+    _impl->pending_changed.notify_one();
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
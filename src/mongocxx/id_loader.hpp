@@ -0,0 +1,106 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <future>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/options/id_loader.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+///
+/// Class batching lookups of single documents by `_id` into `$in` queries.
+///
+/// Each call to load() queues an id and returns a future. A background thread sends the queued
+/// ids as a single `find({_id: {$in: [...]}})` once the batch reaches its maximum size, once the
+/// first id of the batch has waited for the maximum delay, or when flush() is called, and then
+/// resolves every future with its document, or with a disengaged optional if no document has
+/// that id. Ids are matched as the server matches them, so numeric ids of different types but
+/// equal values resolve to the same document. If a query fails, every future of its batch holds
+/// the exception.
+///
+/// Each batch is queried with a client acquired from the pool for the duration of the query.
+/// An id_loader is thread-safe and is meant to be shared by all the threads serving a request.
+///
+class MONGOCXX_API id_loader {
+   public:
+    ///
+    /// Constructs an id_loader and starts its dispatching thread.
+    ///
+    /// @param pool
+    ///   The pool from which clients are acquired to run the batched queries. It must outlive the
+    ///   id_loader.
+    /// @param db_name
+    ///   The name of the database holding the collection.
+    /// @param collection_name
+    ///   The name of the collection to query.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::id_loader.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    ///
+    id_loader(pool& pool,
+              bsoncxx::string::view_or_value db_name,
+              bsoncxx::string::view_or_value collection_name,
+              const options::id_loader& options = {});
+
+    ///
+    /// Sends the lookups still queued, waits for them to complete and stops the dispatching
+    /// thread.
+    ///
+    ~id_loader();
+
+    id_loader(const id_loader&) = delete;
+    id_loader& operator=(const id_loader&) = delete;
+
+    ///
+    /// Queues the lookup of a document by `_id`.
+    ///
+    /// @param id
+    ///   The `_id` of the document, which is copied.
+    ///
+    /// @return
+    ///   A future holding the document, a disengaged optional if no document has that id, or the
+    ///   exception raised by the query.
+    ///
+    std::future<stdx::optional<bsoncxx::document::value>> load(
+        bsoncxx::types::bson_value::view id);
+
+    ///
+    /// Sends the queued lookups without waiting for the maximum delay. Does not wait for the
+    /// queries to complete.
+    ///
+    void flush();
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
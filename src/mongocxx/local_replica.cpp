@@ -0,0 +1,570 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+
+#include <bsoncxx/array/view.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/local_replica.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/parallel_scan.hpp>
+#include <mongocxx/private/local_replica.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::type;
+
+const std::int32_t k_default_snapshot_partitions = 4;
+
+// Bounds how long the applying thread takes to notice that the replica is being destroyed.
+const std::chrono::milliseconds k_watch_max_await_time{500};
+
+// How long the applying thread waits before retrying after a failure.
+const std::chrono::milliseconds k_watch_retry_delay{1000};
+
+// Looks up a dotted field path through documents and array indexes, returning an invalid element
+// if any component is missing.
+bsoncxx::document::element lookup_path(bsoncxx::document::view doc, stdx::string_view path) {
+    for (;;) {
+        const auto dot = path.find('.');
+        const auto element = doc[path.substr(0, dot)];
+
+        if (!element || dot == stdx::string_view::npos) {
+            return element;
+        }
+
+        if (element.type() == type::k_document) {
+            doc = element.get_document().value;
+        } else if (element.type() == type::k_array) {
+            doc = element.get_array().value;
+        } else {
+            return {};
+        }
+
+        path = path.substr(dot + 1);
+    }
+}
+
+// One field set or removed by an update, as reported in the update description of a change
+// event.
+struct field_change {
+    std::vector<std::string> path;
+
+    // The new value of the field, or a disengaged optional if the field was removed.
+    stdx::optional<bsoncxx::types::bson_value::view> value;
+};
+
+std::vector<std::string> split_path(stdx::string_view path) {
+    std::vector<std::string> components;
+    for (;;) {
+        const auto dot = path.find('.');
+        components.emplace_back(path.substr(0, dot).to_string());
+        if (dot == stdx::string_view::npos) {
+            return components;
+        }
+        path = path.substr(dot + 1);
+    }
+}
+
+void append_field(bsoncxx::builder::basic::document& builder,
+                  stdx::string_view key,
+                  const bsoncxx::document::value& sub,
+                  bool is_array) {
+    if (is_array) {
+        builder.append(kvp(key,
+                           bsoncxx::types::b_array{
+                               bsoncxx::array::view{sub.view().data(), sub.view().length()}}));
+    } else {
+        builder.append(kvp(key, bsoncxx::types::b_document{sub.view()}));
+    }
+}
+
+// Rebuilds a document, or an array, with the changes whose paths continue below the given depth.
+// New fields are appended after the existing ones. Returns a disengaged optional if the changes
+// cannot be applied locally: when they add or remove array elements, or descend into a scalar.
+stdx::optional<bsoncxx::document::value> apply_changes(
+    bsoncxx::document::view doc,
+    const std::vector<const field_change*>& changes,
+    std::size_t depth,
+    bool is_array) {
+    bsoncxx::builder::basic::document builder;
+    std::vector<bool> applied(changes.size(), false);
+
+    for (auto&& field : doc) {
+        const auto key = field.key();
+
+        stdx::optional<bsoncxx::types::bson_value::view> replacement;
+        bool removed = false;
+        std::vector<const field_change*> nested;
+
+        for (std::size_t i = 0; i < changes.size(); ++i) {
+            if (changes[i]->path[depth] != key) {
+                continue;
+            }
+
+            applied[i] = true;
+            if (changes[i]->path.size() == depth + 1) {
+                replacement = changes[i]->value;
+                removed = !changes[i]->value;
+            } else {
+                nested.push_back(changes[i]);
+            }
+        }
+
+        if (replacement) {
+            builder.append(kvp(key, *replacement));
+        } else if (removed) {
+            if (is_array) {
+                return stdx::nullopt;
+            }
+        } else if (nested.empty()) {
+            builder.append(kvp(key, field.get_value()));
+        } else if (field.type() == type::k_document || field.type() == type::k_array) {
+            const bool sub_is_array = field.type() == type::k_array;
+            const auto sub = apply_changes(sub_is_array
+                                               ? bsoncxx::document::view{field.get_array().value}
+                                               : field.get_document().value,
+                                           nested,
+                                           depth + 1,
+                                           sub_is_array);
+            if (!sub) {
+                return stdx::nullopt;
+            }
+            append_field(builder, key, *sub, sub_is_array);
+        } else {
+            return stdx::nullopt;
+        }
+    }
+
+    // The remaining changes are to fields the document lacks.
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        if (applied[i]) {
+            continue;
+        }
+
+        if (is_array) {
+            return stdx::nullopt;
+        }
+
+        const auto& key = changes[i]->path[depth];
+
+        stdx::optional<bsoncxx::types::bson_value::view> value;
+        std::vector<const field_change*> nested;
+
+        for (std::size_t j = i; j < changes.size(); ++j) {
+            if (applied[j] || changes[j]->path[depth] != key) {
+                continue;
+            }
+
+            applied[j] = true;
+            if (changes[j]->path.size() == depth + 1) {
+                value = changes[j]->value;
+            } else {
+                nested.push_back(changes[j]);
+            }
+        }
+
+        if (value) {
+            builder.append(kvp(key, *value));
+        } else if (!nested.empty()) {
+            const auto sub = apply_changes(bsoncxx::document::view{}, nested, depth + 1, false);
+            if (!sub) {
+                return stdx::nullopt;
+            }
+            append_field(builder, key, *sub, false);
+        }
+    }
+
+    return builder.extract();
+}
+
+// Applies the update description of a change event to a document, or returns a disengaged
+// optional if it cannot be applied locally.
+stdx::optional<bsoncxx::document::value> apply_update(bsoncxx::document::view doc,
+                                                      bsoncxx::document::view description) {
+    const auto truncated = description["truncatedArrays"];
+    if (truncated && truncated.type() == type::k_array &&
+        !truncated.get_array().value.empty()) {
+        return stdx::nullopt;
+    }
+
+    std::vector<field_change> changes;
+
+    const auto updated = description["updatedFields"];
+    if (updated && updated.type() == type::k_document) {
+        for (auto&& field : updated.get_document().value) {
+            changes.push_back(field_change{split_path(field.key()), field.get_value()});
+        }
+    }
+
+    const auto removed = description["removedFields"];
+    if (removed && removed.type() == type::k_array) {
+        for (auto&& field : removed.get_array().value) {
+            if (field.type() != type::k_string) {
+                return stdx::nullopt;
+            }
+            changes.push_back(field_change{split_path(field.get_string().value), stdx::nullopt});
+        }
+    }
+
+    std::vector<const field_change*> pointers;
+    for (const auto& change : changes) {
+        pointers.push_back(&change);
+    }
+
+    return apply_changes(doc, pointers, 0, false);
+}
+
+double as_double(const bsoncxx::types::bson_value::view& value) {
+    switch (value.type()) {
+        case type::k_int32:
+            return value.get_int32().value;
+        case type::k_int64:
+            return static_cast<double>(value.get_int64().value);
+        case type::k_decimal128:
+            return std::strtod(value.get_decimal128().value.to_string().c_str(), nullptr);
+        default:
+            return value.get_double().value;
+    }
+}
+
+}  // namespace
+
+std::size_t local_replica::impl::value_hash::operator()(
+    const bsoncxx::types::bson_value::value& value) const {
+    const auto view = value.view();
+
+    switch (view.type()) {
+        case type::k_double:
+        case type::k_int32:
+        case type::k_int64:
+        case type::k_decimal128: {
+            const double number = as_double(view);
+            return std::isnan(number) ? 0 : std::hash<double>{}(number);
+        }
+        case type::k_string:
+            return std::hash<std::string>{}(view.get_string().value.to_string());
+        case type::k_symbol:
+            return std::hash<std::string>{}(view.get_symbol().symbol.to_string());
+        case type::k_oid:
+            return std::hash<std::string>{}(view.get_oid().value.to_string());
+        case type::k_bool:
+            return std::hash<bool>{}(view.get_bool().value);
+        case type::k_date:
+            return std::hash<std::int64_t>{}(view.get_date().to_int64());
+        case type::k_document: {
+            // Field values may be numbers of different types, so only the keys are hashed.
+            std::size_t hash = 0;
+            for (auto&& field : view.get_document().value) {
+                hash = hash * 31 + std::hash<std::string>{}(field.key().to_string());
+            }
+            return hash;
+        }
+        default:
+            return std::hash<int>{}(static_cast<int>(view.type()));
+    }
+}
+
+void local_replica::impl::insert(contents& target, bsoncxx::document::value doc) const {
+    const auto id_element = doc.view()["_id"];
+    if (!id_element) {
+        return;
+    }
+
+    bsoncxx::types::bson_value::value id{id_element.get_value()};
+    remove(target, id);
+
+    for (std::size_t i = 0; i < index_fields.size(); ++i) {
+        const auto field = lookup_path(doc.view(), index_fields[i]);
+        if (field) {
+            target.indexes[i][bsoncxx::types::bson_value::value{field.get_value()}].insert(id);
+        }
+    }
+
+    target.documents.emplace(std::move(id), std::move(doc));
+}
+
+void local_replica::impl::remove(contents& target,
+                                 const bsoncxx::types::bson_value::value& id) const {
+    auto it = target.documents.find(id);
+    if (it == target.documents.end()) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < index_fields.size(); ++i) {
+        const auto field = lookup_path(it->second.view(), index_fields[i]);
+        if (!field) {
+            continue;
+        }
+
+        auto indexed = target.indexes[i].find(bsoncxx::types::bson_value::value{field.get_value()});
+        if (indexed != target.indexes[i].end()) {
+            indexed->second.erase(id);
+            if (indexed->second.empty()) {
+                target.indexes[i].erase(indexed);
+            }
+        }
+    }
+
+    target.documents.erase(it);
+}
+
+change_stream local_replica::impl::open_change_stream() {
+    options::change_stream options;
+    options.max_await_time(k_watch_max_await_time);
+
+    if (token) {
+        options.resume_after(token->view());
+    }
+
+    return (*watch_client)[db_name][collection_name].watch(options);
+}
+
+void local_replica::impl::synchronize() {
+    // The change stream is opened before the snapshot is read, so that every change made after
+    // the snapshot is observed. Changes made before it are applied again, which is harmless.
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        token = stdx::nullopt;
+    }
+    stream = open_change_stream();
+
+    contents snapshot;
+    snapshot.indexes.resize(index_fields.size());
+    std::mutex snapshot_mutex;
+
+    parallel_scan(pool,
+                  db_name,
+                  collection_name,
+                  {},
+                  snapshot_partitions,
+                  [&](std::int32_t, bsoncxx::document::view doc) {
+                      bsoncxx::document::value copy{doc};
+                      std::lock_guard<std::mutex> lock{snapshot_mutex};
+                      insert(snapshot, std::move(copy));
+                  });
+
+    std::lock_guard<std::mutex> lock{mutex};
+    current = std::move(snapshot);
+    save_resume_token();
+}
+
+void local_replica::impl::save_resume_token() {
+    const auto resume_token = stream->get_resume_token();
+    if (resume_token) {
+        token = bsoncxx::document::value{*resume_token};
+    }
+}
+
+bool local_replica::impl::apply(bsoncxx::document::view event) {
+    const auto operation_type = event["operationType"];
+    if (!operation_type || operation_type.type() != type::k_string) {
+        return false;
+    }
+    const auto operation = operation_type.get_string().value;
+
+    const auto id_element = event["documentKey"]["_id"];
+
+    if (operation == stdx::string_view{"insert"} || operation == stdx::string_view{"replace"}) {
+        const auto full_document = event["fullDocument"];
+        if (full_document && full_document.type() == type::k_document) {
+            bsoncxx::document::value doc{full_document.get_document().value};
+            std::lock_guard<std::mutex> lock{mutex};
+            insert(current, std::move(doc));
+        }
+    } else if (operation == stdx::string_view{"update"} && id_element) {
+        bsoncxx::types::bson_value::value id{id_element.get_value()};
+
+        // The applying thread is the only writer of the contents, so it reads them without the
+        // lock.
+        stdx::optional<bsoncxx::document::value> updated;
+        const auto existing = current.documents.find(id);
+        const auto description = event["updateDescription"];
+        if (existing != current.documents.end() && description &&
+            description.type() == type::k_document) {
+            updated = apply_update(existing->second.view(), description.get_document().value);
+        }
+
+        if (updated) {
+            std::lock_guard<std::mutex> lock{mutex};
+            insert(current, std::move(*updated));
+        } else {
+            refresh(id);
+        }
+    } else if (operation == stdx::string_view{"delete"} && id_element) {
+        bsoncxx::types::bson_value::value id{id_element.get_value()};
+        std::lock_guard<std::mutex> lock{mutex};
+        remove(current, id);
+    } else if (operation == stdx::string_view{"invalidate"}) {
+        return true;
+    }
+
+    return false;
+}
+
+void local_replica::impl::refresh(const bsoncxx::types::bson_value::value& id) {
+    auto doc =
+        (*watch_client)[db_name][collection_name].find_one(make_document(kvp("_id", id.view())));
+
+    std::lock_guard<std::mutex> lock{mutex};
+    if (doc) {
+        insert(current, std::move(*doc));
+    } else {
+        remove(current, id);
+    }
+}
+
+void local_replica::impl::run() {
+    bool resynchronize = false;
+
+    while (true) {
+        try {
+            if (resynchronize) {
+                synchronize();
+                resynchronize = false;
+            } else if (!stream) {
+                stream = open_change_stream();
+            }
+
+            for (auto&& event : *stream) {
+                resynchronize = apply(event);
+
+                std::lock_guard<std::mutex> lock{mutex};
+                if (resynchronize || stopping) {
+                    break;
+                }
+                save_resume_token();
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            if (stopping) {
+                return;
+            }
+            if (!resynchronize) {
+                // An empty batch may still advance the resume token.
+                save_resume_token();
+            }
+        } catch (const mongocxx::exception&) {
+            // The change stream is resumed from the last token applied. If it could not be reopened
+            // from that token, or a synchronization failed, the copy is synchronized again.
+            resynchronize = resynchronize || !stream;
+            stream = stdx::nullopt;
+
+            std::unique_lock<std::mutex> lock{mutex};
+            if (stopping_changed.wait_for(lock, k_watch_retry_delay, [&] { return stopping; })) {
+                return;
+            }
+        }
+    }
+}
+
+local_replica::local_replica(pool& pool,
+                             bsoncxx::string::view_or_value db_name,
+                             bsoncxx::string::view_or_value collection_name,
+                             const options::local_replica& options) {
+    const auto snapshot_partitions =
+        options.snapshot_partitions().value_or(k_default_snapshot_partitions);
+    if (snapshot_partitions <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::local_replica::snapshot_partitions()"};
+    }
+
+    _impl = stdx::make_unique<impl>(pool,
+                                    db_name.terminated().data(),
+                                    collection_name.terminated().data(),
+                                    options.indexes().value_or(std::vector<std::string>{}),
+                                    snapshot_partitions);
+    _impl->synchronize();
+
+    _impl->applier = std::thread{[this] { _impl->run(); }};
+}
+
+local_replica::~local_replica() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stopping = true;
+    }
+    _impl->stopping_changed.notify_all();
+    _impl->applier.join();
+}
+
+stdx::optional<bsoncxx::document::value> local_replica::find(
+    bsoncxx::types::bson_value::view id) const {
+    const bsoncxx::types::bson_value::value key{id};
+
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    const auto it = _impl->current.documents.find(key);
+    if (it == _impl->current.documents.end()) {
+        return stdx::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<bsoncxx::document::value> local_replica::find_by(
+    stdx::string_view field, bsoncxx::types::bson_value::view value) const {
+    std::size_t index = 0;
+    while (index < _impl->index_fields.size() && _impl->index_fields[index] != field) {
+        ++index;
+    }
+    if (index == _impl->index_fields.size()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "the field is not indexed by the local_replica"};
+    }
+
+    const bsoncxx::types::bson_value::value key{value};
+    std::vector<bsoncxx::document::value> results;
+
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    const auto ids = _impl->current.indexes[index].find(key);
+    if (ids == _impl->current.indexes[index].end()) {
+        return results;
+    }
+
+    for (const auto& id : ids->second) {
+        results.push_back(_impl->current.documents.at(id));
+    }
+    return results;
+}
+
+std::size_t local_replica::size() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    return _impl->current.documents.size();
+}
+
+stdx::optional<bsoncxx::document::value> local_replica::resume_token() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    return _impl->token;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
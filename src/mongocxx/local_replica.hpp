@@ -0,0 +1,132 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/stdx/string_view.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/options/local_replica.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+///
+/// Class maintaining an in-memory copy of a small or medium collection, so that its documents can
+/// be read without a round trip to the server.
+///
+/// On construction a change stream is opened on the collection and a snapshot of the collection
+/// is then loaded with mongocxx::parallel_scan. A background thread applies the change events to
+/// the copy: inserted and replaced documents are stored as they are, updates are applied from
+/// their update description, and deleted documents are removed. Events which happened before the
+/// snapshot was read are applied again, which converges to the state of the collection. An
+/// update which cannot be applied locally, for example because it truncated an array, is
+/// resolved by reading the document from the server.
+///
+/// If the change stream fails it is resumed from the token of the last event applied. If it
+/// cannot be resumed, or the collection is dropped or renamed, the copy is loaded again from a
+/// new snapshot.
+///
+/// A local_replica is thread-safe. Its reads reflect the events applied so far, and so lag the
+/// collection by the latency of the change stream.
+///
+class MONGOCXX_API local_replica {
+   public:
+    ///
+    /// Constructs a local_replica, loads its initial snapshot and starts the thread applying
+    /// change events.
+    ///
+    /// @param pool
+    ///   The pool from which clients are acquired. It must outlive the local_replica.
+    /// @param db_name
+    ///   The name of the database holding the collection.
+    /// @param collection_name
+    ///   The name of the collection to copy.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::local_replica.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    /// @throws mongocxx::operation_exception if the change stream cannot be opened or the snapshot
+    ///   cannot be read.
+    ///
+    local_replica(pool& pool,
+                  bsoncxx::string::view_or_value db_name,
+                  bsoncxx::string::view_or_value collection_name,
+                  const options::local_replica& options = {});
+
+    ///
+    /// Stops the thread applying change events and destroys the copy.
+    ///
+    ~local_replica();
+
+    local_replica(const local_replica&) = delete;
+    local_replica& operator=(const local_replica&) = delete;
+
+    ///
+    /// Finds a document by `_id`.
+    ///
+    /// @param id
+    ///   The `_id` of the document. Numeric ids of different types but equal values are
+    ///   considered equal, as the server does.
+    ///
+    /// @return A copy of the document, or a disengaged optional if there is none with that id.
+    ///
+    stdx::optional<bsoncxx::document::value> find(bsoncxx::types::bson_value::view id) const;
+
+    ///
+    /// Finds the documents whose indexed field holds a value. Documents lacking the field are not
+    /// indexed, and arrays are indexed as a whole rather than by element.
+    ///
+    /// @param field
+    ///   The name of a field passed to mongocxx::options::local_replica::indexes.
+    /// @param value
+    ///   The value of the field.
+    ///
+    /// @return Copies of the matching documents, in no particular order.
+    ///
+    /// @throws mongocxx::logic_error if the field is not indexed.
+    ///
+    std::vector<bsoncxx::document::value> find_by(stdx::string_view field,
+                                                  bsoncxx::types::bson_value::view value) const;
+
+    ///
+    /// Returns the number of documents in the copy.
+    ///
+    std::size_t size() const;
+
+    ///
+    /// Returns the resume token of the last change event applied, if any.
+    ///
+    stdx::optional<bsoncxx::document::value> resume_token() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,135 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/merged_cursor.hpp>
+#include <mongocxx/private/merged_cursor.hh>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+// Orders the heap of cursor indexes so that its front is the cursor holding the next document,
+// breaking ties by the position of the cursors.
+struct heap_order {
+    bool operator()(std::size_t lhs, std::size_t rhs) const {
+        int result = comparator->compare(*(*positions)[lhs], *(*positions)[rhs]);
+        return result != 0 ? result > 0 : lhs > rhs;
+    }
+
+    const std::vector<cursor::iterator>* positions;
+    const bsoncxx::sort_comparator* comparator;
+};
+
+}  // namespace
+
+merged_cursor::merged_cursor(std::vector<cursor> cursors, bsoncxx::document::view_or_value sort) {
+    try {
+        _impl = stdx::make_unique<impl>(std::move(cursors), bsoncxx::sort_comparator{sort});
+    } catch (const bsoncxx::exception&) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "merged_cursor sort keys must be ascending (1) or descending (-1)"};
+    }
+}
+
+merged_cursor::merged_cursor(merged_cursor&&) noexcept = default;
+merged_cursor& merged_cursor::operator=(merged_cursor&&) noexcept = default;
+
+merged_cursor::~merged_cursor() = default;
+
+merged_cursor::iterator merged_cursor::begin() {
+    if (!_impl->started) {
+        _impl->started = true;
+
+        // Fetch the first batch of every cursor up front, so the merge only waits on the cursors
+        // whose batches run out.
+        _impl->positions.reserve(_impl->cursors.size());
+        for (auto&& cursor : _impl->cursors) {
+            _impl->positions.push_back(cursor.begin());
+        }
+
+        for (std::size_t i = 0; i < _impl->positions.size(); ++i) {
+            if (_impl->positions[i] != _impl->cursors[i].end()) {
+                _impl->heap.push_back(i);
+            }
+        }
+
+        heap_order order{&_impl->positions, &_impl->comparator};
+        std::make_heap(_impl->heap.begin(), _impl->heap.end(), order);
+    }
+
+    return iterator(this);
+}
+
+merged_cursor::iterator merged_cursor::end() {
+    return iterator(nullptr);
+}
+
+void merged_cursor::iterator::operator++(int) {
+    operator++();
+}
+
+merged_cursor::iterator& merged_cursor::iterator::operator++() {
+    auto& impl = *_cursor->_impl;
+    heap_order order{&impl.positions, &impl.comparator};
+
+    std::pop_heap(impl.heap.begin(), impl.heap.end(), order);
+    std::size_t index = impl.heap.back();
+    impl.heap.pop_back();
+
+    if (++impl.positions[index] != impl.cursors[index].end()) {
+        impl.heap.push_back(index);
+        std::push_heap(impl.heap.begin(), impl.heap.end(), order);
+    }
+
+    return *this;
+}
+
+merged_cursor::iterator::iterator(merged_cursor* cursor) : _cursor(cursor) {}
+
+bool merged_cursor::iterator::is_exhausted() const {
+    return !_cursor || _cursor->_impl->heap.empty();
+}
+
+const bsoncxx::document::view& merged_cursor::iterator::operator*() const {
+    auto& impl = *_cursor->_impl;
+    return *impl.positions[impl.heap.front()];
+}
+
+const bsoncxx::document::view* merged_cursor::iterator::operator->() const {
+    return &operator*();
+}
+
+bool MONGOCXX_CALL operator==(const merged_cursor::iterator& lhs,
+                              const merged_cursor::iterator& rhs) {
+    return ((rhs.is_exhausted() && lhs.is_exhausted()) || (lhs._cursor == rhs._cursor));
+}
+
+bool MONGOCXX_CALL operator!=(const merged_cursor::iterator& lhs,
+                              const merged_cursor::iterator& rhs) {
+    return !(lhs == rhs);
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
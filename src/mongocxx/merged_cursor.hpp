@@ -0,0 +1,166 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <mongocxx/cursor.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class that merges the results of several cursors, each sorted by the same sort specification,
+/// into a single stream of documents in sort order.
+///
+/// The documents are ordered using MongoDB's comparison rules: values of different BSON types are
+/// ordered by their canonical type order, numbers compare by value regardless of their type, a
+/// missing field sorts as null, and an array sorts by its smallest element in an ascending sort
+/// and by its largest element in a descending sort. Documents that compare equal are returned in
+/// the order of the cursors they come from.
+///
+class MONGOCXX_API merged_cursor {
+   public:
+    class MONGOCXX_API iterator;
+
+    ///
+    /// Creates a merged cursor.
+    ///
+    /// @param cursors
+    ///   The cursors to merge. Each must return its documents sorted by @p sort.
+    /// @param sort
+    ///   The sort specification shared by every cursor, of the form `{<field>: <1 or -1>, ...}`.
+    ///
+    /// @throws mongocxx::logic_error if the sort specification is invalid.
+    ///
+    merged_cursor(std::vector<cursor> cursors, bsoncxx::document::view_or_value sort);
+
+    ///
+    /// Move constructs a merged cursor.
+    ///
+    merged_cursor(merged_cursor&&) noexcept;
+
+    ///
+    /// Move assigns a merged cursor.
+    ///
+    merged_cursor& operator=(merged_cursor&&) noexcept;
+
+    ///
+    /// Destroys a merged cursor.
+    ///
+    ~merged_cursor();
+
+    ///
+    /// A merged_cursor::iterator that points to the first remaining document. The first call to
+    /// begin() fetches the first batch of every cursor before returning.
+    ///
+    /// @return the merged_cursor::iterator
+    ///
+    /// @throws mongocxx::query_exception if a query failed
+    ///
+    iterator begin();
+
+    ///
+    /// A merged_cursor::iterator indicating that every cursor is exhausted.
+    ///
+    /// @return the merged_cursor::iterator
+    ///
+    iterator end();
+
+   private:
+    friend class merged_cursor::iterator;
+
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+///
+/// Class representing an input iterator of documents in a mongocxx::merged_cursor.
+///
+/// As with a mongocxx::cursor::iterator, all non-end iterators derived from the same merged
+/// cursor move in lock-step, and the document pointed to is only valid until the iterator is
+/// incremented.
+///
+class MONGOCXX_API merged_cursor::iterator {
+   public:
+    ///
+    /// std::iterator_traits
+    ///
+    using value_type = bsoncxx::document::view;
+    using reference = bsoncxx::document::view&;
+    using pointer = bsoncxx::document::view*;
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+
+    ///
+    /// Dereferences the view for the document currently being pointed to.
+    ///
+    const bsoncxx::document::view& operator*() const;
+
+    ///
+    /// Accesses a member of the dereferenced document currently being pointed to.
+    ///
+    const bsoncxx::document::view* operator->() const;
+
+    ///
+    /// Pre-increments the iterator to move to the next document.
+    ///
+    /// @throws mongocxx::query_exception if a query failed
+    ///
+    iterator& operator++();
+
+    ///
+    /// Post-increments the iterator to move to the next document.
+    ///
+    /// @throws mongocxx::query_exception if a query failed
+    ///
+    void operator++(int);
+
+   private:
+    friend class merged_cursor;
+
+    ///
+    /// @{
+    ///
+    /// Compare two iterators for (in)-equality.  Iterators compare equal if
+    /// they point to the same underlying merged cursor or if both are exhausted.
+    ///
+    /// @relates iterator
+    ///
+    friend MONGOCXX_API bool MONGOCXX_CALL operator==(const iterator&, const iterator&);
+    friend MONGOCXX_API bool MONGOCXX_CALL operator!=(const iterator&, const iterator&);
+    ///
+    /// @}
+    ///
+
+    MONGOCXX_PRIVATE bool is_exhausted() const;
+
+    MONGOCXX_PRIVATE explicit iterator(merged_cursor* cursor);
+
+    // If this pointer is null, the iterator is considered "past-the-end".
+    merged_cursor* _cursor;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -30,6 +30,9 @@
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class request_coalescer;
+
 namespace options {
 
 ///
@@ -255,6 +258,8 @@ class MONGOCXX_API aggregate {
    private:
     friend class ::mongocxx::database;
     friend class ::mongocxx::collection;
+    friend class ::mongocxx::prepared_aggregate;
+    friend class ::mongocxx::request_coalescer;
 
     void append(bsoncxx::builder::basic::document& builder) const;
 
@@ -0,0 +1,46 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/change_stream_checkpointer.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+change_stream_checkpointer& change_stream_checkpointer::commit_interval(
+    std::chrono::milliseconds commit_interval) {
+    _commit_interval = commit_interval;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& change_stream_checkpointer::commit_interval()
+    const {
+    return _commit_interval;
+}
+
+change_stream_checkpointer& change_stream_checkpointer::write_concern(
+    class write_concern write_concern) {
+    _write_concern = std::move(write_concern);
+    return *this;
+}
+
+const stdx::optional<class write_concern>& change_stream_checkpointer::write_concern() const {
+    return _write_concern;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
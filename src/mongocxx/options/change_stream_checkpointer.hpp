@@ -0,0 +1,83 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+#include <mongocxx/write_concern.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::change_stream_checkpointer.
+///
+class MONGOCXX_API change_stream_checkpointer {
+   public:
+    ///
+    /// Sets how often the latest acknowledged resume token is persisted. Every acknowledgement
+    /// received within an interval is covered by a single write. Defaults to 1 second.
+    ///
+    /// @param commit_interval
+    ///   The time between two writes. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_checkpointer& commit_interval(std::chrono::milliseconds commit_interval);
+
+    ///
+    /// Gets how often the latest acknowledged resume token is persisted.
+    ///
+    /// @return The time between two writes.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& commit_interval() const;
+
+    ///
+    /// Sets the write concern of the upserts persisting checkpoints to a collection. Defaults to
+    /// the write concern of the collection. Ignored by checkpointers writing to a file.
+    ///
+    /// @param write_concern
+    ///   The write concern of the upserts.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_checkpointer& write_concern(class write_concern write_concern);
+
+    ///
+    /// Gets the write concern of the upserts persisting checkpoints to a collection.
+    ///
+    /// @return The write concern of the upserts.
+    ///
+    const stdx::optional<class write_concern>& write_concern() const;
+
+   private:
+    stdx::optional<std::chrono::milliseconds> _commit_interval;
+    stdx::optional<class write_concern> _write_concern;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,53 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/change_stream_dispatcher.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+change_stream_dispatcher& change_stream_dispatcher::workers(std::int32_t workers) {
+    _workers = workers;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& change_stream_dispatcher::workers() const {
+    return _workers;
+}
+
+change_stream_dispatcher& change_stream_dispatcher::max_queued_events(
+    std::int32_t max_queued_events) {
+    _max_queued_events = max_queued_events;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& change_stream_dispatcher::max_queued_events() const {
+    return _max_queued_events;
+}
+
+change_stream_dispatcher& change_stream_dispatcher::max_wait(std::chrono::milliseconds max_wait) {
+    _max_wait = max_wait;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& change_stream_dispatcher::max_wait() const {
+    return _max_wait;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
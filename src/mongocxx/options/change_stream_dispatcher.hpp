@@ -0,0 +1,104 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::change_stream_dispatcher.
+///
+class MONGOCXX_API change_stream_dispatcher {
+   public:
+    ///
+    /// Sets the number of worker threads running the handler. Defaults to 4.
+    ///
+    /// @param workers
+    ///   The number of worker threads. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& workers(std::int32_t workers);
+
+    ///
+    /// Gets the number of worker threads running the handler.
+    ///
+    /// @return The number of worker threads.
+    ///
+    const stdx::optional<std::int32_t>& workers() const;
+
+    ///
+    /// Sets the maximum number of notifications queued for each worker. The dispatcher stops
+    /// reading the change stream while the queue of the worker owning the next notification is
+    /// full. Defaults to 1000.
+    ///
+    /// @param max_queued_events
+    ///   The maximum number of notifications queued for a worker. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& max_queued_events(std::int32_t max_queued_events);
+
+    ///
+    /// Gets the maximum number of notifications queued for each worker.
+    ///
+    /// @return The maximum number of notifications queued for a worker.
+    ///
+    const stdx::optional<std::int32_t>& max_queued_events() const;
+
+    ///
+    /// Sets how long the dispatcher collects notifications from the change stream before handing
+    /// them to the workers, see mongocxx::change_stream::next_batch. Defaults to 100 milliseconds.
+    ///
+    /// @param max_wait
+    ///   The time after which collected notifications are dispatched. Must not be negative.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_dispatcher& max_wait(std::chrono::milliseconds max_wait);
+
+    ///
+    /// Gets how long the dispatcher collects notifications before handing them to the workers.
+    ///
+    /// @return The time after which collected notifications are dispatched.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& max_wait() const;
+
+   private:
+    stdx::optional<std::int32_t> _workers;
+    stdx::optional<std::int32_t> _max_queued_events;
+    stdx::optional<std::chrono::milliseconds> _max_wait;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,104 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::change_stream_prefetcher.
+///
+class MONGOCXX_API change_stream_prefetcher {
+   public:
+    ///
+    /// Sets the maximum number of notifications in a batch. Defaults to 1000.
+    ///
+    /// @param max_batch_size
+    ///   The maximum number of notifications in a batch. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_prefetcher& max_batch_size(std::int32_t max_batch_size);
+
+    ///
+    /// Gets the maximum number of notifications in a batch.
+    ///
+    /// @return The maximum number of notifications in a batch.
+    ///
+    const stdx::optional<std::int32_t>& max_batch_size() const;
+
+    ///
+    /// Sets how long the prefetching thread collects notifications into a batch before queueing
+    /// it, see mongocxx::change_stream::next_batch. Defaults to 100 milliseconds.
+    ///
+    /// @param max_wait
+    ///   The time after which a batch is queued. Must not be negative.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_prefetcher& max_wait(std::chrono::milliseconds max_wait);
+
+    ///
+    /// Gets how long the prefetching thread collects notifications into a batch.
+    ///
+    /// @return The time after which a batch is queued.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& max_wait() const;
+
+    ///
+    /// Sets the maximum number of batches fetched ahead of the consumer. The prefetching thread
+    /// stops requesting notifications while the queue is full, so this bounds the memory held by
+    /// the prefetcher. Defaults to 2.
+    ///
+    /// @param max_queued_batches
+    ///   The maximum number of queued batches. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    change_stream_prefetcher& max_queued_batches(std::int32_t max_queued_batches);
+
+    ///
+    /// Gets the maximum number of batches fetched ahead of the consumer.
+    ///
+    /// @return The maximum number of queued batches.
+    ///
+    const stdx::optional<std::int32_t>& max_queued_batches() const;
+
+   private:
+    stdx::optional<std::int32_t> _max_batch_size;
+    stdx::optional<std::chrono::milliseconds> _max_wait;
+    stdx::optional<std::int32_t> _max_queued_batches;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
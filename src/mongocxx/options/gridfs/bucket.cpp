@@ -44,6 +44,15 @@ const stdx::optional<std::int32_t>& bucket::chunk_size_bytes() const {
     return _chunk_size_bytes;
 }
 
+bucket& bucket::adaptive_chunk_size(bool adaptive_chunk_size) {
+    _adaptive_chunk_size = adaptive_chunk_size;
+    return *this;
+}
+
+const stdx::optional<bool>& bucket::adaptive_chunk_size() const {
+    return _adaptive_chunk_size;
+}
+
 bucket& bucket::read_concern(class read_concern read_concern) {
     _read_concern = read_concern;
     return *this;
@@ -71,6 +80,51 @@ const stdx::optional<class write_concern>& bucket::write_concern() const {
     return _write_concern;
 }
 
+bucket& bucket::codec(chunk_codec codec) {
+    _codec = codec;
+    return *this;
+}
+
+const stdx::optional<chunk_codec>& bucket::codec() const {
+    return _codec;
+}
+
+bucket& bucket::codec_level(std::int32_t codec_level) {
+    _codec_level = codec_level;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& bucket::codec_level() const {
+    return _codec_level;
+}
+
+bucket& bucket::deduplicate(bool deduplicate) {
+    _deduplicate = deduplicate;
+    return *this;
+}
+
+const stdx::optional<bool>& bucket::deduplicate() const {
+    return _deduplicate;
+}
+
+bucket& bucket::cache_bytes(std::int64_t cache_bytes) {
+    _cache_bytes = cache_bytes;
+    return *this;
+}
+
+const stdx::optional<std::int64_t>& bucket::cache_bytes() const {
+    return _cache_bytes;
+}
+
+bucket& bucket::cache_revalidate_after(std::chrono::milliseconds cache_revalidate_after) {
+    _cache_revalidate_after = cache_revalidate_after;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& bucket::cache_revalidate_after() const {
+    return _cache_revalidate_after;
+}
+
 }  // namespace gridfs
 }  // namespace options
 MONGOCXX_INLINE_NAMESPACE_END
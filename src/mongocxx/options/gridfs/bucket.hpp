@@ -16,9 +16,11 @@
 
 #include <mongocxx/config/prelude.hpp>
 
+#include <chrono>
 #include <string>
 
 #include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/options/gridfs/chunk_codec.hpp>
 #include <mongocxx/read_concern.hpp>
 #include <mongocxx/read_preference.hpp>
 #include <mongocxx/stdx.hpp>
@@ -75,6 +77,34 @@ class MONGOCXX_API bucket {
     ///
     const stdx::optional<std::int32_t>& chunk_size_bytes() const;
 
+    ///
+    /// Sets whether uploads whose length is known up front pick a larger chunk size for large
+    /// files. Defaults to false.
+    ///
+    /// The length is known for gridfs::bucket::upload_from_file(), gridfs::bucket::upload_many(),
+    /// and gridfs::bucket::upload_from_stream() when the stream is seekable. Such a file is then
+    /// stored in about 1024 chunks, with a chunk size which is a multiple of 256 KiB, at least
+    /// chunk_size_bytes() and at most 15 MiB, so that large files take fewer chunk documents and
+    /// fewer round trips. An explicit options::gridfs::upload::chunk_size_bytes() takes precedence,
+    /// and deduplicated files keep chunk_size_bytes() as their average chunk size.
+    ///
+    /// @param adaptive_chunk_size
+    ///   Whether the chunk size adapts to the length of the file.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    bucket& adaptive_chunk_size(bool adaptive_chunk_size);
+
+    ///
+    /// Gets whether the chunk size adapts to the length of the file.
+    ///
+    /// @return
+    ///   Whether the chunk size adapts to the length of the file.
+    ///
+    const stdx::optional<bool>& adaptive_chunk_size() const;
+
     ///
     /// Sets the read concern to be used when reading from the bucket. Defaults to the read
     /// concern of the database containing the bucket's collections.
@@ -144,12 +174,157 @@ class MONGOCXX_API bucket {
     ///
     const stdx::optional<class write_concern>& write_concern() const;
 
+    ///
+    /// Sets the codec with which to compress each chunk of the files uploaded to the bucket, unless
+    /// overridden by options::gridfs::upload::codec(). Chunks are compressed on worker threads as
+    /// they are completed, and decompressed transparently when the file is read; the length and
+    /// chunk size recorded in the files document remain those of the uncompressed file.
+    ///
+    /// @param codec
+    ///   The chunk codec.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error, when the upload is opened, if the driver was built without
+    ///   support for the codec.
+    ///
+    bucket& codec(chunk_codec codec);
+
+    ///
+    /// Gets the chunk codec.
+    ///
+    /// @return
+    ///   The chunk codec.
+    ///
+    const stdx::optional<chunk_codec>& codec() const;
+
+    ///
+    /// Sets the compression level of the chunk codec. Defaults to 3 for zstd and 1 for LZ4, where
+    /// levels above 1 select LZ4 HC.
+    ///
+    /// @param codec_level
+    ///   The compression level.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    bucket& codec_level(std::int32_t codec_level);
+
+    ///
+    /// Gets the compression level of the chunk codec.
+    ///
+    /// @return
+    ///   The compression level.
+    ///
+    const stdx::optional<std::int32_t>& codec_level() const;
+
+    ///
+    /// Sets whether files uploaded through the bucket are deduplicated. Defaults to false.
+    ///
+    /// A deduplicated file is cut into chunks at content-defined boundaries, so that an insertion
+    /// or removal only changes the chunks around it, with chunk_size_bytes() as the average size of
+    /// a chunk. Each chunk is stored once, under its SHA-256, in the bucket's blobs collection
+    /// along with the number of files referring to it, and only the chunks which the server does
+    /// not hold yet are sent. The files document lists the chunks of the file in its "manifest"
+    /// field. Deduplicated files are read like any other file, but must be deleted through a bucket
+    /// which deduplicates, so that the chunks which are no longer referred to are removed.
+    ///
+    /// The chunks of a deduplicated file are neither compressed nor inserted through
+    /// options::gridfs::upload::flush_pool().
+    ///
+    /// @param deduplicate
+    ///   Whether files are deduplicated.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error, when the bucket is created, if a chunk codec is also set.
+    ///
+    bucket& deduplicate(bool deduplicate);
+
+    ///
+    /// Gets whether files uploaded through the bucket are deduplicated.
+    ///
+    /// @return
+    ///   Whether files are deduplicated.
+    ///
+    const stdx::optional<bool>& deduplicate() const;
+
+    ///
+    /// Sets the number of bytes which the bucket may hold in memory to cache the files it reads.
+    /// By default, files are not cached.
+    ///
+    /// A file read through a caching bucket is fetched whole and kept, with its files document, so
+    /// that later downloads of the file are served from memory: the chunks returned by
+    /// gridfs::downloader::next_chunk() then point into buffers shared by every download of the
+    /// file rather than copies. The least recently used files are evicted once the budget is
+    /// exceeded, and files longer than a quarter of the budget are not cached. Copies of the bucket
+    /// share its cache.
+    ///
+    /// A cached file is only served after its files document has been read again and found to have
+    /// the same "_id", "length" and "uploadDate", unless it was checked less than
+    /// cache_revalidate_after() ago.
+    ///
+    /// @param cache_bytes
+    ///   The maximum number of bytes held by the cache.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error, when the bucket is created, if the value is not positive.
+    ///
+    bucket& cache_bytes(std::int64_t cache_bytes);
+
+    ///
+    /// Gets the number of bytes which the bucket may hold in memory to cache the files it reads.
+    ///
+    /// @return
+    ///   The maximum number of bytes held by the cache.
+    ///
+    const stdx::optional<std::int64_t>& cache_bytes() const;
+
+    ///
+    /// Sets how long a cached file is served without reading its files document again. Defaults to
+    /// zero, in which case the files document is read on every download. Within this time, a file
+    /// which was replaced or deleted through another bucket may still be served from the cache;
+    /// files deleted through the bucket itself are removed from its cache immediately.
+    ///
+    /// @param cache_revalidate_after
+    ///   The time after which a cached file is checked again.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error, when the bucket is created, if the value is negative.
+    ///
+    bucket& cache_revalidate_after(std::chrono::milliseconds cache_revalidate_after);
+
+    ///
+    /// Gets how long a cached file is served without reading its files document again.
+    ///
+    /// @return
+    ///   The time after which a cached file is checked again.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& cache_revalidate_after() const;
+
    private:
     stdx::optional<std::string> _bucket_name;
     stdx::optional<std::int32_t> _chunk_size_bytes;
+    stdx::optional<bool> _adaptive_chunk_size;
     stdx::optional<class read_concern> _read_concern;
     stdx::optional<class read_preference> _read_preference;
     stdx::optional<class write_concern> _write_concern;
+    stdx::optional<chunk_codec> _codec;
+    stdx::optional<std::int32_t> _codec_level;
+    stdx::optional<bool> _deduplicate;
+    stdx::optional<std::int64_t> _cache_bytes;
+    stdx::optional<std::chrono::milliseconds> _cache_revalidate_after;
 };
 
 }  // namespace gridfs
@@ -0,0 +1,45 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+namespace gridfs {
+
+///
+/// Enum representing the codec with which the chunks of a GridFS file are compressed. The codec is
+/// recorded in the "codec" field of the files document, and files written with a codec can only be
+/// read by drivers which support it.
+///
+enum class chunk_codec : std::uint8_t {
+    /// Store chunks uncompressed.
+    k_none,
+    /// Compress chunks with zstd. Requires the driver to be built with MONGOCXX_ENABLE_ZSTD.
+    k_zstd,
+    /// Compress chunks with LZ4. Requires the driver to be built with MONGOCXX_ENABLE_LZ4.
+    k_lz4,
+};
+
+}  // namespace gridfs
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
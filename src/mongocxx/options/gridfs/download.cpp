@@ -0,0 +1,81 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/gridfs/download.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+namespace gridfs {
+
+download& download::fetch_pool(mongocxx::pool* pool) {
+    _fetch_pool = pool;
+    return *this;
+}
+
+const stdx::optional<mongocxx::pool*>& download::fetch_pool() const {
+    return _fetch_pool;
+}
+
+download& download::workers(std::int32_t workers) {
+    _workers = workers;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& download::workers() const {
+    return _workers;
+}
+
+download& download::window_chunks(std::int32_t window_chunks) {
+    _window_chunks = window_chunks;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& download::window_chunks() const {
+    return _window_chunks;
+}
+
+download& download::cached_chunks(std::int32_t cached_chunks) {
+    _cached_chunks = cached_chunks;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& download::cached_chunks() const {
+    return _cached_chunks;
+}
+
+download& download::on_progress(std::function<void(std::int64_t, std::int64_t)> progress) {
+    _progress = std::move(progress);
+    return *this;
+}
+
+const std::function<void(std::int64_t, std::int64_t)>& download::progress() const {
+    return _progress;
+}
+
+download& download::verify_digest(bool verify_digest) {
+    _verify_digest = verify_digest;
+    return *this;
+}
+
+const stdx::optional<bool>& download::verify_digest() const {
+    return _verify_digest;
+}
+
+}  // namespace gridfs
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
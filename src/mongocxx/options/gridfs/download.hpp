@@ -0,0 +1,190 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <functional>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+namespace options {
+namespace gridfs {
+
+///
+/// Class representing the optional arguments to a MongoDB GridFS download operation.
+///
+class MONGOCXX_API download {
+   public:
+    ///
+    /// Sets a pool from which the downloader acquires clients to fetch the chunks of the file
+    /// concurrently. The chunks are split into windows of consecutive chunks, each fetched with its
+    /// own query by one of several background threads, and reassembled in order as the file is
+    /// read. Without a pool, the chunks are fetched with a single query as they are read.
+    ///
+    /// The pool must connect to the same deployment as the bucket and must outlive the downloader.
+    /// It may not be used together with a client session.
+    ///
+    /// @param pool
+    ///   The pool to acquire clients from.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& fetch_pool(pool* pool);
+
+    ///
+    /// Gets the pool used to fetch chunks concurrently.
+    ///
+    /// @return
+    ///   An optional pointer to the pool.
+    ///
+    const stdx::optional<pool*>& fetch_pool() const;
+
+    ///
+    /// Sets the number of windows fetched concurrently when a fetch pool is set, which is also the
+    /// number of windows that may be fetched ahead of the one being read. Defaults to 4.
+    ///
+    /// @param workers
+    ///   The number of background threads, each of which acquires a client from the pool.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& workers(std::int32_t workers);
+
+    ///
+    /// Gets the number of windows fetched concurrently.
+    ///
+    /// @return
+    ///   The number of background threads.
+    ///
+    const stdx::optional<std::int32_t>& workers() const;
+
+    ///
+    /// Sets the number of chunks in each window when a fetch pool is set. Defaults to the number of
+    /// chunks that fit in 16 MB, and at least one.
+    ///
+    /// @param window_chunks
+    ///   The number of consecutive chunks fetched by a single query.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& window_chunks(std::int32_t window_chunks);
+
+    ///
+    /// Gets the number of chunks in each window.
+    ///
+    /// @return
+    ///   The number of consecutive chunks fetched by a single query.
+    ///
+    const stdx::optional<std::int32_t>& window_chunks() const;
+
+    ///
+    /// Sets the number of chunks which the downloader keeps in memory after seeking away from them,
+    /// so that seeking back to them does not query the chunks again. Defaults to 4. Zero disables
+    /// the cache.
+    ///
+    /// @param cached_chunks
+    ///   The maximum number of chunks kept, least recently used first to be dropped.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& cached_chunks(std::int32_t cached_chunks);
+
+    ///
+    /// Gets the number of chunks kept in memory after seeking away from them.
+    ///
+    /// @return
+    ///   The maximum number of chunks kept.
+    ///
+    const stdx::optional<std::int32_t>& cached_chunks() const;
+
+    ///
+    /// Sets the callback reporting the progress of bucket::download_to_file and
+    /// bucket::download_to_fd. It is called after each chunk has been written, or after each
+    /// window of chunks when download_to_file is used with a fetch pool, with the number of bytes
+    /// written so far and the length of the file.
+    ///
+    /// @param progress
+    ///   The progress callback.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    download& on_progress(std::function<void(std::int64_t, std::int64_t)> progress);
+
+    ///
+    /// Retrieves the progress callback.
+    ///
+    /// @return The progress callback.
+    ///
+    const std::function<void(std::int64_t, std::int64_t)>& progress() const;
+
+    ///
+    /// Sets whether the downloader verifies the digest recorded in the files document, if any,
+    /// as the file is read. The digest is computed chunk by chunk as the chunks are fetched, and
+    /// a mismatch is reported when the last chunk is fetched, before its bytes are returned.
+    /// Verification is abandoned if the downloader seeks past a chunk it has not read. Defaults to
+    /// false.
+    ///
+    /// @param verify_digest
+    ///   Whether to verify the digest of the file.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @see options::gridfs::upload::digest()
+    ///
+    download& verify_digest(bool verify_digest);
+
+    ///
+    /// Gets whether the downloader verifies the digest of the file.
+    ///
+    /// @return
+    ///   Whether to verify the digest of the file.
+    ///
+    const stdx::optional<bool>& verify_digest() const;
+
+   private:
+    stdx::optional<pool*> _fetch_pool;
+    stdx::optional<std::int32_t> _workers;
+    stdx::optional<std::int32_t> _window_chunks;
+    stdx::optional<std::int32_t> _cached_chunks;
+    std::function<void(std::int64_t, std::int64_t)> _progress;
+    stdx::optional<bool> _verify_digest;
+};
+
+}  // namespace gridfs
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -40,6 +40,51 @@ const stdx::optional<bsoncxx::document::view_or_value>& upload::metadata() const
     return _metadata;
 }
 
+upload& upload::flush_pool(mongocxx::pool* pool) {
+    _flush_pool = pool;
+    return *this;
+}
+
+const stdx::optional<mongocxx::pool*>& upload::flush_pool() const {
+    return _flush_pool;
+}
+
+upload& upload::on_progress(std::function<void(std::int64_t, std::int64_t)> progress) {
+    _progress = std::move(progress);
+    return *this;
+}
+
+const std::function<void(std::int64_t, std::int64_t)>& upload::progress() const {
+    return _progress;
+}
+
+upload& upload::digest(digest_algorithm digest) {
+    _digest = digest;
+    return *this;
+}
+
+const stdx::optional<upload::digest_algorithm>& upload::digest() const {
+    return _digest;
+}
+
+upload& upload::codec(chunk_codec codec) {
+    _codec = codec;
+    return *this;
+}
+
+const stdx::optional<chunk_codec>& upload::codec() const {
+    return _codec;
+}
+
+upload& upload::codec_level(std::int32_t codec_level) {
+    _codec_level = codec_level;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& upload::codec_level() const {
+    return _codec_level;
+}
+
 }  // namespace gridfs
 }  // namespace options
 MONGOCXX_INLINE_NAMESPACE_END
@@ -16,12 +16,19 @@
 
 #include <mongocxx/config/prelude.hpp>
 
+#include <cstdint>
+#include <functional>
+
 #include <bsoncxx/document/view_or_value.hpp>
 #include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/options/gridfs/chunk_codec.hpp>
 #include <mongocxx/stdx.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
 namespace options {
 namespace gridfs {
 
@@ -72,9 +79,153 @@ class MONGOCXX_API upload {
     ///
     const stdx::optional<bsoncxx::document::view_or_value>& metadata() const;
 
+    ///
+    /// Sets a pool from which the uploader acquires a client to send batches of chunks on a
+    /// background thread. While one batch is being inserted, the next one is filled by
+    /// uploader::write, so reading from the source overlaps with writing to the server. Errors
+    /// raised when inserting a batch are reported by uploader::close.
+    ///
+    /// The pool must connect to the same deployment as the bucket and must outlive the uploader.
+    /// It may not be used together with a client session.
+    ///
+    /// @param pool
+    ///   The pool to acquire a client from.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& flush_pool(pool* pool);
+
+    ///
+    /// Gets the pool used to send batches of chunks on a background thread.
+    ///
+    /// @return
+    ///   An optional pointer to the pool.
+    ///
+    const stdx::optional<pool*>& flush_pool() const;
+
+    ///
+    /// Sets the callback reporting the progress of bucket::upload_from_file. It is called
+    /// after each slice of the file has been handed to the uploader, with the number of bytes
+    /// uploaded so far and the length of the file. bucket::upload_many calls it after each file,
+    /// with the bytes of all of its files.
+    ///
+    /// @param progress
+    ///   The progress callback.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& on_progress(std::function<void(std::int64_t, std::int64_t)> progress);
+
+    ///
+    /// Retrieves the progress callback.
+    ///
+    /// @return The progress callback.
+    ///
+    const std::function<void(std::int64_t, std::int64_t)>& progress() const;
+
+    ///
+    /// The algorithms with which a digest of the file can be computed while it is uploaded.
+    ///
+    enum class digest_algorithm : std::uint8_t {
+        ///
+        /// SHA-256, stored in the "sha256" field of the files document.
+        ///
+        k_sha256,
+
+        ///
+        /// xxHash64 with a seed of 0, stored in the "xxhash64" field of the files document.
+        ///
+        k_xxhash64,
+
+        ///
+        /// CRC32C, stored in the "crc32c" field of the files document. It is computed with the
+        /// CRC32 instruction on x86-64 CPUs supporting SSE 4.2 and on ARMv8 builds with the CRC
+        /// extension.
+        ///
+        k_crc32c
+    };
+
+    ///
+    /// Sets the algorithm with which to compute a digest of the file as its bytes are written
+    /// to the uploader. The digest is stored, as a lowercase hex string, in the files document
+    /// and returned in result::gridfs::upload. By default no digest is computed.
+    ///
+    /// @param digest
+    ///   The digest algorithm.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& digest(digest_algorithm digest);
+
+    ///
+    /// Gets the algorithm with which to compute a digest of the file.
+    ///
+    /// @return The digest algorithm.
+    ///
+    const stdx::optional<digest_algorithm>& digest() const;
+
+    ///
+    /// Sets the codec with which to compress each chunk of the file. Defaults to the codec of the
+    /// bucket; chunk_codec::k_none stores the chunks of this file uncompressed. Chunks are
+    /// compressed on worker threads as they are completed, and decompressed transparently when the
+    /// file is read; the length and chunk size recorded in the files document remain those of the
+    /// uncompressed file.
+    ///
+    /// @param codec
+    ///   The chunk codec.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error, when the upload is opened, if the driver was built without
+    ///   support for the codec.
+    ///
+    upload& codec(chunk_codec codec);
+
+    ///
+    /// Gets the chunk codec.
+    ///
+    /// @return
+    ///   The chunk codec.
+    ///
+    const stdx::optional<chunk_codec>& codec() const;
+
+    ///
+    /// Sets the compression level of the chunk codec. Defaults to 3 for zstd and 1 for LZ4, where
+    /// levels above 1 select LZ4 HC.
+    ///
+    /// @param codec_level
+    ///   The compression level.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called. This facilitates
+    ///   method chaining.
+    ///
+    upload& codec_level(std::int32_t codec_level);
+
+    ///
+    /// Gets the compression level of the chunk codec.
+    ///
+    /// @return
+    ///   The compression level.
+    ///
+    const stdx::optional<std::int32_t>& codec_level() const;
+
    private:
     stdx::optional<std::int32_t> _chunk_size_bytes;
     stdx::optional<bsoncxx::document::view_or_value> _metadata;
+    stdx::optional<pool*> _flush_pool;
+    std::function<void(std::int64_t, std::int64_t)> _progress;
+    stdx::optional<digest_algorithm> _digest;
+    stdx::optional<chunk_codec> _codec;
+    stdx::optional<std::int32_t> _codec_level;
 };
 
 }  // namespace gridfs
@@ -0,0 +1,52 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/id_loader.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+id_loader& id_loader::max_batch_size(std::int32_t max_batch_size) {
+    _max_batch_size = max_batch_size;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& id_loader::max_batch_size() const {
+    return _max_batch_size;
+}
+
+id_loader& id_loader::max_delay(std::chrono::milliseconds max_delay) {
+    _max_delay = max_delay;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& id_loader::max_delay() const {
+    return _max_delay;
+}
+
+id_loader& id_loader::find_options(find find_options) {
+    _find_options = std::move(find_options);
+    return *this;
+}
+
+const stdx::optional<find>& id_loader::find_options() const {
+    return _find_options;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
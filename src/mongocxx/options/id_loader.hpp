@@ -0,0 +1,106 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::id_loader.
+///
+class MONGOCXX_API id_loader {
+   public:
+    ///
+    /// Sets the maximum number of distinct ids looked up by a single query. A batch is sent as
+    /// soon as it reaches this size, and larger backlogs are split. Defaults to 100.
+    ///
+    /// @param max_batch_size
+    ///   The maximum number of ids in the `$in` list of a query. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    id_loader& max_batch_size(std::int32_t max_batch_size);
+
+    ///
+    /// Gets the maximum number of distinct ids looked up by a single query.
+    ///
+    /// @return The maximum batch size.
+    ///
+    const stdx::optional<std::int32_t>& max_batch_size() const;
+
+    ///
+    /// Sets how long the first lookup of a batch waits for further lookups to join it before the
+    /// batch is sent. Defaults to 1 millisecond.
+    ///
+    /// @param max_delay
+    ///   The maximum delay. Must not be negative.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    id_loader& max_delay(std::chrono::milliseconds max_delay);
+
+    ///
+    /// Gets how long the first lookup of a batch waits for further lookups to join it.
+    ///
+    /// @return The maximum delay.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& max_delay() const;
+
+    ///
+    /// Sets the options used for each batched query, for example a projection or a read
+    /// preference. The limit and skip options must not be set, and the projection must not
+    /// exclude `_id`, which is used to match documents to lookups.
+    ///
+    /// @param find_options
+    ///   The options for each batched query.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    id_loader& find_options(find find_options);
+
+    ///
+    /// Gets the options used for each batched query.
+    ///
+    /// @return The options for each batched query.
+    ///
+    const stdx::optional<find>& find_options() const;
+
+   private:
+    stdx::optional<std::int32_t> _max_batch_size;
+    stdx::optional<std::chrono::milliseconds> _max_delay;
+    stdx::optional<find> _find_options;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
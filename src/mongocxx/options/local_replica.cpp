@@ -0,0 +1,43 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/local_replica.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+local_replica& local_replica::indexes(std::vector<std::string> fields) {
+    _indexes = std::move(fields);
+    return *this;
+}
+
+const stdx::optional<std::vector<std::string>>& local_replica::indexes() const {
+    return _indexes;
+}
+
+local_replica& local_replica::snapshot_partitions(std::int32_t snapshot_partitions) {
+    _snapshot_partitions = snapshot_partitions;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& local_replica::snapshot_partitions() const {
+    return _snapshot_partitions;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
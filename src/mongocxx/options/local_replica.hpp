@@ -0,0 +1,86 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::local_replica.
+///
+class MONGOCXX_API local_replica {
+   public:
+    ///
+    /// Sets the fields on which hash indexes are maintained, so that documents can be found by
+    /// the value of those fields with mongocxx::local_replica::find_by. Dotted paths are
+    /// permitted. Defaults to no indexes.
+    ///
+    /// @param fields
+    ///   The names of the indexed fields.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    local_replica& indexes(std::vector<std::string> fields);
+
+    ///
+    /// Gets the fields on which hash indexes are maintained.
+    ///
+    /// @return The names of the indexed fields.
+    ///
+    const stdx::optional<std::vector<std::string>>& indexes() const;
+
+    ///
+    /// Sets the number of partitions of the collection scanned concurrently to load the initial
+    /// snapshot, see mongocxx::parallel_scan. Defaults to 4.
+    ///
+    /// @param snapshot_partitions
+    ///   The number of partitions. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    local_replica& snapshot_partitions(std::int32_t snapshot_partitions);
+
+    ///
+    /// Gets the number of partitions of the collection scanned concurrently to load the initial
+    /// snapshot.
+    ///
+    /// @return The number of partitions.
+    ///
+    const stdx::optional<std::int32_t>& snapshot_partitions() const;
+
+   private:
+    stdx::optional<std::vector<std::string>> _indexes;
+    stdx::optional<std::int32_t> _snapshot_partitions;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,52 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/parallel_scan.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+parallel_scan& parallel_scan::key(bsoncxx::string::view_or_value key) {
+    _key = std::move(key);
+    return *this;
+}
+
+const stdx::optional<bsoncxx::string::view_or_value>& parallel_scan::key() const {
+    return _key;
+}
+
+parallel_scan& parallel_scan::samples_per_partition(std::int32_t samples_per_partition) {
+    _samples_per_partition = samples_per_partition;
+    return *this;
+}
+
+const stdx::optional<std::int32_t>& parallel_scan::samples_per_partition() const {
+    return _samples_per_partition;
+}
+
+parallel_scan& parallel_scan::find_options(find find_options) {
+    _find_options = std::move(find_options);
+    return *this;
+}
+
+const stdx::optional<find>& parallel_scan::find_options() const {
+    return _find_options;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,109 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to mongocxx::parallel_scan.
+///
+class MONGOCXX_API parallel_scan {
+   public:
+    ///
+    /// Sets the field used to split the collection into partitions. The field must be the sole
+    /// field of an ascending index on the collection, since each partition is scanned using
+    /// index bounds on that index. Defaults to "_id".
+    ///
+    /// @param key
+    ///   The name of the indexed field. Dotted paths are permitted.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    parallel_scan& key(bsoncxx::string::view_or_value key);
+
+    ///
+    /// Gets the field used to split the collection into partitions.
+    ///
+    /// @return The name of the indexed field.
+    ///
+    const stdx::optional<bsoncxx::string::view_or_value>& key() const;
+
+    ///
+    /// Sets the number of documents sampled per partition to compute the partition boundaries.
+    /// Larger values produce more evenly sized partitions at the cost of a more expensive
+    /// sampling query. Defaults to 64.
+    ///
+    /// @param samples_per_partition
+    ///   The number of sampled documents per requested partition.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    parallel_scan& samples_per_partition(std::int32_t samples_per_partition);
+
+    ///
+    /// Gets the number of documents sampled per partition.
+    ///
+    /// @return The number of sampled documents per requested partition.
+    ///
+    const stdx::optional<std::int32_t>& samples_per_partition() const;
+
+    ///
+    /// Sets the options used for the query run against each partition, for example a projection
+    /// or a batch size. The hint, min, max, sort, skip and limit options are reserved for the
+    /// partitioning and must not be set.
+    ///
+    /// @param find_options
+    ///   The options for each partition's query.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    parallel_scan& find_options(find find_options);
+
+    ///
+    /// Gets the options used for the query run against each partition.
+    ///
+    /// @return The options for each partition's query.
+    ///
+    const stdx::optional<find>& find_options() const;
+
+   private:
+    stdx::optional<bsoncxx::string::view_or_value> _key;
+    stdx::optional<std::int32_t> _samples_per_partition;
+    stdx::optional<find> _find_options;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,124 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/hint.hpp>
+#include <mongocxx/options/find.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+// Builds the options document passed to mongoc_collection_find_with_opts. The read preference and
+// max await time are applied separately, since libmongoc takes them outside the options document.
+inline bsoncxx::builder::basic::document build_find_options_document(const find& options) {
+    using bsoncxx::builder::basic::kvp;
+
+    bsoncxx::builder::basic::document options_builder;
+
+    if (options.allow_disk_use()) {
+        options_builder.append(kvp("allowDiskUse", *options.allow_disk_use()));
+    }
+
+    if (options.allow_partial_results()) {
+        options_builder.append(kvp("allowPartialResults", *options.allow_partial_results()));
+    }
+
+    if (options.batch_size()) {
+        options_builder.append(kvp("batchSize", *options.batch_size()));
+    }
+
+    if (options.collation()) {
+        options_builder.append(kvp("collation", *options.collation()));
+    }
+
+    if (options.comment()) {
+        options_builder.append(kvp("comment", *options.comment()));
+    }
+
+    if (options.cursor_type()) {
+        if (*options.cursor_type() == cursor::type::k_tailable) {
+            options_builder.append(kvp("tailable", bsoncxx::types::b_bool{true}));
+        } else if (*options.cursor_type() == cursor::type::k_tailable_await) {
+            options_builder.append(kvp("tailable", bsoncxx::types::b_bool{true}));
+            options_builder.append(kvp("awaitData", bsoncxx::types::b_bool{true}));
+        } else if (*options.cursor_type() == cursor::type::k_non_tailable) {
+        } else {
+            throw logic_error{error_code::k_invalid_parameter};
+        }
+    }
+
+    if (options.hint()) {
+        options_builder.append(kvp("hint", options.hint()->to_value()));
+    }
+
+    if (options.limit()) {
+        options_builder.append(kvp("limit", *options.limit()));
+    }
+
+    if (options.max()) {
+        options_builder.append(kvp("max", *options.max()));
+    }
+
+    if (options.max_time()) {
+        options_builder.append(
+            kvp("maxTimeMS", bsoncxx::types::b_int64{options.max_time()->count()}));
+    }
+
+    if (options.min()) {
+        options_builder.append(kvp("min", *options.min()));
+    }
+
+    if (options.no_cursor_timeout()) {
+        options_builder.append(kvp("noCursorTimeout", *options.no_cursor_timeout()));
+    }
+
+    if (options.projection()) {
+        options_builder.append(
+            kvp("projection", bsoncxx::types::b_document{*options.projection()}));
+    }
+
+    if (options.return_key()) {
+        options_builder.append(kvp("returnKey", *options.return_key()));
+    }
+
+    if (options.show_record_id()) {
+        options_builder.append(kvp("showRecordId", *options.show_record_id()));
+    }
+
+    if (options.skip()) {
+        options_builder.append(kvp("skip", *options.skip()));
+    }
+
+    if (options.sort()) {
+        options_builder.append(kvp("sort", bsoncxx::types::b_document{*options.sort()}));
+    }
+
+    return options_builder;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
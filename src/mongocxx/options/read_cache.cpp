@@ -0,0 +1,43 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <mongocxx/options/read_cache.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+read_cache& read_cache::max_bytes(std::int64_t max_bytes) {
+    _max_bytes = max_bytes;
+    return *this;
+}
+
+const stdx::optional<std::int64_t>& read_cache::max_bytes() const {
+    return _max_bytes;
+}
+
+read_cache& read_cache::ttl(std::chrono::milliseconds ttl) {
+    _ttl = ttl;
+    return *this;
+}
+
+const stdx::optional<std::chrono::milliseconds>& read_cache::ttl() const {
+    return _ttl;
+}
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,85 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+namespace options {
+
+///
+/// Class representing the optional arguments to a mongocxx::read_cache.
+///
+class MONGOCXX_API read_cache {
+   public:
+    ///
+    /// Sets the approximate number of bytes the cache may hold, counting its keys, the cached
+    /// documents and a fixed overhead per entry. The least recently used entries are evicted
+    /// beyond this budget. Defaults to 64 MiB.
+    ///
+    /// @param max_bytes
+    ///   The byte budget. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    read_cache& max_bytes(std::int64_t max_bytes);
+
+    ///
+    /// Gets the approximate number of bytes the cache may hold.
+    ///
+    /// @return The byte budget.
+    ///
+    const stdx::optional<std::int64_t>& max_bytes() const;
+
+    ///
+    /// Sets how long an entry may be served after it was read from the server. Entries are also
+    /// evicted when a change to their document is observed, so this only bounds staleness should
+    /// change notifications be delayed. Defaults to 60 seconds.
+    ///
+    /// @param ttl
+    ///   The time to live of an entry. Must be positive.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    read_cache& ttl(std::chrono::milliseconds ttl);
+
+    ///
+    /// Gets how long an entry may be served after it was read from the server.
+    ///
+    /// @return The time to live of an entry.
+    ///
+    const stdx::optional<std::chrono::milliseconds>& ttl() const;
+
+   private:
+    stdx::optional<std::int64_t> _max_bytes;
+    stdx::optional<std::chrono::milliseconds> _ttl;
+};
+
+}  // namespace options
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
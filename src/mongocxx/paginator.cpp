@@ -0,0 +1,382 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/concatenate.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/paginator.hpp>
+#include <mongocxx/private/paginator.hh>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::basic::sub_array;
+using bsoncxx::builder::basic::sub_document;
+
+// Looks up a dotted field path, returning an invalid element if any component is missing.
+bsoncxx::document::element lookup(bsoncxx::document::view doc, stdx::string_view path) {
+    for (;;) {
+        auto dot = path.find('.');
+        auto element = doc[path.substr(0, dot)];
+
+        if (!element || dot == stdx::string_view::npos) {
+            return element;
+        }
+
+        if (element.type() != bsoncxx::type::k_document) {
+            return {};
+        }
+
+        doc = element.get_document().value;
+        path = path.substr(dot + 1);
+    }
+}
+
+// The rank of each BSON type in the server's sort order. Types of equal rank are compared by value;
+// a missing field sorts as null.
+int sort_rank(bsoncxx::type type) {
+    switch (type) {
+        case bsoncxx::type::k_minkey:
+            return 0;
+        case bsoncxx::type::k_undefined:
+            return 1;
+        case bsoncxx::type::k_null:
+            return 2;
+        case bsoncxx::type::k_int32:
+        case bsoncxx::type::k_int64:
+        case bsoncxx::type::k_double:
+        case bsoncxx::type::k_decimal128:
+            return 3;
+        case bsoncxx::type::k_string:
+        case bsoncxx::type::k_symbol:
+            return 4;
+        case bsoncxx::type::k_document:
+            return 5;
+        case bsoncxx::type::k_array:
+            return 6;
+        case bsoncxx::type::k_binary:
+            return 7;
+        case bsoncxx::type::k_oid:
+            return 8;
+        case bsoncxx::type::k_bool:
+            return 9;
+        case bsoncxx::type::k_date:
+            return 10;
+        case bsoncxx::type::k_timestamp:
+            return 11;
+        case bsoncxx::type::k_regex:
+            return 12;
+        case bsoncxx::type::k_dbpointer:
+            return 13;
+        case bsoncxx::type::k_code:
+            return 14;
+        case bsoncxx::type::k_codewscope:
+            return 15;
+        case bsoncxx::type::k_maxkey:
+            return 16;
+    }
+
+    return 16;
+}
+
+// The $type aliases matching the types of each rank but null, which also matches missing fields
+// and is matched by equality instead, and arrays, which are not supported as sort keys.
+struct type_alias {
+    int rank;
+    const char* alias;
+};
+
+const type_alias k_type_aliases[] = {{0, "minKey"},
+                                     {1, "undefined"},
+                                     {3, "number"},
+                                     {4, "string"},
+                                     {4, "symbol"},
+                                     {5, "object"},
+                                     {7, "binData"},
+                                     {8, "objectId"},
+                                     {9, "bool"},
+                                     {10, "date"},
+                                     {11, "timestamp"},
+                                     {12, "regex"},
+                                     {13, "dbPointer"},
+                                     {14, "javascript"},
+                                     {15, "javascriptWithScope"},
+                                     {16, "maxKey"}};
+
+const int k_null_rank = 2;
+
+// Appends the condition that a field sorts strictly after a token value in the given direction.
+// Comparison operators only match values of the same type, so the values of the types which sort
+// after the token's type are matched by type.
+void append_after(sub_document& clause,
+                  const std::string& key,
+                  std::int32_t direction,
+                  const bsoncxx::types::bson_value::view& value) {
+    if (value.type() == bsoncxx::type::k_array) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "paginator does not support array-valued sort keys"};
+    }
+
+    const int rank = sort_rank(value.type());
+    const auto follows = [&](int other) { return direction == 1 ? other > rank : other < rank; };
+
+    std::vector<bsoncxx::document::value> alternatives;
+
+    // Values of a type holding a single value, and regular expressions, which cannot be compared
+    // by range, have no values of their own type after them.
+    const auto type = value.type();
+    const bool comparable = type != bsoncxx::type::k_minkey && type != bsoncxx::type::k_undefined &&
+                            type != bsoncxx::type::k_null && type != bsoncxx::type::k_regex &&
+                            type != bsoncxx::type::k_maxkey;
+    if (comparable) {
+        stdx::string_view op = direction == 1 ? "$gt" : "$lt";
+        alternatives.push_back(make_document(kvp(key, make_document(kvp(op, value)))));
+    }
+
+    if (follows(k_null_rank)) {
+        alternatives.push_back(
+            make_document(kvp(key, make_document(kvp("$eq", bsoncxx::types::b_null{})))));
+    }
+
+    bsoncxx::builder::basic::array types;
+    bool any_type = false;
+    for (const auto& type : k_type_aliases) {
+        if (follows(type.rank)) {
+            types.append(type.alias);
+            any_type = true;
+        }
+    }
+    if (any_type) {
+        alternatives.push_back(
+            make_document(kvp(key, make_document(kvp("$type", types.extract())))));
+    }
+
+    if (alternatives.empty()) {
+        // Nothing sorts after the token's type, so the clause must match no document.
+        alternatives.push_back(make_document(kvp(key, make_document(kvp("$in", make_array())))));
+    }
+
+    if (alternatives.size() == 1) {
+        clause.append(bsoncxx::builder::concatenate_doc{alternatives.front().view()});
+        return;
+    }
+
+    clause.append(kvp("$or", [&](sub_array or_array) {
+        for (const auto& alternative : alternatives) {
+            or_array.append(alternative.view());
+        }
+    }));
+}
+
+std::vector<std::pair<std::string, std::int32_t>> parse_sort(const options::find& options) {
+    std::vector<std::pair<std::string, std::int32_t>> sort_keys;
+    bool has_id = false;
+
+    if (options.sort()) {
+        for (auto&& element : options.sort()->view()) {
+            std::int32_t direction = 0;
+
+            switch (element.type()) {
+                case bsoncxx::type::k_int32:
+                    direction = element.get_int32().value;
+                    break;
+                case bsoncxx::type::k_int64:
+                    direction = static_cast<std::int32_t>(element.get_int64().value);
+                    break;
+                case bsoncxx::type::k_double:
+                    direction = static_cast<std::int32_t>(element.get_double().value);
+                    break;
+                default:
+                    break;
+            }
+
+            if (direction != 1 && direction != -1) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "paginator sort keys must be ascending (1) or descending (-1)"};
+            }
+
+            std::string key = bsoncxx::string::to_string(element.key());
+            has_id = has_id || key == "_id";
+            sort_keys.emplace_back(std::move(key), direction);
+
+            // _id is unique, so any key sorted after it is never consulted.
+            if (has_id) {
+                break;
+            }
+        }
+    }
+
+    if (!has_id) {
+        sort_keys.emplace_back("_id", 1);
+    }
+
+    return sort_keys;
+}
+
+}  // namespace
+
+paginator::paginator(collection coll,
+                     bsoncxx::document::view_or_value filter,
+                     options::find options,
+                     stdx::optional<bsoncxx::document::view_or_value> page_token) {
+    if (!options.limit() || *options.limit() <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "paginator requires a positive limit to use as the page size"};
+    }
+
+    if (options.skip()) {
+        throw logic_error{error_code::k_invalid_parameter, "paginator does not support skip"};
+    }
+
+    auto sort_keys = parse_sort(options);
+
+    bsoncxx::builder::basic::document sort;
+    for (auto&& sort_key : sort_keys) {
+        sort.append(kvp(sort_key.first, sort_key.second));
+    }
+    options.sort(sort.extract());
+
+    _impl = stdx::make_unique<impl>(std::move(coll),
+                                    bsoncxx::document::value{filter.view()},
+                                    std::move(options),
+                                    std::move(sort_keys));
+
+    if (page_token) {
+        for (auto&& sort_key : _impl->sort_keys) {
+            if (!page_token->view()[sort_key.first]) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "page token does not match the paginator's sort"};
+            }
+        }
+
+        _impl->token = bsoncxx::document::value{page_token->view()};
+    }
+}
+
+paginator::paginator(paginator&&) noexcept = default;
+paginator& paginator::operator=(paginator&&) noexcept = default;
+paginator::~paginator() = default;
+
+std::vector<bsoncxx::document::value> paginator::next_page() {
+    std::vector<bsoncxx::document::value> page;
+
+    if (_impl->exhausted) {
+        return page;
+    }
+
+    bsoncxx::builder::basic::document filter;
+
+    if (_impl->token) {
+        const auto token = _impl->token->view();
+
+        // For sort keys k1..kn, a document follows the token if, for some i, it is equal to the
+        // token on k1..k(i-1) and strictly after it on ki.
+        auto after_token = [&](sub_array clauses) {
+            for (std::size_t i = 0; i < _impl->sort_keys.size(); ++i) {
+                clauses.append([&](sub_document clause) {
+                    for (std::size_t j = 0; j < i; ++j) {
+                        const auto& key = _impl->sort_keys[j].first;
+                        clause.append(kvp(key, make_document(kvp("$eq", token[key].get_value()))));
+                    }
+
+                    const auto& key = _impl->sort_keys[i].first;
+                    append_after(clause, key, _impl->sort_keys[i].second, token[key].get_value());
+                });
+            }
+        };
+
+        if (_impl->filter.view().empty()) {
+            filter.append(kvp("$or", after_token));
+        } else {
+            filter.append(kvp("$and", [&](sub_array conjuncts) {
+                conjuncts.append(_impl->filter.view());
+                conjuncts.append(
+                    [&](sub_document conjunct) { conjunct.append(kvp("$or", after_token)); });
+            }));
+        }
+    }
+
+    auto cursor = _impl->coll.find(_impl->token ? filter.view() : _impl->filter.view(),
+                                   _impl->options);
+
+    for (auto&& doc : cursor) {
+        page.emplace_back(doc);
+    }
+
+    if (page.size() < static_cast<std::size_t>(*_impl->options.limit())) {
+        _impl->exhausted = true;
+    }
+
+    if (page.empty()) {
+        return page;
+    }
+
+    bsoncxx::builder::basic::document token;
+    const auto last = page.back().view();
+
+    for (auto&& sort_key : _impl->sort_keys) {
+        auto element = lookup(last, sort_key.first);
+
+        if (!element) {
+            if (sort_key.first == "_id") {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "paginator requires the projection to include _id"};
+            }
+
+            // A missing field sorts as null.
+            token.append(kvp(sort_key.first, bsoncxx::types::b_null{}));
+            continue;
+        }
+
+        if (element.type() == bsoncxx::type::k_array) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "paginator does not support array-valued sort keys"};
+        }
+
+        token.append(kvp(sort_key.first, element.get_value()));
+    }
+
+    _impl->token = token.extract();
+
+    return page;
+}
+
+bool paginator::exhausted() const noexcept {
+    return _impl->exhausted;
+}
+
+stdx::optional<bsoncxx::document::view> paginator::page_token() const {
+    if (!_impl->token) {
+        return stdx::nullopt;
+    }
+
+    return _impl->token->view();
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
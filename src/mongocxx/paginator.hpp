@@ -0,0 +1,128 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class that pages through the results of a query using the values of the sort keys of the last
+/// document returned, rather than skipping over the documents of the previous pages.
+///
+/// Each page is fetched by a new query of the form
+/// `{$or: [{k1: {$gt: last1}}, {k1: last1, k2: {$gt: last2}}, ...]}` combined with the filter, so
+/// the cost of fetching a page does not depend on its depth. An ascending `_id` is appended to the
+/// sort as a tiebreaker when the sort does not already include `_id`, which makes the order total.
+///
+/// Range queries only compare values of the same BSON type, so each condition on a sort key also
+/// matches, by `$type`, the values of every type which sorts after the last value in the server's
+/// order, and null or missing values by equality. Sort keys may therefore hold values of several
+/// types. Distinct regular expressions cannot be compared by range, so documents which only differ
+/// by a regular expression sort key may be skipped. Array-valued sort keys are not supported.
+/// Documents inserted or modified ahead of the current position while paging are observed by later
+/// pages; documents behind it are not.
+///
+class MONGOCXX_API paginator {
+   public:
+    ///
+    /// Creates a paginator over the documents of a collection matching a filter.
+    ///
+    /// @param coll
+    ///   The collection to page through.
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    /// @param options
+    ///   The options for each page's query. The limit is used as the page size and must be
+    ///   positive. The sort may only hold ascending (1) or descending (-1) keys and defaults to
+    ///   ascending `_id`. A projection must include every sort key. Skip must not be set.
+    /// @param page_token
+    ///   An optional token previously obtained from page_token(), from which to resume paging.
+    ///
+    /// @throws mongocxx::logic_error if the options or the page token are invalid.
+    ///
+    paginator(collection coll,
+              bsoncxx::document::view_or_value filter,
+              options::find options,
+              stdx::optional<bsoncxx::document::view_or_value> page_token = {});
+
+    ///
+    /// Move constructs a paginator.
+    ///
+    paginator(paginator&&) noexcept;
+
+    ///
+    /// Move assigns a paginator.
+    ///
+    paginator& operator=(paginator&&) noexcept;
+
+    ///
+    /// Destroys a paginator.
+    ///
+    ~paginator();
+
+    ///
+    /// Fetches the next page of documents.
+    ///
+    /// @return
+    ///   The documents of the next page, in sort order. An empty vector is returned once every
+    ///   document has been returned.
+    ///
+    /// @throws mongocxx::query_exception if the query fails.
+    /// @throws mongocxx::logic_error if a returned document holds an array-valued sort key or is
+    ///   missing its `_id`.
+    ///
+    std::vector<bsoncxx::document::value> next_page();
+
+    ///
+    /// Returns whether a page shorter than the page size has been fetched, in which case no
+    /// further documents are available.
+    ///
+    /// @return Whether paging is complete.
+    ///
+    bool exhausted() const noexcept;
+
+    ///
+    /// Gets a token representing the position after the last page fetched. The token holds the
+    /// sort key values of the last document returned and may be passed to the constructor of a
+    /// new paginator, with the same filter and options, to resume paging.
+    ///
+    /// @return
+    ///   The page token, or a disengaged optional if no document has been returned and no token
+    ///   was provided at construction.
+    ///
+    stdx::optional<bsoncxx::document::view> page_token() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -0,0 +1,231 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/hint.hpp>
+#include <mongocxx/parallel_scan.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+const std::int32_t k_default_samples_per_partition = 64;
+
+std::string partition_key(const options::parallel_scan& options) {
+    if (!options.key()) {
+        return "_id";
+    }
+
+    std::string key = bsoncxx::string::to_string(options.key()->view());
+    if (key.empty() || key[0] == '$') {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "options::parallel_scan::key() must name a field"};
+    }
+
+    return key;
+}
+
+options::find partition_find_options(const options::parallel_scan& options) {
+    if (!options.find_options()) {
+        return {};
+    }
+
+    const options::find& find_options = *options.find_options();
+
+    if (find_options.hint() || find_options.min() || find_options.max() || find_options.sort() ||
+        find_options.skip() || find_options.limit()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "hint, min, max, sort, skip and limit are reserved by parallel_scan"};
+    }
+
+    return find_options;
+}
+
+}  // namespace
+
+std::vector<bsoncxx::document::value> MONGOCXX_CALL parallel_scan_boundaries(
+    collection& coll, std::int32_t partitions, const options::parallel_scan& options) {
+    if (partitions <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive number of partitions required for parallel_scan"};
+    }
+
+    std::int32_t samples_per_partition =
+        options.samples_per_partition().value_or(k_default_samples_per_partition);
+
+    if (samples_per_partition <= 0) {
+        throw logic_error{
+            error_code::k_invalid_parameter,
+            "positive value required for options::parallel_scan::samples_per_partition()"};
+    }
+
+    std::vector<bsoncxx::document::value> boundaries;
+
+    if (partitions == 1) {
+        return boundaries;
+    }
+
+    const std::string key = partition_key(options);
+
+    // $sample is only able to use its random cursor optimization as the first stage of a
+    // pipeline, so the boundaries are computed over the entire collection rather than over the
+    // documents matching the scan's filter.
+    std::int64_t sample_size = static_cast<std::int64_t>(partitions) * samples_per_partition;
+    if (sample_size > std::numeric_limits<std::int32_t>::max()) {
+        sample_size = std::numeric_limits<std::int32_t>::max();
+    }
+
+    pipeline sample;
+    sample.sample(static_cast<std::int32_t>(sample_size))
+        .project(make_document(kvp("_id", 0), kvp("k", "$" + key)))
+        .sort(make_document(kvp("k", 1)));
+
+    std::vector<bsoncxx::document::value> samples;
+    for (auto&& doc : coll.aggregate(sample)) {
+        auto value = doc["k"];
+        if (value) {
+            samples.emplace_back(make_document(kvp(key, value.get_value())));
+        }
+    }
+
+    if (samples.empty()) {
+        return boundaries;
+    }
+
+    // Pick evenly spaced samples as boundaries, skipping repeated values so that no range is
+    // empty by construction.
+    for (std::int32_t i = 1; i < partitions; ++i) {
+        auto& candidate = samples[static_cast<std::size_t>(i) * samples.size() /
+                                  static_cast<std::size_t>(partitions)];
+
+        if (!boundaries.empty() && boundaries.back().view()[key].get_value() ==
+                                       candidate.view()[key].get_value()) {
+            continue;
+        }
+
+        boundaries.push_back(candidate);
+    }
+
+    return boundaries;
+}
+
+void MONGOCXX_CALL
+parallel_scan(pool& pool,
+              bsoncxx::string::view_or_value db_name,
+              bsoncxx::string::view_or_value collection_name,
+              bsoncxx::document::view_or_value filter,
+              std::int32_t partitions,
+              const std::function<void(std::int32_t, bsoncxx::document::view)>& handler,
+              const options::parallel_scan& options) {
+    const std::string key = partition_key(options);
+    const options::find base_options = partition_find_options(options);
+
+    std::vector<bsoncxx::document::value> boundaries;
+    {
+        auto entry = pool.acquire();
+        auto coll = (*entry)[db_name][collection_name];
+        boundaries = parallel_scan_boundaries(coll, partitions, options);
+    }
+
+    std::atomic<bool> failed{false};
+    std::exception_ptr first_error;
+    std::mutex first_error_mutex;
+
+    auto scan_partition = [&](std::size_t partition) {
+        try {
+            // The min and max bounds are applied to the index rather than to the documents'
+            // values, so they are not subject to type bracketing and every document falls into
+            // exactly one partition.
+            options::find find_options{base_options};
+            find_options.hint(mongocxx::hint{make_document(kvp(key, 1))});
+
+            if (partition > 0) {
+                find_options.min(boundaries[partition - 1].view());
+            }
+
+            if (partition < boundaries.size()) {
+                find_options.max(boundaries[partition].view());
+            }
+
+            auto entry = pool.acquire();
+            auto coll = (*entry)[db_name][collection_name];
+
+            for (auto&& doc : coll.find(filter.view(), find_options)) {
+                if (failed.load()) {
+                    return;
+                }
+                handler(static_cast<std::int32_t>(partition), doc);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{first_error_mutex};
+            if (!first_error) {
+                first_error = std::current_exception();
+            }
+            failed.store(true);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(boundaries.size());
+
+    try {
+        for (std::size_t partition = 1; partition <= boundaries.size(); ++partition) {
+            threads.emplace_back(scan_partition, partition);
+        }
+    } catch (...) {
+        // Destroying a joinable thread terminates the program, so the workers already started are
+        // stopped and joined before the failure to start the next one is reported.
+        failed.store(true);
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        throw;
+    }
+
+    // The calling thread scans the first partition itself.
+    scan_partition(0);
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,106 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/parallel_scan.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class collection;
+class pool;
+
+///
+/// Computes the boundaries that split a collection into contiguous ranges of an indexed key.
+///
+/// The boundaries are chosen from a random sample of the collection's documents, so the ranges
+/// hold roughly the same number of documents. Fewer than `partitions - 1` boundaries are returned
+/// when the collection holds too few distinct values of the key.
+///
+/// @param coll
+///   The collection to partition.
+/// @param partitions
+///   The requested number of ranges.
+/// @param options
+///   Optional arguments, see mongocxx::options::parallel_scan.
+///
+/// @return
+///   The sorted boundaries, each a single-field document of the form `{<key>: <value>}`
+///   suitable for use as the `min` or `max` of a find operation.
+///
+/// @throws mongocxx::logic_error if the options are invalid.
+/// @throws mongocxx::query_exception if the sampling query fails.
+///
+MONGOCXX_API std::vector<bsoncxx::document::value> MONGOCXX_CALL
+parallel_scan_boundaries(collection& coll,
+                         std::int32_t partitions,
+                         const options::parallel_scan& options = {});
+
+///
+/// Scans every document of a collection matching a filter by splitting the collection into
+/// contiguous ranges of an indexed key and scanning each range with its own client acquired from
+/// a pool, on its own thread.
+///
+/// The handler is invoked concurrently from the scanning threads, but never concurrently for the
+/// same partition; documents within a partition are delivered in index order. The views passed to
+/// the handler are only valid for the duration of the call.
+///
+/// If a partition fails or the handler throws, the remaining partitions stop at their next
+/// document, and the first exception is rethrown once every thread has finished.
+///
+/// @param pool
+///   The pool from which one client per partition is acquired.
+/// @param db_name
+///   The name of the database holding the collection.
+/// @param collection_name
+///   The name of the collection to scan.
+/// @param filter
+///   Document view representing a document that should match the query.
+/// @param partitions
+///   The requested number of partitions, which bounds the number of concurrent scans.
+/// @param handler
+///   A function receiving the zero-based index of the partition and each matching document.
+/// @param options
+///   Optional arguments, see mongocxx::options::parallel_scan.
+///
+/// @throws mongocxx::logic_error if the options are invalid.
+/// @throws mongocxx::query_exception if a query fails.
+/// @throws any exception thrown by the handler.
+/// @throws std::system_error if a scanning thread cannot be started, once the threads already
+///   started have finished.
+///
+MONGOCXX_API void MONGOCXX_CALL
+parallel_scan(pool& pool,
+              bsoncxx::string::view_or_value db_name,
+              bsoncxx::string::view_or_value collection_name,
+              bsoncxx::document::view_or_value filter,
+              std::int32_t partitions,
+              const std::function<void(std::int32_t, bsoncxx::document::view)>& handler,
+              const options::parallel_scan& options = {});
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
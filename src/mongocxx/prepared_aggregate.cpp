@@ -0,0 +1,349 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/builder/concatenate.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client_session.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/private/client_session.hh>
+#include <mongocxx/private/collection.hh>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/private/prepared_aggregate.hh>
+#include <mongocxx/private/read_preference.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+using bsoncxx::builder::concatenate_doc;
+using bsoncxx::type;
+
+const char k_placeholder_key[] = "$$placeholder";
+
+// Returns the slot of a placeholder document, or a disengaged optional if the document is not a
+// placeholder.
+stdx::optional<std::int32_t> placeholder_slot(bsoncxx::document::view doc) {
+    auto it = doc.begin();
+
+    if (it == doc.end() || it->key() != k_placeholder_key || it->type() != type::k_int32 ||
+        std::next(it) != doc.end()) {
+        return stdx::nullopt;
+    }
+
+    return it->get_int32().value;
+}
+
+void store_uint32(std::uint8_t* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+void store_uint64(std::uint8_t* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint32_t load_uint32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+// Encodes a fixed-width value into a buffer of at least 16 bytes and returns its size, or returns a
+// disengaged optional if the value does not have a fixed width.
+stdx::optional<std::size_t> encode_fixed(const bsoncxx::types::bson_value::view& value,
+                                         std::uint8_t* out) {
+    switch (value.type()) {
+        case type::k_double: {
+            std::uint64_t bits;
+            const double d = value.get_double().value;
+            std::memcpy(&bits, &d, sizeof(bits));
+            store_uint64(out, bits);
+            return std::size_t{8};
+        }
+        case type::k_int32:
+            store_uint32(out, static_cast<std::uint32_t>(value.get_int32().value));
+            return std::size_t{4};
+        case type::k_int64:
+            store_uint64(out, static_cast<std::uint64_t>(value.get_int64().value));
+            return std::size_t{8};
+        case type::k_date:
+            store_uint64(out, static_cast<std::uint64_t>(value.get_date().to_int64()));
+            return std::size_t{8};
+        case type::k_bool:
+            out[0] = value.get_bool().value ? 1 : 0;
+            return std::size_t{1};
+        case type::k_oid:
+            std::memcpy(out, value.get_oid().value.bytes(), 12);
+            return std::size_t{12};
+        case type::k_timestamp:
+            store_uint32(out, value.get_timestamp().increment);
+            store_uint32(out + 4, value.get_timestamp().timestamp);
+            return std::size_t{8};
+        case type::k_decimal128:
+            store_uint64(out, value.get_decimal128().value.low());
+            store_uint64(out + 8, value.get_decimal128().value.high());
+            return std::size_t{16};
+        case type::k_null:
+        case type::k_undefined:
+        case type::k_minkey:
+        case type::k_maxkey:
+            return std::size_t{0};
+        default:
+            return stdx::nullopt;
+    }
+}
+
+}  // namespace
+
+prepared_aggregate::impl::impl(const collection& coll,
+                               std::vector<std::uint8_t> stages,
+                               bsoncxx::document::value options,
+                               stdx::optional<class read_preference> read_preference)
+    : coll(coll),
+      stages(std::move(stages)),
+      options(std::move(options)),
+      options_bson(this->options.view()),
+      read_preference(std::move(read_preference)) {
+    std::vector<std::size_t> enclosing;
+    find_placeholders(bsoncxx::document::view{this->stages.data(), this->stages.size()},
+                      enclosing);
+
+    for (const auto& occ : occurrences) {
+        if (static_cast<std::size_t>(occ.slot) >= bound.size()) {
+            bound.resize(static_cast<std::size_t>(occ.slot) + 1, false);
+        }
+    }
+}
+
+void prepared_aggregate::impl::find_placeholders(bsoncxx::document::view doc,
+                                                 std::vector<std::size_t>& enclosing) {
+    const std::uint8_t* base = stages.data();
+
+    enclosing.push_back(static_cast<std::size_t>(doc.data() - base));
+
+    for (auto&& element : doc) {
+        if (element.type() == type::k_array) {
+            find_placeholders(element.get_array().value, enclosing);
+            continue;
+        }
+
+        if (element.type() != type::k_document) {
+            continue;
+        }
+
+        const auto sub = element.get_document().value;
+
+        if (auto slot = placeholder_slot(sub)) {
+            if (*slot < 0) {
+                throw logic_error{error_code::k_invalid_parameter,
+                                  "placeholder slots must not be negative"};
+            }
+
+            occurrence occ;
+            occ.slot = *slot;
+            occ.type_offset = static_cast<std::size_t>(element.raw() - base) + element.offset();
+            occ.value_offset = static_cast<std::size_t>(sub.data() - base);
+            occ.value_length = sub.length();
+            occ.enclosing = enclosing;
+            occurrences.push_back(std::move(occ));
+            continue;
+        }
+
+        find_placeholders(sub, enclosing);
+    }
+
+    enclosing.pop_back();
+}
+
+void prepared_aggregate::impl::bind(std::int32_t slot,
+                                    const bsoncxx::types::bson_value::view& value) {
+    if (slot < 0 || static_cast<std::size_t>(slot) >= bound.size()) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "the pipeline holds no placeholder with that slot"};
+    }
+
+    std::uint8_t fixed[16];
+    const std::uint8_t* data = fixed;
+    std::size_t length;
+
+    // Values without a fixed width are encoded by libbson as the only element of a document with
+    // an empty key: a 4 byte length, a type byte and an empty key come before the value, and the
+    // document's trailing null byte comes after it.
+    stdx::optional<bsoncxx::document::value> encoded;
+    if (auto fixed_length = encode_fixed(value, fixed)) {
+        length = *fixed_length;
+    } else {
+        encoded = make_document(kvp("", value));
+        data = encoded->view().data() + 6;
+        length = encoded->view().length() - 7;
+    }
+
+    for (std::size_t i = 0; i < occurrences.size(); ++i) {
+        if (occurrences[i].slot == slot) {
+            write(i, value.type(), data, length);
+        }
+    }
+
+    bound[static_cast<std::size_t>(slot)] = true;
+}
+
+void prepared_aggregate::impl::write(std::size_t index,
+                                     bsoncxx::type type,
+                                     const std::uint8_t* data,
+                                     std::size_t length) {
+    occurrence& occ = occurrences[index];
+
+    stages[occ.type_offset] = static_cast<std::uint8_t>(type);
+
+    if (length == occ.value_length) {
+        std::memcpy(stages.data() + occ.value_offset, data, length);
+        return;
+    }
+
+    const auto at = occ.value_offset;
+    const auto old_length = occ.value_length;
+    const auto delta =
+        static_cast<std::int64_t>(length) - static_cast<std::int64_t>(old_length);
+
+    // Replace the common prefix in place, then insert or erase the remainder.
+    const auto common = std::min(length, old_length);
+    std::memcpy(stages.data() + at, data, common);
+    if (length > old_length) {
+        stages.insert(stages.begin() + static_cast<std::ptrdiff_t>(at + common),
+                      data + common,
+                      data + length);
+    } else {
+        stages.erase(stages.begin() + static_cast<std::ptrdiff_t>(at + length),
+                     stages.begin() + static_cast<std::ptrdiff_t>(at + old_length));
+    }
+
+    for (const auto offset : occ.enclosing) {
+        std::uint8_t* prefix = stages.data() + offset;
+        store_uint32(prefix,
+                     static_cast<std::uint32_t>(static_cast<std::int64_t>(load_uint32(prefix)) +
+                                                delta));
+    }
+
+    occ.value_length = length;
+
+    // Occurrences are recorded in order of offset, so only later ones can move.
+    const auto shift = [&](std::size_t& offset) {
+        if (offset > at) {
+            offset = static_cast<std::size_t>(static_cast<std::int64_t>(offset) + delta);
+        }
+    };
+
+    for (std::size_t i = index + 1; i < occurrences.size(); ++i) {
+        shift(occurrences[i].type_offset);
+        shift(occurrences[i].value_offset);
+        for (auto& offset : occurrences[i].enclosing) {
+            shift(offset);
+        }
+    }
+}
+
+bsoncxx::document::value prepared_aggregate::placeholder(std::int32_t slot) {
+    return make_document(kvp(k_placeholder_key, slot));
+}
+
+prepared_aggregate::prepared_aggregate(const collection& coll,
+                                       const pipeline& pipeline,
+                                       const options::aggregate& options) {
+    const auto stages = pipeline.view_array();
+
+    bsoncxx::builder::basic::document options_builder;
+    options.append(options_builder);
+
+    _impl = stdx::make_unique<impl>(coll,
+                                    std::vector<std::uint8_t>(stages.data(),
+                                                              stages.data() + stages.length()),
+                                    options_builder.extract(),
+                                    options.read_preference());
+}
+
+prepared_aggregate::prepared_aggregate(prepared_aggregate&&) noexcept = default;
+prepared_aggregate& prepared_aggregate::operator=(prepared_aggregate&&) noexcept = default;
+prepared_aggregate::~prepared_aggregate() = default;
+
+prepared_aggregate& prepared_aggregate::bind(std::int32_t slot,
+                                             bsoncxx::types::bson_value::view value) {
+    _impl->bind(slot, value);
+    return *this;
+}
+
+cursor prepared_aggregate::execute() {
+    return _execute(nullptr);
+}
+
+cursor prepared_aggregate::execute(const client_session& session) {
+    return _execute(&session);
+}
+
+cursor prepared_aggregate::_execute(const client_session* session) {
+    for (const auto& occ : _impl->occurrences) {
+        if (!_impl->bound[static_cast<std::size_t>(occ.slot)]) {
+            throw logic_error{error_code::k_invalid_parameter,
+                              "every placeholder must be bound before executing"};
+        }
+    }
+
+    // Both the pipeline and the options are wrapped without copying; libmongoc copies what it
+    // keeps.
+    libbson::scoped_bson_t stages_bson{
+        bsoncxx::document::view{_impl->stages.data(), _impl->stages.size()}};
+    bson_t* options_bson = _impl->options_bson.bson();
+
+    libbson::scoped_bson_t session_options_bson;
+    if (session) {
+        bsoncxx::builder::basic::document options_builder;
+        options_builder.append(concatenate_doc{_impl->options.view()});
+        options_builder.append(concatenate_doc{session->_get_impl().to_document()});
+        session_options_bson.init_from_static(options_builder.extract());
+        options_bson = session_options_bson.bson();
+    }
+
+    const mongoc_read_prefs_t* rp_ptr = NULL;
+    if (_impl->read_preference) {
+        rp_ptr = _impl->read_preference->_impl->read_preference_t;
+    }
+
+    return cursor(libmongoc::collection_aggregate(_impl->coll._get_impl().collection_t,
+                                                  static_cast<::mongoc_query_flags_t>(0),
+                                                  stages_bson.bson(),
+                                                  options_bson,
+                                                  rp_ptr));
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
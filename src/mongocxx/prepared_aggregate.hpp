@@ -0,0 +1,145 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/options/aggregate.hpp>
+#include <mongocxx/pipeline.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class client_session;
+
+///
+/// Class representing an aggregation whose pipeline and options are encoded once, with
+/// placeholders whose values can be changed between executions.
+///
+/// Placeholders are created with prepared_aggregate::placeholder() and used in the pipeline in
+/// place of a value, for example
+/// `pipeline.match(make_document(kvp("ts", make_document(kvp("$gte", placeholder(0))))))`.
+/// Binding a value whose encoding has the same size as the value previously bound to the
+/// placeholder overwrites it in place, which is always the case when a fixed-width value such as
+/// an int32, int64, double, date or ObjectId is bound again. Otherwise the encoded pipeline is
+/// spliced and the lengths of the enclosing documents are adjusted.
+///
+/// A prepared aggregation holds its own copy of the collection and is subject to the same
+/// thread-safety rules: it must not be used concurrently from several threads.
+///
+class MONGOCXX_API prepared_aggregate {
+   public:
+    ///
+    /// Creates a placeholder to use in a pipeline in place of a value.
+    ///
+    /// @param slot
+    ///   The non-negative index of the placeholder. A placeholder may appear several times in a
+    ///   pipeline, in which case every occurrence receives the bound value.
+    ///
+    /// @return
+    ///   A document marking the position of the placeholder.
+    ///
+    static bsoncxx::document::value placeholder(std::int32_t slot);
+
+    ///
+    /// Prepares an aggregation.
+    ///
+    /// @param coll
+    ///   The collection to aggregate.
+    /// @param pipeline
+    ///   The pipeline of aggregation operations to perform, which may contain placeholders.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::aggregate.
+    ///
+    /// @throws mongocxx::logic_error if a placeholder is invalid.
+    ///
+    prepared_aggregate(const collection& coll,
+                       const pipeline& pipeline,
+                       const options::aggregate& options = {});
+
+    ///
+    /// Move constructs a prepared aggregation.
+    ///
+    prepared_aggregate(prepared_aggregate&&) noexcept;
+
+    ///
+    /// Move assigns a prepared aggregation.
+    ///
+    prepared_aggregate& operator=(prepared_aggregate&&) noexcept;
+
+    ///
+    /// Destroys a prepared aggregation.
+    ///
+    ~prepared_aggregate();
+
+    ///
+    /// Binds a value to a placeholder. The value is copied into the encoded pipeline.
+    ///
+    /// @param slot
+    ///   The index of the placeholder.
+    /// @param value
+    ///   The value to substitute for every occurrence of the placeholder.
+    ///
+    /// @return
+    ///   A reference to the object on which this member function is being called.  This facilitates
+    ///   method chaining.
+    ///
+    /// @throws mongocxx::logic_error if the pipeline holds no placeholder with that index.
+    ///
+    prepared_aggregate& bind(std::int32_t slot, bsoncxx::types::bson_value::view value);
+
+    ///
+    /// Runs the aggregation with the values currently bound to its placeholders.
+    ///
+    /// @return
+    ///   A mongocxx::cursor with the results.
+    ///
+    /// @throws mongocxx::logic_error if a placeholder has never been bound.
+    ///
+    cursor execute();
+
+    ///
+    /// Runs the aggregation with the values currently bound to its placeholders as part of a
+    /// client session. The session identifiers are appended to a copy of the prepared options on
+    /// each call.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the aggregation.
+    ///
+    /// @return
+    ///   A mongocxx::cursor with the results.
+    ///
+    /// @throws mongocxx::logic_error if a placeholder has never been bound.
+    ///
+    cursor execute(const client_session& session);
+
+   private:
+    MONGOCXX_PRIVATE cursor _execute(const client_session* session);
+
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
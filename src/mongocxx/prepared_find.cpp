@@ -0,0 +1,104 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstdint>
+#include <limits>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/concatenate.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/client_session.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/options/private/find.hh>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/private/client_session.hh>
+#include <mongocxx/private/collection.hh>
+#include <mongocxx/private/cursor.hh>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/private/prepared_find.hh>
+#include <mongocxx/private/read_preference.hh>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+using bsoncxx::builder::concatenate_doc;
+
+prepared_find::prepared_find(const collection& coll, const options::find& options) {
+    stdx::optional<std::uint32_t> max_await_time_ms;
+
+    if (options.max_await_time()) {
+        const auto count = options.max_await_time()->count();
+        if ((count < 0) || (count >= std::numeric_limits<std::uint32_t>::max())) {
+            throw logic_error{error_code::k_invalid_parameter};
+        }
+        max_await_time_ms = static_cast<std::uint32_t>(count);
+    }
+
+    _impl = stdx::make_unique<impl>(coll,
+                                    options::build_find_options_document(options).extract(),
+                                    options.read_preference(),
+                                    options.cursor_type(),
+                                    max_await_time_ms);
+}
+
+prepared_find::prepared_find(prepared_find&&) noexcept = default;
+prepared_find& prepared_find::operator=(prepared_find&&) noexcept = default;
+prepared_find::~prepared_find() = default;
+
+cursor prepared_find::execute(bsoncxx::document::view filter) {
+    return _execute(nullptr, filter);
+}
+
+cursor prepared_find::execute(const client_session& session, bsoncxx::document::view filter) {
+    return _execute(&session, filter);
+}
+
+cursor prepared_find::_execute(const client_session* session, bsoncxx::document::view filter) {
+    // Both the filter and the options are wrapped without copying; libmongoc copies what it keeps.
+    libbson::scoped_bson_t filter_bson{filter};
+    bson_t* options_bson = _impl->options_bson.bson();
+
+    libbson::scoped_bson_t session_options_bson;
+    if (session) {
+        bsoncxx::builder::basic::document options_builder;
+        options_builder.append(concatenate_doc{_impl->options.view()});
+        options_builder.append(concatenate_doc{session->_get_impl().to_document()});
+        session_options_bson.init_from_static(options_builder.extract());
+        options_bson = session_options_bson.bson();
+    }
+
+    const mongoc_read_prefs_t* rp_ptr = NULL;
+    if (_impl->read_preference) {
+        rp_ptr = _impl->read_preference->_impl->read_preference_t;
+    }
+
+    cursor query_cursor{
+        libmongoc::collection_find_with_opts(
+            _impl->coll._get_impl().collection_t, filter_bson.bson(), options_bson, rp_ptr),
+        _impl->cursor_type};
+
+    if (_impl->max_await_time_ms) {
+        libmongoc::cursor_set_max_await_time_ms(query_cursor._impl->cursor_t,
+                                                *_impl->max_await_time_ms);
+    }
+
+    return query_cursor;
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
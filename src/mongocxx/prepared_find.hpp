@@ -0,0 +1,111 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <memory>
+
+#include <bsoncxx/document/view.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/options/find.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class client_session;
+
+///
+/// Class representing a find operation whose options are serialized once, so that it can be
+/// executed repeatedly with different filters at a lower cost than collection::find.
+///
+/// A prepared find holds its own copy of the collection and is subject to the same thread-safety
+/// rules: it must not be used concurrently from several threads.
+///
+class MONGOCXX_API prepared_find {
+   public:
+    ///
+    /// Prepares a find operation.
+    ///
+    /// @param coll
+    ///   The collection to query. Later changes to the collection's read concern or read
+    ///   preference are not observed by the prepared find.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::find.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    ///
+    prepared_find(const collection& coll, const options::find& options = {});
+
+    ///
+    /// Move constructs a prepared find.
+    ///
+    prepared_find(prepared_find&&) noexcept;
+
+    ///
+    /// Move assigns a prepared find.
+    ///
+    prepared_find& operator=(prepared_find&&) noexcept;
+
+    ///
+    /// Destroys a prepared find.
+    ///
+    ~prepared_find();
+
+    ///
+    /// Runs the find operation with a filter. Apart from the cursor itself, the options are not
+    /// re-encoded and no memory is allocated.
+    ///
+    /// @param filter
+    ///   Document view representing a document that should match the query. The view only needs
+    ///   to remain valid for the duration of the call.
+    ///
+    /// @return
+    ///   A mongocxx::cursor with the matching documents.
+    ///
+    /// @throws mongocxx::query_exception if the query fails.
+    ///
+    cursor execute(bsoncxx::document::view filter);
+
+    ///
+    /// Runs the find operation with a filter as part of a client session. The session
+    /// identifiers are appended to a copy of the prepared options on each call.
+    ///
+    /// @param session
+    ///   The mongocxx::client_session with which to perform the query.
+    /// @param filter
+    ///   Document view representing a document that should match the query. The view only needs
+    ///   to remain valid for the duration of the call.
+    ///
+    /// @return
+    ///   A mongocxx::cursor with the matching documents.
+    ///
+    /// @throws mongocxx::query_exception if the query fails.
+    ///
+    cursor execute(const client_session& session, bsoncxx::document::view filter);
+
+   private:
+    MONGOCXX_PRIVATE cursor _execute(const client_session* session,
+                                     bsoncxx::document::view filter);
+
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
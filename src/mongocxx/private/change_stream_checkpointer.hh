@@ -0,0 +1,106 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream_checkpointer.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/write_concern.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class change_stream_checkpointer::impl {
+   public:
+    impl(std::chrono::milliseconds commit_interval,
+         stdx::optional<class write_concern> write_concern)
+        : commit_interval(commit_interval), write_concern(std::move(write_concern)) {}
+
+    // Reads the checkpoint from the file or the document, if any.
+    stdx::optional<checkpoint> load();
+
+    // Writes a checkpoint to the file or the document. Called without the mutex.
+    void persist(const checkpoint& next);
+    void persist_to_file(bsoncxx::document::view encoded);
+    void persist_to_collection(const checkpoint& next);
+
+    // Persists the latest acknowledgement if it is newer than the latest checkpoint. Requires the
+    // lock, which is released during the write.
+    void commit(std::unique_lock<std::mutex>& lock);
+
+    // The body of the background thread.
+    void run();
+
+    // Requests the final commit, waits for the background thread to stop and returns the error of
+    // the final commit, if it failed. The first caller joins the thread.
+    std::exception_ptr stop();
+
+    const std::chrono::milliseconds commit_interval;
+    const stdx::optional<class write_concern> write_concern;
+
+    // Where checkpoints are persisted: either a file, or a document of a collection.
+    std::string path;
+    class pool* pool = nullptr;
+    std::string db_name;
+    std::string collection_name;
+    std::string id;
+
+    // Guards every member below.
+    std::mutex mutex;
+
+    // Notified to request a commit, when stopping, and when a commit completes.
+    std::condition_variable commit_requested;
+    std::condition_variable commit_completed;
+
+    // The acknowledgement with the highest sequence number, and the latest checkpoint written.
+    stdx::optional<checkpoint> acknowledged;
+    stdx::optional<checkpoint> persisted;
+
+    // The number of acknowledgements accepted, and that number when the latest checkpoint was
+    // taken, which tells whether the latest acknowledgement has been persisted.
+    std::uint64_t acknowledgements = 0;
+    std::uint64_t persisted_acknowledgements = 0;
+
+    // Commits are numbered in the order they start, and complete in that order. flush() requests
+    // the commit following the one in progress.
+    std::uint64_t commits_started = 0;
+    std::uint64_t commits_requested = 0;
+    std::uint64_t commits_completed = 0;
+
+    // The error of the latest commit, if it failed.
+    std::exception_ptr error;
+
+    // Set once the final commit is requested, and once it has completed.
+    bool stopping = false;
+    bool stopped = false;
+
+    std::thread committer;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,111 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/change_stream_dispatcher.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class change_stream_dispatcher::impl {
+   public:
+    // A notification waiting for a worker, with its position in the change stream.
+    struct queued_event {
+        std::uint64_t sequence;
+        bsoncxx::document::value event;
+    };
+
+    struct worker {
+        std::deque<queued_event> queue;
+        std::condition_variable event_queued;
+        std::thread thread;
+    };
+
+    // A position of the change stream which has been read but not yet passed by the watermark.
+    struct position {
+        stdx::optional<bsoncxx::document::value> resume_token;
+        bool handled;
+    };
+
+    impl(change_stream stream,
+         handler handler,
+         std::size_t workers,
+         std::size_t max_queued_events,
+         std::chrono::milliseconds max_wait);
+
+    // The bodies of the reading thread and of the worker threads.
+    void read();
+    void work(worker& w);
+
+    // Runs the handler, stopping the dispatcher if it throws. Returns whether it succeeded.
+    bool handle(bsoncxx::document::view event);
+
+    // Records the next position of the change stream and returns its sequence number. Requires
+    // the mutex.
+    std::uint64_t record(stdx::optional<bsoncxx::document::value> resume_token);
+
+    // Marks a position as handled and advances the watermark past every position handled in order.
+    // Requires the mutex.
+    void complete(std::uint64_t sequence);
+
+    // Stops every thread, keeping the first error. Requires the mutex.
+    void stop(std::exception_ptr cause);
+
+    change_stream stream;
+    const handler handler_fn;
+    const std::size_t max_queued_events;
+    const std::chrono::milliseconds max_wait;
+
+    // Guards every member below, and the queues of the workers.
+    mutable std::mutex mutex;
+
+    // Notified when a worker takes a notification or a position is handled.
+    std::condition_variable progress;
+
+    std::vector<std::unique_ptr<worker>> workers;
+
+    // Positions read but not passed by the watermark, by sequence number.
+    std::map<std::uint64_t, position> pending;
+    std::uint64_t next_sequence = 0;
+
+    stdx::optional<watermark> low_watermark;
+
+    std::exception_ptr error;
+    bool stopping = false;
+
+    std::thread reader;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,143 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/matcher.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/change_stream_hub.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class change_stream_hub::impl {
+   public:
+    struct subscriber {
+        subscriber(bsoncxx::matcher matcher, std::size_t max_queued_events, overflow_policy policy)
+            : matcher(std::move(matcher)), max_queued_events(max_queued_events), policy(policy) {}
+
+        // The filter of the subscriber, which is also part of the pipeline of the change stream.
+        const bsoncxx::matcher matcher;
+        const std::size_t max_queued_events;
+        const overflow_policy policy;
+
+        // The members below are guarded by the mutex of the hub.
+        std::deque<event> queue;
+        std::condition_variable event_queued;
+        std::uint64_t dropped = 0;
+        bool disconnected = false;
+    };
+
+    impl(class pool& pool,
+         std::string db_name,
+         std::string collection_name,
+         stdx::optional<std::string> full_document,
+         stdx::optional<std::int32_t> batch_size,
+         stdx::optional<bsoncxx::document::value> collation,
+         std::chrono::milliseconds max_await_time)
+        : db_name(std::move(db_name)),
+          collection_name(std::move(collection_name)),
+          full_document(std::move(full_document)),
+          batch_size(batch_size),
+          collation(std::move(collation)),
+          max_await_time(max_await_time),
+          watch_client(pool.acquire()) {}
+
+    // Opens the change stream with the union of the filters, resuming after the resume token if
+    // there is one.
+    change_stream open_change_stream(const std::vector<std::shared_ptr<subscriber>>& targets);
+
+    // Queues an event for the subscribers whose filter it matches. Returns false if the hub is
+    // stopping. Requires the lock, which is held except while waiting for a blocked subscriber.
+    bool deliver(const event& shared, std::unique_lock<std::mutex>& lock);
+
+    // Stops delivering events to a subscriber and removes it. Requires the mutex.
+    void disconnect(const std::shared_ptr<subscriber>& target);
+
+    // The body of the background thread.
+    void run();
+
+    const std::string db_name;
+    const std::string collection_name;
+    const stdx::optional<std::string> full_document;
+    const stdx::optional<std::int32_t> batch_size;
+    const stdx::optional<bsoncxx::document::value> collation;
+    const std::chrono::milliseconds max_await_time;
+
+    // Guards every member below, and the queues of the subscribers.
+    mutable std::mutex mutex;
+
+    // Notified when a subscriber subscribes or unsubscribes, and when stopping.
+    std::condition_variable subscribers_changed;
+
+    // Notified when a subscriber takes an event or is disconnected.
+    std::condition_variable room;
+
+    // Notified when the change stream is reopened or a subscriber is disconnected.
+    std::condition_variable stream_opened;
+
+    std::vector<std::shared_ptr<subscriber>> subscribers;
+
+    // Incremented whenever the set of subscribers changes, and the value it had when the change
+    // stream was last opened. The stream is reopened with a new union of the filters while they
+    // differ.
+    std::uint64_t pipeline_generation = 0;
+    std::uint64_t opened_generation = 0;
+
+    std::exception_ptr error;
+    bool stopping = false;
+
+    // The client, change stream and resume token used by the background thread.
+    mongocxx::pool::entry watch_client;
+    stdx::optional<change_stream> stream;
+    stdx::optional<bsoncxx::document::value> token;
+
+    std::thread watcher;
+};
+
+class change_stream_hub::subscription::impl {
+   public:
+    impl(change_stream_hub::impl* hub, std::shared_ptr<change_stream_hub::impl::subscriber> state)
+        : hub(hub), state(std::move(state)) {}
+
+    // Unsubscribes.
+    ~impl();
+
+    change_stream_hub::impl* const hub;
+    const std::shared_ptr<change_stream_hub::impl::subscriber> state;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,70 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/change_stream_prefetcher.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class change_stream_prefetcher::impl {
+   public:
+    impl(change_stream stream,
+         std::size_t max_batch_size,
+         std::chrono::milliseconds max_wait,
+         std::size_t max_queued_batches)
+        : stream(std::move(stream)),
+          max_batch_size(max_batch_size),
+          max_wait(max_wait),
+          max_queued_batches(max_queued_batches) {}
+
+    // The body of the prefetching thread, which is the only user of the change stream.
+    void run();
+
+    change_stream stream;
+    const std::size_t max_batch_size;
+    const std::chrono::milliseconds max_wait;
+    const std::size_t max_queued_batches;
+
+    // Guards every member below.
+    std::mutex mutex;
+    std::condition_variable batch_queued;
+    std::condition_variable batch_taken;
+
+    std::deque<batch> queue;
+
+    // The exception which stopped the prefetching thread, raised once the queue is drained.
+    std::exception_ptr error;
+
+    bool stopping = false;
+
+    std::thread fetcher;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,102 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <mongocxx/id_loader.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class id_loader::impl {
+   public:
+    // Orders ids as the server compares them, so that ids the server considers equal share an
+    // entry.
+    struct id_less {
+        bool operator()(const bsoncxx::types::bson_value::value& lhs,
+                        const bsoncxx::types::bson_value::value& rhs) const {
+            return bsoncxx::compare(lhs.view(), rhs.view()) < 0;
+        }
+    };
+
+    using promises = std::vector<std::promise<stdx::optional<bsoncxx::document::value>>>;
+
+    // The lookups of a batch: the callers waiting for each distinct id.
+    using batch = std::map<bsoncxx::types::bson_value::value, promises, id_less>;
+
+    impl(class pool& pool,
+         std::string db_name,
+         std::string collection_name,
+         options::find find_options,
+         std::size_t max_batch_size,
+         std::chrono::milliseconds max_delay)
+        : pool(pool),
+          db_name(std::move(db_name)),
+          collection_name(std::move(collection_name)),
+          find_options(std::move(find_options)),
+          max_batch_size(max_batch_size),
+          max_delay(max_delay) {}
+
+    // The body of the dispatching thread.
+    void run();
+
+    // Queries the documents of a batch and resolves its promises.
+    void dispatch(batch lookups);
+
+    class pool& pool;
+    const std::string db_name;
+    const std::string collection_name;
+    const options::find find_options;
+    const std::size_t max_batch_size;
+    const std::chrono::milliseconds max_delay;
+
+    // Guards every member below.
+    std::mutex mutex;
+    std::condition_variable pending_changed;
+
+    // The queued lookups, their distinct ids in the order they were first queued, and when the
+    // first of them was queued.
+    batch pending;
+    std::deque<bsoncxx::types::bson_value::value> arrival;
+    std::chrono::steady_clock::time_point first_queued;
+
+    bool flush_requested = false;
+    bool stopping = false;
+
+    std::thread dispatcher;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,135 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/local_replica.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class local_replica::impl {
+   public:
+    // Hashes values consistently with bsoncxx::compare, so that values the server considers equal,
+    // such as numbers of different types, hash alike.
+    struct value_hash {
+        std::size_t operator()(const bsoncxx::types::bson_value::value& value) const;
+    };
+
+    struct value_equal {
+        bool operator()(const bsoncxx::types::bson_value::value& lhs,
+                        const bsoncxx::types::bson_value::value& rhs) const {
+            return bsoncxx::compare(lhs.view(), rhs.view()) == 0;
+        }
+    };
+
+    using id_set =
+        std::unordered_set<bsoncxx::types::bson_value::value, value_hash, value_equal>;
+
+    template <typename T>
+    using value_map =
+        std::unordered_map<bsoncxx::types::bson_value::value, T, value_hash, value_equal>;
+
+    // The documents of the copy and their indexes.
+    struct contents {
+        value_map<bsoncxx::document::value> documents;
+
+        // The ids of the documents holding each value of an indexed field, in the order of
+        // options::local_replica::indexes.
+        std::vector<value_map<id_set>> indexes;
+    };
+
+    impl(class pool& pool,
+         std::string db_name,
+         std::string collection_name,
+         std::vector<std::string> index_fields,
+         std::int32_t snapshot_partitions)
+        : pool(pool),
+          db_name(std::move(db_name)),
+          collection_name(std::move(collection_name)),
+          index_fields(std::move(index_fields)),
+          snapshot_partitions(snapshot_partitions),
+          watch_client(pool.acquire()) {}
+
+    // Stores a document in contents, replacing the document with the same id.
+    void insert(contents& target, bsoncxx::document::value doc) const;
+
+    // Removes a document from contents.
+    void remove(contents& target, const bsoncxx::types::bson_value::value& id) const;
+
+    // The following member functions are called from the constructor and then from the applying
+    // thread only, which is the only writer of the contents.
+
+    // Opens the change stream, resuming after the resume token if there is one.
+    change_stream open_change_stream();
+
+    // Opens a new change stream, then replaces the contents with a new snapshot.
+    void synchronize();
+
+    // Records the resume token of the change stream. Must be called with the mutex held.
+    void save_resume_token();
+
+    // Applies a change event. Returns true if the copy must be synchronized again.
+    bool apply(bsoncxx::document::view event);
+
+    // Replaces the copy of a document with the document read from the server.
+    void refresh(const bsoncxx::types::bson_value::value& id);
+
+    // The body of the applying thread.
+    void run();
+
+    class pool& pool;
+    const std::string db_name;
+    const std::string collection_name;
+    const std::vector<std::string> index_fields;
+    const std::int32_t snapshot_partitions;
+
+    // Guards the contents and the resume token against the readers, and guards stopping.
+    mutable std::mutex mutex;
+
+    contents current;
+    stdx::optional<bsoncxx::document::value> token;
+
+    bool stopping = false;
+    std::condition_variable stopping_changed;
+
+    // The client and change stream used by the applying thread.
+    mongocxx::pool::entry watch_client;
+    stdx::optional<change_stream> stream;
+
+    std::thread applier;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
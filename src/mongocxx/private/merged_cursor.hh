@@ -0,0 +1,51 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/compare.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/merged_cursor.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class merged_cursor::impl {
+   public:
+    impl(std::vector<cursor> cursors, bsoncxx::sort_comparator comparator)
+        : cursors{std::move(cursors)}, comparator{std::move(comparator)} {}
+
+    std::vector<cursor> cursors;
+    bsoncxx::sort_comparator comparator;
+
+    // The current position of each cursor. Populated on the first call to begin().
+    std::vector<cursor::iterator> positions;
+
+    // The indexes of the cursors that are not exhausted, arranged as a heap whose front is the
+    // cursor holding the next document in sort order.
+    std::vector<std::size_t> heap;
+
+    bool started = false;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,62 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/paginator.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class paginator::impl {
+   public:
+    // A sort key, as a field path and a direction of 1 or -1.
+    using sort_key = std::pair<std::string, std::int32_t>;
+
+    impl(collection coll,
+         bsoncxx::document::value filter,
+         options::find options,
+         std::vector<sort_key> sort_keys)
+        : coll{std::move(coll)},
+          filter{std::move(filter)},
+          options{std::move(options)},
+          sort_keys{std::move(sort_keys)} {}
+
+    collection coll;
+    bsoncxx::document::value filter;
+
+    // The options for each page's query, with the sort including the _id tiebreaker.
+    options::find options;
+    std::vector<sort_key> sort_keys;
+
+    // The values of the sort keys of the last document returned, keyed by field path.
+    stdx::optional<bsoncxx::document::value> token;
+    bool exhausted = false;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,86 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/read_preference.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class prepared_aggregate::impl {
+   public:
+    // The position of one occurrence of a placeholder within the encoded pipeline.
+    struct occurrence {
+        std::int32_t slot;
+
+        // The offsets of the element's type byte and of its value, and the size of the value.
+        std::size_t type_offset;
+        std::size_t value_offset;
+        std::size_t value_length;
+
+        // The offsets of the documents and arrays enclosing the element, outermost first, whose
+        // length prefixes change when the size of the value changes.
+        std::vector<std::size_t> enclosing;
+    };
+
+    impl(const collection& coll,
+         std::vector<std::uint8_t> stages,
+         bsoncxx::document::value options,
+         stdx::optional<class read_preference> read_preference);
+
+    // Records every placeholder within a document of the encoded pipeline.
+    void find_placeholders(bsoncxx::document::view doc, std::vector<std::size_t>& enclosing);
+
+    // Writes a value to every occurrence of a placeholder.
+    void bind(std::int32_t slot, const bsoncxx::types::bson_value::view& value);
+
+    // Replaces the value of one occurrence of a placeholder with an encoded value of any size.
+    void write(std::size_t index, bsoncxx::type type, const std::uint8_t* data, std::size_t length);
+
+    collection coll;
+
+    // The encoded pipeline, as a BSON array, with the values currently bound to placeholders.
+    std::vector<std::uint8_t> stages;
+
+    // Every occurrence of a placeholder, in order of offset.
+    std::vector<occurrence> occurrences;
+
+    // Whether a value has been bound to each slot, indexed by slot.
+    std::vector<bool> bound;
+
+    // The encoded options document, and a bson_t over it which is passed to libmongoc as is.
+    bsoncxx::document::value options;
+    libbson::scoped_bson_t options_bson;
+
+    stdx::optional<class read_preference> read_preference;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
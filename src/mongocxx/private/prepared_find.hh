@@ -0,0 +1,60 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <cstdint>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/cursor.hpp>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/private/libbson.hh>
+#include <mongocxx/read_preference.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class prepared_find::impl {
+   public:
+    impl(const collection& coll,
+         bsoncxx::document::value options,
+         stdx::optional<class read_preference> read_preference,
+         stdx::optional<cursor::type> cursor_type,
+         stdx::optional<std::uint32_t> max_await_time_ms)
+        : coll{coll},
+          options{std::move(options)},
+          options_bson{this->options.view()},
+          read_preference{std::move(read_preference)},
+          cursor_type{cursor_type},
+          max_await_time_ms{max_await_time_ms} {}
+
+    collection coll;
+
+    // The encoded options document, and a bson_t over it which is passed to libmongoc as is.
+    bsoncxx::document::value options;
+    libbson::scoped_bson_t options_bson;
+
+    stdx::optional<class read_preference> read_preference;
+    stdx::optional<cursor::type> cursor_type;
+    stdx::optional<std::uint32_t> max_await_time_ms;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
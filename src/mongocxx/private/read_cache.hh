@@ -0,0 +1,164 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <bsoncxx/compare.hpp>
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/types/bson_value/value.hpp>
+#include <mongocxx/change_stream.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/read_cache.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class read_cache::impl {
+   public:
+    // Orders ids as the server compares them, so that ids the server considers equal share an
+    // index entry.
+    struct id_less {
+        bool operator()(const bsoncxx::types::bson_value::value& lhs,
+                        const bsoncxx::types::bson_value::value& rhs) const {
+            return bsoncxx::compare(lhs.view(), rhs.view()) < 0;
+        }
+    };
+
+    struct entry {
+        // The result of find_one, or a disengaged optional if no document matched.
+        stdx::optional<bsoncxx::document::value> doc;
+
+        std::chrono::steady_clock::time_point expires_at;
+
+        // The bytes accounted against the budget for this entry.
+        std::size_t bytes;
+
+        std::list<std::string>::iterator lru_position;
+
+        // Whether the result depends on a sort or skip, and so on every document of the
+        // collection.
+        bool ordered;
+    };
+
+    using entries_map = std::unordered_map<std::string, entry>;
+
+    impl(class pool& pool,
+         std::string db_name,
+         std::string collection_name,
+         std::size_t max_bytes,
+         std::chrono::milliseconds ttl)
+        : pool(pool),
+          db_name(std::move(db_name)),
+          collection_name(std::move(collection_name)),
+          max_bytes(max_bytes),
+          ttl(ttl),
+          watch_client(pool.acquire()) {}
+
+    // The following member functions must be called with the mutex held.
+
+    // Returns the cached result for a key, or a disengaged optional if there is no entry for the
+    // key or the entry has expired.
+    stdx::optional<stdx::optional<bsoncxx::document::value>> lookup(const std::string& key);
+
+    // Caches a result, then evicts the least recently used entries beyond the byte budget.
+    void store(const std::string& key, stdx::optional<bsoncxx::document::value> doc, bool ordered);
+
+    void erase(entries_map::iterator it);
+
+    // Erases the entries with the given keys, counting them as invalidations.
+    void invalidate(const std::unordered_set<std::string>& keys);
+
+    void clear_entries();
+
+    // The following member functions are called from the watching thread only.
+
+    // Opens the change stream, with the watching client.
+    change_stream open_change_stream();
+
+    // Applies a change event to the cache. Returns true if the change stream must be reopened.
+    bool apply(bsoncxx::document::view event);
+
+    // The body of the watching thread.
+    void run();
+
+    class pool& pool;
+    const std::string db_name;
+    const std::string collection_name;
+    const std::size_t max_bytes;
+    const std::chrono::milliseconds ttl;
+
+    // Guards every member below, up to the statistics.
+    mutable std::mutex mutex;
+
+    entries_map entries;
+
+    // The keys of the entries, most recently used first.
+    std::list<std::string> lru;
+
+    // The keys of the entries holding each document, by _id.
+    std::map<bsoncxx::types::bson_value::value, std::unordered_set<std::string>, id_less> by_id;
+
+    // The keys of the entries which found no document, of the entries holding a document without
+    // an _id, which a projection left out, and of the entries whose result depends on a sort or
+    // skip.
+    std::unordered_set<std::string> negative_keys;
+    std::unordered_set<std::string> unindexed_keys;
+    std::unordered_set<std::string> ordered_keys;
+
+    std::size_t bytes = 0;
+
+    // Incremented whenever entries are invalidated, so that a result read from the server while a
+    // change was applied is not cached.
+    std::uint64_t generation = 0;
+
+    // Whether the change stream is open, without which nothing is served from or stored in the
+    // cache.
+    bool coherent = false;
+
+    bool stopping = false;
+    std::condition_variable stopping_changed;
+
+    std::atomic<std::int64_t> hits{0};
+    std::atomic<std::int64_t> misses{0};
+    std::atomic<std::int64_t> evictions{0};
+    std::atomic<std::int64_t> invalidations{0};
+
+    // The client and change stream used by the watching thread.
+    mongocxx::pool::entry watch_client;
+    stdx::optional<change_stream> stream;
+
+    std::thread watcher;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
@@ -0,0 +1,101 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/request_coalescer.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class request_coalescer::impl {
+   public:
+    // The reads in flight producing a result of type T, keyed by the encoding of the read. T is
+    // cheap to copy, either a scalar or a shared pointer to a result which every waiter shares.
+    template <typename T>
+    using in_flight = std::unordered_map<std::string, std::shared_future<T>>;
+
+    // Runs the read, or waits for the identical read already in flight, and returns its result.
+    // The first caller for a key runs the read without holding the lock and removes the key once
+    // the result is published, so that later calls go to the server again.
+    template <typename T, typename Read>
+    T run(in_flight<T>& reads, const std::string& key, Read&& read) {
+        std::promise<T> promise;
+        std::shared_future<T> result;
+        bool first = false;
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+
+            auto it = reads.find(key);
+            if (it != reads.end()) {
+                result = it->second;
+            } else {
+                result = promise.get_future().share();
+                reads.emplace(key, result);
+                first = true;
+            }
+        }
+
+        if (!first) {
+            ++hits;
+            return result.get();
+        }
+
+        ++misses;
+
+        try {
+            promise.set_value(read());
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            reads.erase(key);
+        }
+
+        return result.get();
+    }
+
+    // Returns the URI of the client through which a collection was obtained, which identifies the
+    // deployment and credentials its reads are sent with.
+    static const char* client_uri(const collection& coll);
+
+    std::mutex mutex;
+    in_flight<std::shared_ptr<const bsoncxx::document::value>> find_one_reads;
+    in_flight<std::int64_t> count_documents_reads;
+    in_flight<std::shared_ptr<const std::vector<bsoncxx::document::value>>> aggregate_reads;
+
+    std::atomic<std::int64_t> hits{0};
+    std::atomic<std::int64_t> misses{0};
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/private/postlude.hh>
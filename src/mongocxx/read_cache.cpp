@@ -0,0 +1,411 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <algorithm>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/error_code.hpp>
+#include <mongocxx/exception/exception.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/options/private/find.hh>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/private/read_cache.hh>
+#include <mongocxx/read_cache.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+const std::int64_t k_default_max_bytes = 64 * 1024 * 1024;
+const std::chrono::milliseconds k_default_ttl{60 * 1000};
+
+// Bounds how long the watching thread takes to notice that the cache is being destroyed.
+const std::chrono::milliseconds k_watch_max_await_time{500};
+
+// How long the watching thread waits before reopening a change stream which failed.
+const std::chrono::milliseconds k_watch_retry_delay{1000};
+
+// The bytes accounted for an entry in addition to its key and document.
+const std::size_t k_entry_overhead = 128;
+
+// Returns a copy of a filter with its top-level fields sorted by name. Top-level fields are
+// implicitly combined with $and, so their order does not change which documents match; the
+// order of fields within nested documents is significant and is left as is.
+bsoncxx::document::value normalize_filter(bsoncxx::document::view filter) {
+    std::vector<bsoncxx::document::element> fields{filter.begin(), filter.end()};
+    std::stable_sort(fields.begin(),
+                     fields.end(),
+                     [](const bsoncxx::document::element& lhs,
+                        const bsoncxx::document::element& rhs) { return lhs.key() < rhs.key(); });
+
+    bsoncxx::builder::basic::document builder;
+    for (const auto& field : fields) {
+        builder.append(kvp(field.key(), field.get_value()));
+    }
+    return builder.extract();
+}
+
+}  // namespace
+
+stdx::optional<stdx::optional<bsoncxx::document::value>> read_cache::impl::lookup(
+    const std::string& key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        return stdx::nullopt;
+    }
+
+    if (std::chrono::steady_clock::now() >= it->second.expires_at) {
+        erase(it);
+        ++evictions;
+        return stdx::nullopt;
+    }
+
+    lru.splice(lru.begin(), lru, it->second.lru_position);
+    return it->second.doc;
+}
+
+void read_cache::impl::store(const std::string& key,
+                             stdx::optional<bsoncxx::document::value> doc,
+                             bool ordered) {
+    // The key is held both by the map and by the LRU list.
+    const std::size_t entry_bytes =
+        2 * key.size() + (doc ? doc->view().length() : 0) + k_entry_overhead;
+    if (entry_bytes > max_bytes) {
+        return;
+    }
+
+    auto existing = entries.find(key);
+    if (existing != entries.end()) {
+        erase(existing);
+    }
+
+    lru.push_front(key);
+
+    entry e;
+    e.expires_at = std::chrono::steady_clock::now() + ttl;
+    e.bytes = entry_bytes;
+    e.lru_position = lru.begin();
+    e.ordered = ordered;
+
+    if (doc) {
+        const auto id = doc->view()["_id"];
+        if (id) {
+            by_id[bsoncxx::types::bson_value::value{id.get_value()}].insert(key);
+        } else {
+            unindexed_keys.insert(key);
+        }
+    } else {
+        negative_keys.insert(key);
+    }
+
+    if (ordered) {
+        ordered_keys.insert(key);
+    }
+
+    e.doc = std::move(doc);
+    entries.emplace(key, std::move(e));
+    bytes += entry_bytes;
+
+    while (bytes > max_bytes) {
+        erase(entries.find(lru.back()));
+        ++evictions;
+    }
+}
+
+void read_cache::impl::erase(entries_map::iterator it) {
+    const std::string& key = it->first;
+    entry& e = it->second;
+
+    if (e.doc) {
+        const auto id = e.doc->view()["_id"];
+        if (id) {
+            auto indexed = by_id.find(bsoncxx::types::bson_value::value{id.get_value()});
+            if (indexed != by_id.end()) {
+                indexed->second.erase(key);
+                if (indexed->second.empty()) {
+                    by_id.erase(indexed);
+                }
+            }
+        } else {
+            unindexed_keys.erase(key);
+        }
+    } else {
+        negative_keys.erase(key);
+    }
+
+    if (e.ordered) {
+        ordered_keys.erase(key);
+    }
+
+    lru.erase(e.lru_position);
+    bytes -= e.bytes;
+    entries.erase(it);
+}
+
+void read_cache::impl::invalidate(const std::unordered_set<std::string>& keys) {
+    // The keys are copied first, since erasing entries updates the sets they come from.
+    const std::vector<std::string> copy{keys.begin(), keys.end()};
+
+    for (const auto& key : copy) {
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            erase(it);
+            ++invalidations;
+        }
+    }
+}
+
+void read_cache::impl::clear_entries() {
+    entries.clear();
+    lru.clear();
+    by_id.clear();
+    negative_keys.clear();
+    unindexed_keys.clear();
+    ordered_keys.clear();
+    bytes = 0;
+}
+
+change_stream read_cache::impl::open_change_stream() {
+    // Only the kind of change and the _id of the changed document are needed.
+    pipeline stages;
+    stages.project(make_document(kvp("operationType", 1), kvp("documentKey", 1)));
+
+    options::change_stream options;
+    options.max_await_time(k_watch_max_await_time);
+
+    return (*watch_client)[db_name][collection_name].watch(stages, options);
+}
+
+bool read_cache::impl::apply(bsoncxx::document::view event) {
+    const auto operation_type = event["operationType"];
+    if (!operation_type || operation_type.type() != bsoncxx::type::k_string) {
+        return false;
+    }
+    const auto operation = operation_type.get_string().value;
+
+    std::lock_guard<std::mutex> lock{mutex};
+    ++generation;
+
+    if (operation == stdx::string_view{"insert"} || operation == stdx::string_view{"update"} ||
+        operation == stdx::string_view{"replace"} || operation == stdx::string_view{"delete"}) {
+        const auto id = event["documentKey"]["_id"];
+        if (id) {
+            auto indexed = by_id.find(bsoncxx::types::bson_value::value{id.get_value()});
+            if (indexed != by_id.end()) {
+                invalidate(indexed->second);
+            }
+        }
+
+        // Documents whose _id was projected out cannot be matched to the changed document.
+        invalidate(unindexed_keys);
+        invalidate(ordered_keys);
+
+        // A delete cannot make a document match a filter which matched none.
+        if (operation != stdx::string_view{"delete"}) {
+            invalidate(negative_keys);
+        }
+
+        return false;
+    }
+
+    // Any other event, such as a drop or rename of the collection, may affect every entry.
+    invalidations += static_cast<std::int64_t>(entries.size());
+    clear_entries();
+
+    if (operation == stdx::string_view{"invalidate"}) {
+        coherent = false;
+        return true;
+    }
+
+    return false;
+}
+
+void read_cache::impl::run() {
+    while (true) {
+        try {
+            if (!stream) {
+                stream = open_change_stream();
+
+                std::lock_guard<std::mutex> lock{mutex};
+                coherent = true;
+                ++generation;
+            }
+
+            bool reopen = false;
+            for (auto&& event : *stream) {
+                reopen = apply(event);
+
+                std::lock_guard<std::mutex> lock{mutex};
+                if (reopen || stopping) {
+                    break;
+                }
+            }
+
+            if (reopen) {
+                stream = stdx::nullopt;
+            }
+
+            std::lock_guard<std::mutex> lock{mutex};
+            if (stopping) {
+                return;
+            }
+        } catch (const mongocxx::exception&) {
+            // Changes may be missed until the change stream is reopened, so nothing cached can be
+            // trusted in the meantime.
+            stream = stdx::nullopt;
+
+            std::unique_lock<std::mutex> lock{mutex};
+            invalidations += static_cast<std::int64_t>(entries.size());
+            clear_entries();
+            coherent = false;
+            ++generation;
+
+            if (stopping_changed.wait_for(lock, k_watch_retry_delay, [&] { return stopping; })) {
+                return;
+            }
+        }
+    }
+}
+
+read_cache::read_cache(pool& pool,
+                       bsoncxx::string::view_or_value db_name,
+                       bsoncxx::string::view_or_value collection_name,
+                       const options::read_cache& options) {
+    const auto max_bytes = options.max_bytes().value_or(k_default_max_bytes);
+    if (max_bytes <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for options::read_cache::max_bytes()"};
+    }
+
+    const auto ttl = options.ttl().value_or(k_default_ttl);
+    if (ttl.count() <= 0) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "positive value required for options::read_cache::ttl()"};
+    }
+
+    _impl = stdx::make_unique<impl>(pool,
+                                    db_name.terminated().data(),
+                                    collection_name.terminated().data(),
+                                    static_cast<std::size_t>(max_bytes),
+                                    ttl);
+
+    // The change stream is opened before any read is cached, so that no change can be missed.
+    _impl->stream = _impl->open_change_stream();
+    _impl->coherent = true;
+
+    _impl->watcher = std::thread{[this] { _impl->run(); }};
+}
+
+read_cache::~read_cache() {
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+        _impl->stopping = true;
+    }
+    _impl->stopping_changed.notify_all();
+    _impl->watcher.join();
+}
+
+stdx::optional<bsoncxx::document::value> read_cache::find_one(
+    bsoncxx::document::view_or_value filter, const options::find& options) {
+    if (options.cursor_type() && *options.cursor_type() != cursor::type::k_non_tailable) {
+        throw logic_error{error_code::k_invalid_parameter,
+                          "tailable cursors cannot be used with read_cache"};
+    }
+
+    options::find limited{options};
+    limited.limit(1);
+
+    const auto normalized = normalize_filter(filter.view());
+    const auto encoded_options = options::build_find_options_document(limited).extract();
+
+    std::string key{reinterpret_cast<const char*>(normalized.view().data()),
+                    normalized.view().length()};
+    key.append(reinterpret_cast<const char*>(encoded_options.view().data()),
+               encoded_options.view().length());
+
+    std::uint64_t generation;
+    bool cacheable;
+    {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+
+        cacheable = _impl->coherent;
+        generation = _impl->generation;
+
+        if (cacheable) {
+            if (auto cached = _impl->lookup(key)) {
+                ++_impl->hits;
+                return std::move(*cached);
+            }
+        }
+    }
+
+    ++_impl->misses;
+
+    auto client = _impl->pool.acquire();
+    auto result =
+        (*client)[_impl->db_name][_impl->collection_name].find_one(normalized.view(), limited);
+
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock{_impl->mutex};
+
+        if (_impl->coherent && _impl->generation == generation) {
+            const bool ordered = options.sort() || options.skip();
+            _impl->store(key, result, ordered);
+        }
+    }
+
+    return result;
+}
+
+void read_cache::clear() {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    _impl->clear_entries();
+    ++_impl->generation;
+}
+
+std::int64_t read_cache::hits() const {
+    return _impl->hits.load();
+}
+
+std::int64_t read_cache::misses() const {
+    return _impl->misses.load();
+}
+
+std::int64_t read_cache::evictions() const {
+    return _impl->evictions.load();
+}
+
+std::int64_t read_cache::invalidations() const {
+    return _impl->invalidations.load();
+}
+
+std::int64_t read_cache::size_bytes() const {
+    std::lock_guard<std::mutex> lock{_impl->mutex};
+    return static_cast<std::int64_t>(_impl->bytes);
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,138 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <memory>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <bsoncxx/string/view_or_value.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/options/read_cache.hpp>
+#include <mongocxx/stdx.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+class pool;
+
+///
+/// Class caching the results of find_one on a collection which is read far more often than it is
+/// written.
+///
+/// Results are keyed by the filter, with its top-level fields sorted, and by the encoded find
+/// options. Entries are evicted in least recently used order beyond a byte budget and once their
+/// time to live has elapsed.
+///
+/// The cache stays coherent by tailing a change stream on the collection from a background
+/// thread. A change to a document evicts the entries holding it, the entries which found no
+/// document (unless the change is a delete) and the entries whose result depends on a sort or
+/// skip. Dropping or renaming the collection, an invalidate event or an error on the change
+/// stream clears the cache, and reads bypass it until the change stream is reopened. Results read
+/// while a change was being applied are not cached.
+///
+/// Misses are read with a client acquired from the pool. A read_cache is thread-safe and is meant
+/// to be shared by all the threads reading the collection.
+///
+class MONGOCXX_API read_cache {
+   public:
+    ///
+    /// Constructs a read_cache, opens its change stream and starts the thread tailing it.
+    ///
+    /// @param pool
+    ///   The pool from which clients are acquired. It must outlive the read_cache.
+    /// @param db_name
+    ///   The name of the database holding the collection.
+    /// @param collection_name
+    ///   The name of the collection to cache.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::read_cache.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    /// @throws mongocxx::operation_exception if the change stream cannot be opened.
+    ///
+    read_cache(pool& pool,
+               bsoncxx::string::view_or_value db_name,
+               bsoncxx::string::view_or_value collection_name,
+               const options::read_cache& options = {});
+
+    ///
+    /// Stops the thread tailing the change stream and destroys the cache.
+    ///
+    ~read_cache();
+
+    read_cache(const read_cache&) = delete;
+    read_cache& operator=(const read_cache&) = delete;
+
+    ///
+    /// Finds a single document, from the cache if an entry for the same filter and options is
+    /// present and has not expired, and from the server otherwise.
+    ///
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    /// @param options
+    ///   Optional arguments, see options::find. Tailable cursor types are not permitted.
+    ///
+    /// @return An optional document that matched the filter.
+    ///
+    /// @throws mongocxx::logic_error if the options are invalid.
+    /// @throws mongocxx::query_exception if the operation fails.
+    ///
+    stdx::optional<bsoncxx::document::value> find_one(bsoncxx::document::view_or_value filter,
+                                                      const options::find& options = {});
+
+    ///
+    /// Removes every entry from the cache.
+    ///
+    void clear();
+
+    ///
+    /// Returns the number of reads served from the cache.
+    ///
+    std::int64_t hits() const;
+
+    ///
+    /// Returns the number of reads sent to the server.
+    ///
+    std::int64_t misses() const;
+
+    ///
+    /// Returns the number of entries removed to honor the byte budget or because they expired.
+    ///
+    std::int64_t evictions() const;
+
+    ///
+    /// Returns the number of entries removed because of a change observed on the collection.
+    ///
+    std::int64_t invalidations() const;
+
+    ///
+    /// Returns the approximate number of bytes currently held by the cache.
+    ///
+    std::int64_t size_bytes() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
@@ -32,6 +32,8 @@ MONGOCXX_INLINE_NAMESPACE_BEGIN
 class client;
 class collection;
 class database;
+class prepared_aggregate;
+class prepared_find;
 class uri;
 
 namespace events {
@@ -269,6 +271,8 @@ class MONGOCXX_API read_preference {
     friend client;
     friend collection;
     friend database;
+    friend prepared_aggregate;
+    friend prepared_find;
     /// \relates mongocxx::options::transaction
     friend mongocxx::options::transaction;
     /// \relates mongocxx::events::topology_description
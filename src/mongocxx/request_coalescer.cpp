@@ -0,0 +1,190 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <mongocxx/config/private/prelude.hh>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/builder/basic/kvp.hpp>
+#include <bsoncxx/stdx/make_unique.hpp>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/options/private/find.hh>
+#include <mongocxx/private/client.hh>
+#include <mongocxx/private/collection.hh>
+#include <mongocxx/private/libmongoc.hh>
+#include <mongocxx/private/request_coalescer.hh>
+#include <mongocxx/read_concern.hpp>
+#include <mongocxx/read_preference.hpp>
+#include <mongocxx/request_coalescer.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+
+void append_document(std::string& key, bsoncxx::document::view doc) {
+    key.append(reinterpret_cast<const char*>(doc.data()), doc.length());
+}
+
+// Encodes everything that determines the result of a read: its kind, the deployment and
+// credentials it is sent to, as given by the URI of the collection's client, its namespace, the
+// read preference and read concern it is sent with, its filter or pipeline, and its options. Each
+// part is either null-terminated or a BSON document, which carries its own length, so that
+// distinct reads never share an encoding.
+std::string make_key(const char* kind,
+                     const char* client_uri,
+                     const std::string& database_name,
+                     const collection& coll,
+                     const stdx::optional<read_preference>& options_read_preference,
+                     bsoncxx::document::view filter,
+                     bsoncxx::document::view options) {
+    const auto rp = options_read_preference ? *options_read_preference : coll.read_preference();
+
+    bsoncxx::builder::basic::document rp_builder;
+    rp_builder.append(kvp("mode", static_cast<std::int32_t>(rp.mode())));
+    if (rp.tags()) {
+        rp_builder.append(kvp("tags", *rp.tags()));
+    }
+    if (rp.max_staleness()) {
+        rp_builder.append(kvp("maxStalenessSeconds",
+                              static_cast<std::int64_t>(rp.max_staleness()->count())));
+    }
+    if (rp.hedge()) {
+        rp_builder.append(kvp("hedge", *rp.hedge()));
+    }
+
+    std::string key{kind};
+    key.push_back('\0');
+    key.append(client_uri);
+    key.push_back('\0');
+    key.append(database_name);
+    key.push_back('\0');
+    key.append(coll.name().data(), coll.name().size());
+    key.push_back('\0');
+    const auto read_concern_level = coll.read_concern().acknowledge_string();
+    key.append(read_concern_level.data(), read_concern_level.size());
+    key.push_back('\0');
+    append_document(key, rp_builder.view());
+    append_document(key, filter);
+    append_document(key, options);
+
+    return key;
+}
+
+}  // namespace
+
+const char* request_coalescer::impl::client_uri(const collection& coll) {
+    return libmongoc::uri_get_string(
+        libmongoc::client_get_uri(coll._get_impl().client_impl->client_t));
+}
+
+request_coalescer::request_coalescer() : _impl{stdx::make_unique<impl>()} {}
+
+request_coalescer::~request_coalescer() = default;
+
+std::shared_ptr<const bsoncxx::document::value> request_coalescer::find_one(
+    collection& coll, bsoncxx::document::view_or_value filter, const options::find& options) {
+    const auto key = make_key("find_one",
+                              impl::client_uri(coll),
+                              coll._get_impl().database_name,
+                              coll,
+                              options.read_preference(),
+                              filter.view(),
+                              options::build_find_options_document(options).view());
+
+    return _impl->run(_impl->find_one_reads, key, [&] {
+        std::shared_ptr<const bsoncxx::document::value> found;
+        if (auto doc = coll.find_one(filter.view(), options)) {
+            found = std::make_shared<const bsoncxx::document::value>(std::move(*doc));
+        }
+        return found;
+    });
+}
+
+std::int64_t request_coalescer::count_documents(collection& coll,
+                                                bsoncxx::document::view_or_value filter,
+                                                const options::count& options) {
+    bsoncxx::builder::basic::document options_builder;
+
+    if (options.collation()) {
+        options_builder.append(kvp("collation", *options.collation()));
+    }
+
+    if (options.max_time()) {
+        options_builder.append(
+            kvp("maxTimeMS", bsoncxx::types::b_int64{options.max_time()->count()}));
+    }
+
+    if (options.hint()) {
+        options_builder.append(kvp("hint", options.hint()->to_value()));
+    }
+
+    if (options.skip()) {
+        options_builder.append(kvp("skip", *options.skip()));
+    }
+
+    if (options.limit()) {
+        options_builder.append(kvp("limit", *options.limit()));
+    }
+
+    const auto key = make_key("count_documents",
+                              impl::client_uri(coll),
+                              coll._get_impl().database_name,
+                              coll,
+                              options.read_preference(),
+                              filter.view(),
+                              options_builder.view());
+
+    return _impl->run(_impl->count_documents_reads, key, [&] {
+        return coll.count_documents(filter.view(), options);
+    });
+}
+
+std::shared_ptr<const std::vector<bsoncxx::document::value>> request_coalescer::aggregate(
+    collection& coll, const pipeline& pipeline, const options::aggregate& options) {
+    bsoncxx::builder::basic::document options_builder;
+    options.append(options_builder);
+
+    const auto key = make_key("aggregate",
+                              impl::client_uri(coll),
+                              coll._get_impl().database_name,
+                              coll,
+                              options.read_preference(),
+                              bsoncxx::document::view{pipeline.view_array()},
+                              options_builder.view());
+
+    return _impl->run(_impl->aggregate_reads, key, [&] {
+        auto results = std::make_shared<std::vector<bsoncxx::document::value>>();
+        for (auto&& doc : coll.aggregate(pipeline, options)) {
+            results->emplace_back(doc);
+        }
+        return std::shared_ptr<const std::vector<bsoncxx::document::value>>{std::move(results)};
+    });
+}
+
+std::int64_t request_coalescer::hits() const {
+    return _impl->hits.load();
+}
+
+std::int64_t request_coalescer::misses() const {
+    return _impl->misses.load();
+}
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
@@ -0,0 +1,150 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mongocxx/config/prelude.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <bsoncxx/document/value.hpp>
+#include <bsoncxx/document/view_or_value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/options/aggregate.hpp>
+#include <mongocxx/options/count.hpp>
+#include <mongocxx/options/find.hpp>
+#include <mongocxx/pipeline.hpp>
+
+namespace mongocxx {
+MONGOCXX_INLINE_NAMESPACE_BEGIN
+
+///
+/// Class coalescing identical reads issued concurrently from several threads.
+///
+/// When a read is requested while an identical read is already in flight, the caller waits for
+/// the in-flight read and shares its result, or receives the exception it raised, instead of
+/// sending its own request to the server. Documents are handed out through shared pointers, so
+/// that every waiter refers to the same result rather than to a copy of it. Two reads are
+/// identical when they are sent through clients with the same URI and target the same namespace
+/// with the same filter or pipeline, options, read preference and read concern; the comparison is
+/// made on their encoded bytes.
+///
+/// Each thread passes its own collection, for example one obtained from a client acquired from a
+/// mongocxx::pool, since the collection of the first caller is used to run the read. A
+/// request_coalescer itself is thread-safe and is meant to be shared by all the threads reading
+/// through it. Reads are only coalesced while they are in flight: no result is kept once it has
+/// been handed to its waiters.
+///
+class MONGOCXX_API request_coalescer {
+   public:
+    ///
+    /// Constructs a request_coalescer with no reads in flight.
+    ///
+    request_coalescer();
+
+    ///
+    /// Destroys a request_coalescer. No read may be in flight through it.
+    ///
+    ~request_coalescer();
+
+    request_coalescer(const request_coalescer&) = delete;
+    request_coalescer& operator=(const request_coalescer&) = delete;
+
+    ///
+    /// Finds a single document, sharing the result of an identical call already in flight.
+    ///
+    /// @param coll
+    ///   The collection to query, used only if no identical call is in flight.
+    /// @param filter
+    ///   Document view representing a document that should match the query.
+    /// @param options
+    ///   Optional arguments, see options::find
+    ///
+    /// @return
+    ///   The document that matched the filter, shared with the other callers of the same read, or
+    ///   null if no document matched.
+    ///
+    /// @throws mongocxx::query_exception if the operation fails.
+    ///
+    /// @see mongocxx::collection::find_one
+    ///
+    std::shared_ptr<const bsoncxx::document::value> find_one(
+        collection& coll,
+        bsoncxx::document::view_or_value filter,
+        const options::find& options = {});
+
+    ///
+    /// Counts the number of documents matching the provided filter, sharing the result of an
+    /// identical call already in flight.
+    ///
+    /// @param coll
+    ///   The collection to query, used only if no identical call is in flight.
+    /// @param filter
+    ///   The filter that documents must match in order to be counted.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::count.
+    ///
+    /// @return The count of the documents that matched the filter.
+    ///
+    /// @throws mongocxx::query_exception if the count operation fails.
+    ///
+    /// @see mongocxx::collection::count_documents
+    ///
+    std::int64_t count_documents(collection& coll,
+                                 bsoncxx::document::view_or_value filter,
+                                 const options::count& options = {});
+
+    ///
+    /// Runs an aggregation framework pipeline and returns all of its results, sharing the results
+    /// of an identical call already in flight.
+    ///
+    /// @param coll
+    ///   The collection to aggregate, used only if no identical call is in flight.
+    /// @param pipeline
+    ///   The pipeline of aggregation operations to perform.
+    /// @param options
+    ///   Optional arguments, see mongocxx::options::aggregate.
+    ///
+    /// @return
+    ///   The documents produced by the pipeline, shared with the other callers of the same read.
+    ///
+    /// @throws mongocxx::query_exception if the operation fails.
+    ///
+    /// @see mongocxx::collection::aggregate
+    ///
+    std::shared_ptr<const std::vector<bsoncxx::document::value>> aggregate(
+        collection& coll, const pipeline& pipeline, const options::aggregate& options = {});
+
+    ///
+    /// Returns the number of calls which shared the result of an identical call in flight.
+    ///
+    std::int64_t hits() const;
+
+    ///
+    /// Returns the number of calls which sent their own request to the server.
+    ///
+    std::int64_t misses() const;
+
+   private:
+    class MONGOCXX_PRIVATE impl;
+    std::unique_ptr<impl> _impl;
+};
+
+MONGOCXX_INLINE_NAMESPACE_END
+}  // namespace mongocxx
+
+#include <mongocxx/config/postlude.hpp>
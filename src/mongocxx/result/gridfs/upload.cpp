@@ -14,6 +14,8 @@
 
 #include <mongocxx/config/private/prelude.hh>
 
+#include <utility>
+
 #include <bsoncxx/builder/basic/array.hpp>
 #include <mongocxx/result/gridfs/upload.hpp>
 
@@ -22,15 +24,21 @@ MONGOCXX_INLINE_NAMESPACE_BEGIN
 namespace result {
 namespace gridfs {
 
-upload::upload(bsoncxx::types::bson_value::view id)
-    : _id_owned(bsoncxx::builder::basic::make_array(id)), _id(_id_owned.view()[0].get_value()) {}
+upload::upload(bsoncxx::types::bson_value::view id, stdx::optional<std::string> digest)
+    : _id_owned(bsoncxx::builder::basic::make_array(id)),
+      _id(_id_owned.view()[0].get_value()),
+      _digest(std::move(digest)) {}
 
 const bsoncxx::types::bson_value::view& upload::id() const {
     return _id;
 }
 
+const stdx::optional<std::string>& upload::digest() const {
+    return _digest;
+}
+
 bool MONGOCXX_CALL operator==(const upload& lhs, const upload& rhs) {
-    return lhs.id() == rhs.id();
+    return lhs.id() == rhs.id() && lhs.digest() == rhs.digest();
 }
 bool MONGOCXX_CALL operator!=(const upload& lhs, const upload& rhs) {
     return !(lhs == rhs);
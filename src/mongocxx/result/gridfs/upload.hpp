@@ -16,8 +16,12 @@
 
 #include <mongocxx/config/prelude.hpp>
 
+#include <string>
+
 #include <bsoncxx/array/value.hpp>
+#include <bsoncxx/stdx/optional.hpp>
 #include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/stdx.hpp>
 
 namespace mongocxx {
 MONGOCXX_INLINE_NAMESPACE_BEGIN
@@ -27,7 +31,7 @@ namespace gridfs {
 /// Class representing the result of a GridFS upload operation.
 class MONGOCXX_API upload {
    public:
-    upload(bsoncxx::types::bson_value::view id);
+    upload(bsoncxx::types::bson_value::view id, stdx::optional<std::string> digest = {});
 
     ///
     /// Gets the id of the uploaded GridFS file.
@@ -36,6 +40,15 @@ class MONGOCXX_API upload {
     ///
     const bsoncxx::types::bson_value::view& id() const;
 
+    ///
+    /// Gets the digest of the uploaded GridFS file, as a lowercase hex string.
+    ///
+    /// @return
+    ///   The digest computed with the algorithm set by options::gridfs::upload::digest(), or an
+    ///   unset optional if no digest was requested.
+    ///
+    const stdx::optional<std::string>& digest() const;
+
    private:
     // Array with a single element, containing the value of the _id field for the inserted files
     // collection document.
@@ -44,6 +57,8 @@ class MONGOCXX_API upload {
     // Points into _id_owned.
     bsoncxx::types::bson_value::view _id;
 
+    stdx::optional<std::string> _digest;
+
     friend MONGOCXX_API bool MONGOCXX_CALL operator==(const upload&, const upload&);
     friend MONGOCXX_API bool MONGOCXX_CALL operator!=(const upload&, const upload&);
 };
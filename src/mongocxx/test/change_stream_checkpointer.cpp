@@ -0,0 +1,155 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <system_error>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/change_stream_checkpointer.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// Resume tokens are opaque documents; any document stands in for one.
+bsoncxx::document::value token(std::int32_t n) {
+    return make_document(kvp("_data", std::to_string(n)));
+}
+
+TEST_CASE("change_stream_checkpointer persists to a file", "[change_stream_checkpointer]") {
+    const std::string path = "change_stream_checkpointer_test.bson";
+    std::remove(path.c_str());
+    std::remove((path + ".tmp").c_str());
+
+    options::change_stream_checkpointer options;
+    options.commit_interval(std::chrono::hours{1});
+
+    SECTION("the latest acknowledgement is persisted and loaded") {
+        {
+            change_stream_checkpointer checkpointer{path, options};
+            REQUIRE(!checkpointer.last_checkpoint());
+            REQUIRE(!checkpointer.resume_options().resume_after());
+
+            checkpointer.acknowledge(token(1), 1);
+            checkpointer.acknowledge(token(3), 3);
+            // Acknowledgements arriving late from another worker are ignored.
+            checkpointer.acknowledge(token(2), 2);
+            checkpointer.flush();
+
+            REQUIRE(checkpointer.last_checkpoint()->sequence == 3);
+            REQUIRE(checkpointer.last_checkpoint()->resume_token.view() == token(3).view());
+        }
+
+        change_stream_checkpointer reloaded{path, options};
+        REQUIRE(reloaded.last_checkpoint()->sequence == 3);
+        REQUIRE(reloaded.resume_options().resume_after()->view() == token(3).view());
+    }
+
+    SECTION("destruction persists the latest acknowledgement") {
+        {
+            change_stream_checkpointer checkpointer{path, options};
+            checkpointer.acknowledge(token(5), 5);
+        }
+
+        change_stream_checkpointer reloaded{path, options};
+        REQUIRE(reloaded.last_checkpoint()->sequence == 5);
+    }
+
+    SECTION("close persists the latest acknowledgement and reports its failure") {
+        {
+            change_stream_checkpointer checkpointer{path, options};
+            checkpointer.acknowledge(token(7), 7);
+            checkpointer.close();
+            checkpointer.close();
+            REQUIRE_THROWS_AS(checkpointer.flush(), logic_error);
+        }
+
+        change_stream_checkpointer reloaded{path, options};
+        REQUIRE(reloaded.last_checkpoint()->sequence == 7);
+
+        change_stream_checkpointer unwritable{"missing_directory/checkpoint.bson", options};
+        unwritable.acknowledge(token(8), 8);
+        REQUIRE_THROWS_AS(unwritable.close(), std::system_error);
+        REQUIRE(!unwritable.last_checkpoint());
+    }
+
+    SECTION("a restarted consumer may number its acknowledgements from zero") {
+        {
+            change_stream_checkpointer checkpointer{path, options};
+            checkpointer.acknowledge(token(9), 9);
+        }
+
+        change_stream_checkpointer restarted{path, options};
+        restarted.acknowledge(token(10), 0);
+        restarted.flush();
+        REQUIRE(restarted.last_checkpoint()->resume_token.view() == token(10).view());
+    }
+
+    SECTION("a file without a checkpoint is rejected") {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        std::fputs("not bson", file);
+        std::fclose(file);
+
+        REQUIRE_THROWS_AS((change_stream_checkpointer{path, options}), logic_error);
+    }
+
+    SECTION("invalid options are rejected") {
+        options.commit_interval(std::chrono::milliseconds{0});
+        REQUIRE_THROWS_AS((change_stream_checkpointer{path, options}), logic_error);
+    }
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("change_stream_checkpointer persists to a collection", "[change_stream_checkpointer]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+    auto coll = (*client)["change_stream_checkpointer"]["checkpoints"];
+    coll.drop();
+
+    options::change_stream_checkpointer options;
+    options.commit_interval(std::chrono::milliseconds{10});
+
+    {
+        change_stream_checkpointer checkpointer{
+            pool, "change_stream_checkpointer", "checkpoints", "consumer", options};
+        REQUIRE(!checkpointer.last_checkpoint());
+
+        checkpointer.acknowledge(token(7), 7);
+        checkpointer.flush();
+    }
+
+    auto doc = coll.find_one(make_document(kvp("_id", "consumer")));
+    REQUIRE(doc);
+    REQUIRE(doc->view()["sequence"].get_int64().value == 7);
+    REQUIRE(coll.count_documents({}) == 1);
+
+    change_stream_checkpointer reloaded{
+        pool, "change_stream_checkpointer", "checkpoints", "consumer", options};
+    REQUIRE(reloaded.last_checkpoint()->resume_token.view() == token(7).view());
+}
+
+}  // namespace
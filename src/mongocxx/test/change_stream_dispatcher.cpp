@@ -0,0 +1,181 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/change_stream_dispatcher.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// Notifications are handled asynchronously; polls a condition for a few seconds.
+bool eventually(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    return false;
+}
+
+TEST_CASE("change_stream_dispatcher keeps notifications about a document in order",
+          "[change_stream_dispatcher]") {
+    instance::current();
+
+    client client{uri{}};
+
+    if (!test_util::is_replica_set(client)) {
+        WARN("skip: change streams require replica set");
+        return;
+    }
+
+    auto coll = client["change_stream_dispatcher"]["events"];
+    coll.drop();
+    coll.insert_one(make_document(kvp("_id", -1)));
+
+    options::change_stream stream_options;
+    stream_options.max_await_time(std::chrono::milliseconds{200});
+
+    options::change_stream_dispatcher options;
+    options.workers(3).max_queued_events(4).max_wait(std::chrono::milliseconds{20});
+
+    SECTION("every notification is handled once, in order per document") {
+        const std::int32_t documents = 8;
+        const std::int32_t updates = 5;
+
+        std::mutex mutex;
+        std::map<std::int32_t, std::vector<std::int32_t>> seen;
+        std::int32_t handled = 0;
+
+        change_stream_dispatcher dispatcher{
+            coll.watch(stream_options),
+            [&](bsoncxx::document::view event) {
+                // Give the other workers a chance to overtake this one.
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+                const auto id = event["documentKey"]["_id"].get_int32().value;
+                std::int32_t n = -1;
+                if (event["fullDocument"]) {
+                    n = event["fullDocument"]["n"].get_int32().value;
+                } else {
+                    n = event["updateDescription"]["updatedFields"]["n"].get_int32().value;
+                }
+
+                std::lock_guard<std::mutex> lock{mutex};
+                seen[id].push_back(n);
+                ++handled;
+            },
+            options};
+
+        for (std::int32_t n = 0; n < updates; ++n) {
+            for (std::int32_t id = 0; id < documents; ++id) {
+                if (n == 0) {
+                    coll.insert_one(make_document(kvp("_id", id), kvp("n", n)));
+                } else {
+                    coll.update_one(make_document(kvp("_id", id)),
+                                    make_document(kvp("$set", make_document(kvp("n", n)))));
+                }
+            }
+        }
+
+        REQUIRE(eventually([&] {
+            std::lock_guard<std::mutex> lock{mutex};
+            return handled == documents * updates;
+        }));
+
+        for (std::int32_t id = 0; id < documents; ++id) {
+            REQUIRE(seen[id] == (std::vector<std::int32_t>{0, 1, 2, 3, 4}));
+        }
+
+        // Once everything has been handled, the watermark reaches the end of the stream.
+        REQUIRE(eventually([&] { return static_cast<bool>(dispatcher.low_watermark()); }));
+        const auto watermark = *dispatcher.low_watermark();
+        dispatcher.rethrow_if_failed();
+
+        coll.insert_one(make_document(kvp("_id", documents)));
+
+        options::change_stream resume_options;
+        resume_options.resume_after(watermark.resume_token.view());
+        resume_options.max_await_time(std::chrono::milliseconds{200});
+
+        auto resumed = coll.watch(resume_options);
+        std::vector<bsoncxx::document::value> events;
+        REQUIRE(eventually([&] {
+            for (auto&& event : resumed.next_batch(10, std::chrono::milliseconds{100})) {
+                events.push_back(std::move(event));
+            }
+            return !events.empty();
+        }));
+
+        // Updates handled before the watermark was read may be delivered again, but the new
+        // document is never skipped.
+        REQUIRE(events.back().view()["documentKey"]["_id"].get_int32().value == documents);
+    }
+
+    SECTION("a failing handler stops the dispatcher") {
+        change_stream_dispatcher dispatcher{
+            coll.watch(stream_options),
+            [](bsoncxx::document::view) { throw std::runtime_error{"handler failed"}; },
+            options};
+
+        coll.insert_one(make_document(kvp("_id", 1)));
+
+        REQUIRE(eventually([&] {
+            try {
+                dispatcher.rethrow_if_failed();
+                return false;
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+        }));
+    }
+
+    SECTION("invalid options are rejected") {
+        SECTION("workers") {
+            options.workers(0);
+        }
+        SECTION("max_queued_events") {
+            options.max_queued_events(0);
+        }
+        SECTION("max_wait") {
+            options.max_wait(std::chrono::milliseconds{-1});
+        }
+
+        REQUIRE_THROWS_AS((change_stream_dispatcher{
+                              coll.watch(stream_options), [](bsoncxx::document::view) {}, options}),
+                          logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,179 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/exception/exception.hpp>
+#include <bsoncxx/string/to_string.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/change_stream_hub.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// Events are delivered asynchronously; polls a condition for a few seconds.
+bool eventually(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    return false;
+}
+
+std::vector<change_stream_hub::event> take(change_stream_hub::subscription& subscription,
+                                           std::size_t count) {
+    std::vector<change_stream_hub::event> events;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (events.size() < count && std::chrono::steady_clock::now() < deadline) {
+        if (auto next = subscription.next(std::chrono::milliseconds{100})) {
+            events.push_back(std::move(next));
+        }
+    }
+    return events;
+}
+
+std::string kind(const change_stream_hub::event& event) {
+    return bsoncxx::string::to_string(
+        event->view()["fullDocument"]["kind"].get_string().value);
+}
+
+TEST_CASE("change_stream_hub fans one change stream out to subscribers", "[change_stream_hub]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+
+    if (!test_util::is_replica_set(*client)) {
+        WARN("skip: change streams require replica set");
+        return;
+    }
+
+    auto coll = (*client)["change_stream_hub"]["events"];
+    coll.drop();
+    coll.insert_one(make_document(kvp("kind", "setup")));
+
+    options::change_stream options;
+    options.max_await_time(std::chrono::milliseconds{100});
+
+    change_stream_hub hub{pool, "change_stream_hub", "events", options};
+
+    SECTION("each subscriber receives the events matching its filter") {
+        auto inserts = hub.subscribe(make_document(kvp("operationType", "insert")));
+        auto kind_b = hub.subscribe(make_document(kvp("fullDocument.kind", "b")));
+
+        coll.insert_one(make_document(kvp("kind", "a")));
+        coll.insert_one(make_document(kvp("kind", "b")));
+        coll.insert_one(make_document(kvp("kind", "a")));
+
+        const auto all = take(inserts, 3);
+        REQUIRE(all.size() == 3);
+        REQUIRE(kind(all[0]) == "a");
+        REQUIRE(kind(all[1]) == "b");
+        REQUIRE(kind(all[2]) == "a");
+
+        const auto only_b = take(kind_b, 1);
+        REQUIRE(only_b.size() == 1);
+
+        // Events delivered to several subscribers are shared, not copied.
+        REQUIRE(only_b[0].get() == all[1].get());
+
+        REQUIRE(!kind_b.next(std::chrono::milliseconds{200}));
+        hub.rethrow_if_failed();
+    }
+
+    SECTION("a subscriber joining later keeps the others' events flowing") {
+        auto first = hub.subscribe(make_document(kvp("fullDocument.kind", "a")));
+        coll.insert_one(make_document(kvp("kind", "a")));
+        REQUIRE(take(first, 1).size() == 1);
+
+        auto second = hub.subscribe(make_document(kvp("fullDocument.kind", "b")));
+        coll.insert_one(make_document(kvp("kind", "b")));
+        coll.insert_one(make_document(kvp("kind", "a")));
+
+        REQUIRE(take(second, 1).size() == 1);
+        const auto rest = take(first, 1);
+        REQUIRE(rest.size() == 1);
+        REQUIRE(kind(rest[0]) == "a");
+    }
+
+    SECTION("k_drop_oldest keeps the latest events") {
+        auto subscription = hub.subscribe(
+            make_document(), 2, change_stream_hub::overflow_policy::k_drop_oldest);
+
+        for (int i = 0; i < 5; ++i) {
+            coll.insert_one(make_document(kvp("kind", std::to_string(i))));
+        }
+
+        REQUIRE(eventually([&] { return subscription.dropped() == 3; }));
+        REQUIRE(kind(subscription.next(std::chrono::milliseconds{0})) == "3");
+        REQUIRE(kind(subscription.next(std::chrono::milliseconds{0})) == "4");
+    }
+
+    SECTION("k_disconnect disconnects a slow subscriber") {
+        auto slow = hub.subscribe(
+            make_document(), 1, change_stream_hub::overflow_policy::k_disconnect);
+        auto fast = hub.subscribe(make_document());
+
+        for (int i = 0; i < 3; ++i) {
+            coll.insert_one(make_document(kvp("kind", std::to_string(i))));
+        }
+
+        REQUIRE(take(fast, 3).size() == 3);
+        REQUIRE(slow.disconnected());
+        REQUIRE(!fast.disconnected());
+
+        // The events queued before the disconnection can still be taken.
+        REQUIRE(kind(slow.next(std::chrono::milliseconds{0})) == "0");
+        REQUIRE(!slow.next(std::chrono::milliseconds{0}));
+    }
+
+    SECTION("filters may use query operators") {
+        auto large = hub.subscribe(
+            make_document(kvp("fullDocument.n", make_document(kvp("$gt", 1)))));
+
+        coll.insert_one(make_document(kvp("kind", "small"), kvp("n", 1)));
+        coll.insert_one(make_document(kvp("kind", "large"), kvp("n", 2)));
+
+        const auto events = take(large, 1);
+        REQUIRE(events.size() == 1);
+        REQUIRE(kind(events[0]) == "large");
+        REQUIRE(!large.next(std::chrono::milliseconds{200}));
+    }
+
+    SECTION("unsupported filters are rejected") {
+        REQUIRE_THROWS_AS(hub.subscribe(make_document(kvp("$where", "true"))),
+                          bsoncxx::exception);
+        REQUIRE_THROWS_AS(hub.subscribe(make_document(), 0), logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,111 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/change_stream_prefetcher.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/options/change_stream.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("change_stream_prefetcher delivers every notification in order",
+          "[change_stream_prefetcher]") {
+    instance::current();
+
+    client client{uri{}};
+
+    if (!test_util::is_replica_set(client)) {
+        WARN("skip: change streams require replica set");
+        return;
+    }
+
+    auto coll = client["change_stream_prefetcher"]["events"];
+    coll.drop();
+    coll.insert_one(make_document(kvp("_id", -1)));
+
+    options::change_stream stream_options;
+    stream_options.max_await_time(std::chrono::milliseconds{200});
+
+    SECTION("notifications arrive in batches with a resume token") {
+        options::change_stream_prefetcher options;
+        options.max_batch_size(4).max_wait(std::chrono::milliseconds{50}).max_queued_batches(2);
+
+        change_stream_prefetcher prefetcher{coll.watch(stream_options), options};
+
+        std::vector<bsoncxx::document::value> docs;
+        for (std::int32_t i = 0; i < 10; ++i) {
+            docs.push_back(make_document(kvp("_id", i)));
+        }
+        coll.insert_many(docs);
+
+        std::vector<std::int32_t> ids;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while (ids.size() < docs.size() && std::chrono::steady_clock::now() < deadline) {
+            auto batch = prefetcher.next_batch(std::chrono::milliseconds{500});
+            if (!batch) {
+                continue;
+            }
+
+            REQUIRE(batch->events.size() <= 4);
+            REQUIRE(batch->resume_token);
+
+            for (auto&& event : batch->events) {
+                ids.push_back(event.view()["documentKey"]["_id"].get_int32().value);
+            }
+        }
+
+        REQUIRE(ids == (std::vector<std::int32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    }
+
+    SECTION("destruction waits at most for the request in progress") {
+        const auto start = std::chrono::steady_clock::now();
+        {
+            change_stream_prefetcher prefetcher{coll.watch(stream_options)};
+            REQUIRE(!prefetcher.next_batch(std::chrono::milliseconds{100}));
+        }
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds{5});
+    }
+
+    SECTION("invalid options are rejected") {
+        options::change_stream_prefetcher options;
+
+        SECTION("max_batch_size") {
+            options.max_batch_size(0);
+        }
+        SECTION("max_wait") {
+            options.max_wait(std::chrono::milliseconds{-1});
+        }
+        SECTION("max_queued_batches") {
+            options.max_queued_batches(0);
+        }
+
+        REQUIRE_THROWS_AS((change_stream_prefetcher{coll.watch(stream_options), options}),
+                          logic_error);
+    }
+}
+
+}  // namespace
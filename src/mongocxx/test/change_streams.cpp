@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
 #include <iostream>
 
 #include <bsoncxx/builder/basic/document.hpp>
@@ -287,6 +288,31 @@ TEST_CASE("Mock streams and error-handling") {
         }
     }
 
+    SECTION("next_batch returns at most max events and stops when none are left") {
+        // Callbacks are taken from the top of the stack: three events, then none forever.
+        change_stream_next->interpose(gen_next(false)).forever();
+        change_stream_error_document->interpose(gen_error(false)).forever();
+        change_stream_next->interpose(gen_next(true)).times(3);
+
+        auto first = stream.next_batch(2, std::chrono::seconds{10});
+        REQUIRE(first.size() == 2);
+        REQUIRE(first[0].view() == make_document(kvp("some", "doc")).view());
+
+        auto second = stream.next_batch(2, std::chrono::seconds{10});
+        REQUIRE(second.size() == 1);
+
+        REQUIRE(stream.next_batch(2, std::chrono::seconds{10}).empty());
+        REQUIRE(stream.begin() == stream.end());
+    }
+
+    SECTION("next_batch throws on error") {
+        change_stream_next->interpose(gen_next(false)).forever();
+        change_stream_error_document->interpose(gen_error(true)).forever();
+
+        REQUIRE_THROWS(stream.next_batch(2, std::chrono::seconds{10}));
+        REQUIRE(stream.next_batch(2, std::chrono::seconds{10}).empty());
+    }
+
     SECTION("Pipeline and opts are passed for all watch helpers") {
         bsoncxx::types::b_timestamp ts{1, 2};
         std::int32_t batch_size = 3;
@@ -15,29 +15,40 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <functional>
+#include <iterator>
 #include <numeric>
+#include <random>
 #include <sstream>
+#include <string>
+#include <system_error>
 #include <vector>
 
 #include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/basic/kvp.hpp>
 #include <bsoncxx/document/value.hpp>
 #include <bsoncxx/oid.hpp>
+#include <bsoncxx/string/to_string.hpp>
 #include <bsoncxx/test_util/catch.hh>
 #include <bsoncxx/types.hpp>
 #include <bsoncxx/types/bson_value/view.hpp>
 #include <mongocxx/client.hpp>
 #include <mongocxx/database.hpp>
+#include <mongocxx/exception/bulk_write_exception.hpp>
+#include <mongocxx/exception/error_code.hpp>
 #include <mongocxx/exception/gridfs_exception.hpp>
 #include <mongocxx/exception/logic_error.hpp>
 #include <mongocxx/gridfs/bucket.hpp>
 #include <mongocxx/instance.hpp>
 #include <mongocxx/options/find.hpp>
+#include <mongocxx/options/gridfs/bucket.hpp>
+#include <mongocxx/options/gridfs/download.hpp>
 #include <mongocxx/options/gridfs/upload.hpp>
 #include <mongocxx/options/index.hpp>
+#include <mongocxx/pool.hpp>
 #include <mongocxx/uri.hpp>
 
 namespace {
@@ -738,6 +749,778 @@ TEST_CASE("gridfs upload/download round trip", "[gridfs::uploader] [gridfs::down
     REQUIRE(uploaded_bytes == downloaded_bytes);
 }
 
+TEST_CASE("gridfs::uploader with a flush pool inserts chunks in the background",
+          "[gridfs::uploader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_upload_flush_pool_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    // A batch holds 16 chunks of this size, so the file is sent as two batches.
+    constexpr std::int32_t chunk_size = 1000 * 1000;
+    constexpr std::size_t file_length = 20 * chunk_size;
+
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < file_length; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(i % 251));
+    }
+
+    auto upload_options = options::gridfs::upload{}.chunk_size_bytes(chunk_size).flush_pool(&pool);
+
+    bsoncxx::types::b_oid id = {bsoncxx::oid{}};
+    auto uploader = bucket.open_upload_stream_with_id(
+        bsoncxx::types::bson_value::view{id}, "file", upload_options);
+
+    SECTION("the file is complete once the uploader is closed") {
+        uploader.write(bytes.data(), bytes.size());
+        auto result = uploader.close();
+
+        validate_gridfs_file(db, "fs", result.id(), "file", bytes, chunk_size);
+    }
+
+    SECTION("abort removes the chunks inserted in the background") {
+        uploader.write(bytes.data(), bytes.size());
+        uploader.abort();
+
+        REQUIRE(!db["fs.files"].find_one({}));
+        REQUIRE(!db["fs.chunks"].find_one({}));
+    }
+
+    SECTION("an error inserting a batch is reported by close") {
+        // The unique index on the chunks collection rejects the first batch.
+        db["fs.chunks"].insert_one(make_document(kvp("files_id", id), kvp("n", 0)));
+
+        uploader.write(bytes.data(), bytes.size());
+        REQUIRE_THROWS_AS(uploader.close(), bulk_write_exception);
+
+        REQUIRE(!db["fs.files"].find_one({}));
+    }
+}
+
+TEST_CASE("gridfs::downloader with a fetch pool reads windows fetched concurrently",
+          "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_download_fetch_pool_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    // 143 chunks, the last of which is partial.
+    constexpr std::int32_t chunk_size = 7;
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(i % 251));
+    }
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(bytes.data(), bytes.size());
+    auto id = uploader.close().id();
+
+    auto download_options =
+        options::gridfs::download{}.fetch_pool(&pool).workers(3).window_chunks(10);
+
+    SECTION("the chunks are read in order") {
+        auto downloader = bucket.open_download_stream(id, download_options);
+
+        std::vector<std::uint8_t> downloaded(bytes.size());
+        std::size_t offset = 0;
+        std::size_t bytes_read;
+        while ((bytes_read = downloader.read(downloaded.data() + offset,
+                                             std::min<std::size_t>(33, bytes.size() - offset)))) {
+            offset += bytes_read;
+        }
+
+        REQUIRE(offset == bytes.size());
+        REQUIRE(downloaded == bytes);
+
+        std::uint8_t c;
+        REQUIRE(downloader.read(&c, 1) == 0);
+    }
+
+    SECTION("download_to_stream uses the options") {
+        std::ostringstream oss;
+        bucket.download_to_stream(id, &oss, download_options);
+
+        REQUIRE(oss.str() == std::string(bytes.begin(), bytes.end()));
+    }
+
+    SECTION("a missing chunk is reported as corruption") {
+        db["fs.chunks"].delete_one(make_document(kvp("files_id", id), kvp("n", 55)));
+
+        auto downloader = bucket.open_download_stream(id, download_options);
+        std::vector<std::uint8_t> downloaded(bytes.size());
+        REQUIRE_THROWS_AS(downloader.read(downloaded.data(), downloaded.size()), gridfs_exception);
+    }
+
+    SECTION("closing before the end stops fetching") {
+        auto downloader = bucket.open_download_stream(id, download_options);
+
+        std::uint8_t c;
+        REQUIRE(downloader.read(&c, 1) == 1);
+        downloader.close();
+    }
+
+    SECTION("invalid options are rejected") {
+        REQUIRE_THROWS_AS(bucket.open_download_stream(id, options::gridfs::download{}.workers(0)),
+                          logic_error);
+        REQUIRE_THROWS_AS(
+            bucket.open_download_stream(id, options::gridfs::download{}.window_chunks(-1)),
+            logic_error);
+    }
+}
+
+TEST_CASE("gridfs::downloader::seek and read_at read from arbitrary offsets",
+          "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_download_seek_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    constexpr std::int32_t chunk_size = 7;
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(i % 251));
+    }
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(bytes.data(), bytes.size());
+    auto id = uploader.close().id();
+
+    auto expected = [&](std::size_t offset, std::size_t length) {
+        return std::vector<std::uint8_t>(bytes.begin() + static_cast<std::ptrdiff_t>(offset),
+                                         bytes.begin() + static_cast<std::ptrdiff_t>(offset) +
+                                             static_cast<std::ptrdiff_t>(length));
+    };
+
+    options::gridfs::download download_options;
+
+    auto run_test = [&]() {
+        auto downloader = bucket.open_download_stream(id, download_options);
+        std::vector<std::uint8_t> buffer(20);
+
+        REQUIRE(downloader.read_at(500, buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(500, 20));
+
+        // Reading continues after the bytes read.
+        REQUIRE(downloader.read(buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(520, 20));
+
+        // Seeking backwards, within the current chunk, and back to a chunk left by a seek.
+        REQUIRE(downloader.read_at(3, buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(3, 20));
+        REQUIRE(downloader.read_at(22, buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(22, 20));
+        REQUIRE(downloader.read_at(501, buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(501, 20));
+        REQUIRE(downloader.read_at(540, buffer.data(), 20) == 20);
+        REQUIRE(buffer == expected(540, 20));
+
+        REQUIRE(downloader.read_at(990, buffer.data(), 20) == 10);
+        buffer.resize(10);
+        REQUIRE(buffer == expected(990, 10));
+
+        downloader.seek(1000);
+        REQUIRE(downloader.read(buffer.data(), 10) == 0);
+
+        REQUIRE_THROWS_AS(downloader.seek(1001), logic_error);
+        REQUIRE_THROWS_AS(downloader.seek(-1), logic_error);
+    };
+
+    SECTION("with a single query") {
+        run_test();
+    }
+
+    SECTION("without a cache") {
+        download_options.cached_chunks(0);
+        run_test();
+    }
+
+    SECTION("with a fetch pool") {
+        download_options.fetch_pool(&pool).workers(2).window_chunks(10);
+        run_test();
+    }
+}
+
+TEST_CASE("gridfs::downloader::next_chunk reads chunks without copying",
+          "[gridfs::downloader]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_download_next_chunk_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    constexpr std::int32_t chunk_size = 7;
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < 100; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(200 - i));
+    }
+
+    auto uploader =
+        bucket.open_upload_stream("file", options::gridfs::upload{}.chunk_size_bytes(chunk_size));
+    uploader.write(bytes.data(), bytes.size());
+    auto id = uploader.close().id();
+
+    SECTION("each view holds the rest of the current chunk") {
+        auto downloader = bucket.open_download_stream(id);
+
+        std::uint8_t c;
+        REQUIRE(downloader.read(&c, 3) == 3);
+
+        std::vector<std::uint8_t> downloaded{bytes.begin(), bytes.begin() + 3};
+        std::vector<std::size_t> sizes;
+        for (auto chunk = downloader.next_chunk(); chunk.size; chunk = downloader.next_chunk()) {
+            sizes.push_back(chunk.size);
+            downloaded.insert(downloaded.end(), chunk.data, chunk.data + chunk.size);
+        }
+
+        REQUIRE(downloaded == bytes);
+        REQUIRE(sizes.size() == 15);
+        REQUIRE(sizes.front() == 4);
+        REQUIRE(sizes.back() == 2);
+    }
+
+#if !defined(_WIN32)
+    SECTION("download_to_fd writes the file to a file descriptor") {
+        std::FILE* file = std::tmpfile();
+        REQUIRE(file);
+
+        bucket.download_to_fd(id, fileno(file));
+
+        std::vector<std::uint8_t> downloaded(bytes.size() + 1);
+        std::rewind(file);
+        REQUIRE(std::fread(downloaded.data(), 1, downloaded.size(), file) == bytes.size());
+        downloaded.pop_back();
+        REQUIRE(downloaded == bytes);
+
+        std::fclose(file);
+    }
+#endif
+}
+
+TEST_CASE("gridfs::bucket::upload_from_file and download_to_file work", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_bucket_file_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    const std::string source_path = "gridfs_bucket_file_test_source.bin";
+    const std::string destination_path = "gridfs_bucket_file_test_destination.bin";
+
+    constexpr std::int32_t chunk_size = 5;
+    std::vector<std::uint8_t> bytes;
+    for (std::size_t i = 0; i < 103; ++i) {
+        bytes.push_back(static_cast<std::uint8_t>(i * 3));
+    }
+
+    {
+        std::ofstream source{source_path, std::ios::binary};
+        source.write(reinterpret_cast<const char*>(bytes.data()),
+                     static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::vector<std::int64_t> upload_progress;
+    options::gridfs::upload upload_options;
+    upload_options.chunk_size_bytes(chunk_size).on_progress(
+        [&](std::int64_t done, std::int64_t total) {
+            REQUIRE(total == static_cast<std::int64_t>(bytes.size()));
+            upload_progress.push_back(done);
+        });
+
+    auto id = bucket.upload_from_file("file", source_path, upload_options).id();
+    std::remove(source_path.c_str());
+
+    validate_gridfs_file(db, "fs", id, "file", bytes, chunk_size);
+    REQUIRE(upload_progress == (std::vector<std::int64_t>{103}));
+
+    const auto read_destination = [&] {
+        std::ifstream destination{destination_path, std::ios::binary};
+        return std::vector<std::uint8_t>{std::istreambuf_iterator<char>{destination},
+                                         std::istreambuf_iterator<char>{}};
+    };
+
+    std::vector<std::int64_t> download_progress;
+    options::gridfs::download download_options;
+    download_options.on_progress([&](std::int64_t done, std::int64_t total) {
+        REQUIRE(total == static_cast<std::int64_t>(bytes.size()));
+        download_progress.push_back(done);
+    });
+
+    SECTION("chunks are written in order") {
+        bucket.download_to_file(id, destination_path, download_options);
+
+        REQUIRE(read_destination() == bytes);
+        REQUIRE(download_progress.size() == 21);
+        REQUIRE(download_progress.back() == 103);
+    }
+
+    SECTION("windows fetched concurrently are written at their offsets") {
+        download_options.fetch_pool(&pool).workers(3).window_chunks(2);
+        bucket.download_to_file(id, destination_path, download_options);
+
+        REQUIRE(read_destination() == bytes);
+        REQUIRE(download_progress.size() == 11);
+        REQUIRE(download_progress.back() == 103);
+    }
+
+    SECTION("an empty file is uploaded and downloaded") {
+        {
+            std::ofstream source{source_path, std::ios::binary};
+        }
+
+        auto empty_id = bucket.upload_from_file("empty", source_path).id();
+        std::remove(source_path.c_str());
+
+        bucket.download_to_file(empty_id, destination_path);
+        REQUIRE(read_destination().empty());
+    }
+
+    SECTION("a missing source file is reported") {
+        REQUIRE_THROWS_AS(bucket.upload_from_file("missing", "gridfs_bucket_file_test_missing.bin"),
+                          std::system_error);
+    }
+
+    std::remove(destination_path.c_str());
+}
+
+TEST_CASE("gridfs::uploader computes digests and the downloader verifies them",
+          "[gridfs::uploader]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_upload_digest_test"];
+    gridfs::bucket bucket = db.gridfs_bucket();
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    using digest_algorithm = options::gridfs::upload::digest_algorithm;
+
+    struct expected_digest {
+        digest_algorithm algorithm;
+        std::string field;
+        std::string contents;
+        std::string digest;
+    };
+
+    const std::vector<expected_digest> expected_digests = {
+        {digest_algorithm::k_sha256,
+         "sha256",
+         "abc",
+         "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+        {digest_algorithm::k_xxhash64, "xxhash64", "abc", "44bc2cf5ad770999"},
+        {digest_algorithm::k_crc32c, "crc32c", "123456789", "e3069283"}};
+
+    for (const auto& expected : expected_digests) {
+        std::istringstream source{expected.contents};
+        auto result = bucket.upload_from_stream(
+            "file",
+            &source,
+            options::gridfs::upload{}.chunk_size_bytes(2).digest(expected.algorithm));
+
+        REQUIRE(result.digest() == expected.digest);
+
+        auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", result.id())));
+        REQUIRE(files_doc);
+        REQUIRE(bsoncxx::string::to_string(
+                    files_doc->view()[expected.field].get_utf8().value) == expected.digest);
+
+        std::ostringstream verified;
+        bucket.download_to_stream(
+            result.id(), &verified, options::gridfs::download{}.verify_digest(true));
+        REQUIRE(verified.str() == expected.contents);
+    }
+
+    SECTION("no digest is computed by default") {
+        std::istringstream source{"abc"};
+        auto result = bucket.upload_from_stream("file", &source);
+
+        REQUIRE(!result.digest());
+    }
+
+    SECTION("a corrupted file fails verification") {
+        std::istringstream source{"abcdef"};
+        auto id = bucket
+                      .upload_from_stream("file",
+                                          &source,
+                                          options::gridfs::upload{}.chunk_size_bytes(2).digest(
+                                              digest_algorithm::k_sha256))
+                      .id();
+
+        const std::uint8_t corrupted[] = {'x', 'y'};
+        db["fs.chunks"].update_one(
+            make_document(kvp("files_id", id), kvp("n", 1)),
+            make_document(kvp(
+                "$set",
+                make_document(kvp("data",
+                                  bsoncxx::types::b_binary{
+                                      bsoncxx::binary_sub_type::k_binary, 2, corrupted})))));
+
+        std::ostringstream unverified;
+        bucket.download_to_stream(id, &unverified);
+        REQUIRE(unverified.str() == "abxyef");
+
+        std::ostringstream verified;
+        REQUIRE_THROWS_AS(bucket.download_to_stream(
+                              id, &verified, options::gridfs::download{}.verify_digest(true)),
+                          gridfs_exception);
+    }
+}
+
+TEST_CASE("gridfs::bucket compresses chunks with a codec", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_bucket_codec_test"];
+
+    std::string text;
+    for (std::int32_t i = 0; i < 500; ++i) {
+        text += "{\"level\":\"info\",\"message\":\"request served\"}\n";
+    }
+    const std::vector<std::uint8_t> bytes{text.begin(), text.end()};
+    constexpr std::int32_t chunk_size = 1000;
+
+    const auto stored_bytes = [&](bsoncxx::types::bson_value::view id) {
+        std::int64_t total = 0;
+        for (auto&& chunk : db["fs.chunks"].find(make_document(kvp("files_id", id)))) {
+            total += chunk["data"].get_binary().size;
+        }
+        return total;
+    };
+
+    using options::gridfs::chunk_codec;
+
+    for (const auto codec : {chunk_codec::k_zstd, chunk_codec::k_lz4}) {
+        db["fs.files"].drop();
+        db["fs.chunks"].drop();
+
+        gridfs::bucket bucket;
+        try {
+            bucket = db.gridfs_bucket(options::gridfs::bucket{}.codec(codec));
+        } catch (const logic_error& e) {
+            // The driver was built without this codec.
+            REQUIRE(e.code() == error_code::k_gridfs_codec_not_supported);
+            continue;
+        }
+
+        options::gridfs::upload upload_options;
+        upload_options.chunk_size_bytes(chunk_size);
+
+        auto uploader = bucket.open_upload_stream("log", upload_options);
+        uploader.write(bytes.data(), bytes.size());
+        auto id = uploader.close().id();
+
+        auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", id)));
+        REQUIRE(files_doc);
+        REQUIRE(files_doc->view()["codec"].get_utf8().value ==
+                stdx::string_view{codec == chunk_codec::k_zstd ? "zstd" : "lz4"});
+        REQUIRE(files_doc->view()["length"].get_int64().value ==
+                static_cast<std::int64_t>(bytes.size()));
+        REQUIRE(stored_bytes(id) < static_cast<std::int64_t>(bytes.size()) / 4);
+
+        std::ostringstream downloaded;
+        bucket.download_to_stream(id, &downloaded);
+        REQUIRE(downloaded.str() == text);
+
+        std::ostringstream fetched;
+        bucket.download_to_stream(
+            id, &fetched, options::gridfs::download{}.fetch_pool(&pool).window_chunks(3));
+        REQUIRE(fetched.str() == text);
+
+        auto downloader = bucket.open_download_stream(id);
+        std::uint8_t buffer[10];
+        REQUIRE(downloader.read_at(12345, buffer, sizeof(buffer)) == sizeof(buffer));
+        REQUIRE(std::equal(buffer, buffer + sizeof(buffer), bytes.begin() + 12345));
+
+        std::istringstream source{text};
+        auto uncompressed_id =
+            bucket
+                .upload_from_stream("log",
+                                    &source,
+                                    options::gridfs::upload{}.codec(chunk_codec::k_none))
+                .id();
+        auto uncompressed_doc = db["fs.files"].find_one(make_document(kvp("_id", uncompressed_id)));
+        REQUIRE(!uncompressed_doc->view()["codec"]);
+        validate_gridfs_file(db, "fs", uncompressed_id, "log", bytes, 255 * 1024);
+    }
+}
+
+TEST_CASE("gridfs::bucket deduplicates files", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    pool pool{uri{}};
+    database db = client["gridfs_bucket_dedup_test"];
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+    db["fs.blobs"].drop();
+
+    gridfs::bucket bucket =
+        db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true).chunk_size_bytes(4096));
+
+    std::mt19937 generator{42};
+    std::string original;
+    for (std::int32_t i = 0; i < 200 * 1000; ++i) {
+        original.push_back(static_cast<char>(generator() & 0xff));
+    }
+
+    // An insertion in the middle of the file only changes the chunks around it.
+    std::string edited = original;
+    edited.insert(100 * 1000, "a few bytes inserted in the middle of the file");
+
+    const auto blob_count = [&] { return db["fs.blobs"].count_documents({}); };
+
+    std::istringstream original_source{original};
+    auto original_id = bucket.upload_from_stream("backup", &original_source).id();
+
+    auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", original_id)));
+    REQUIRE(files_doc);
+    REQUIRE(files_doc->view()["length"].get_int64().value ==
+            static_cast<std::int64_t>(original.size()));
+    REQUIRE(files_doc->view()["manifest"].get_binary().size % 36 == 0);
+    REQUIRE(db["fs.chunks"].count_documents({}) == 0);
+
+    const auto original_blobs = blob_count();
+    REQUIRE(original_blobs > 10);
+
+    std::istringstream edited_source{edited};
+    auto edited_id = bucket.upload_from_stream("backup", &edited_source).id();
+    REQUIRE(blob_count() <= original_blobs + 3);
+
+    // Uploading the same content again only adds references.
+    std::istringstream copy_source{original};
+    auto copy_id = bucket.upload_from_stream("backup", &copy_source).id();
+    REQUIRE(blob_count() <= original_blobs + 3);
+
+    const auto downloaded = [&](bsoncxx::types::bson_value::view id,
+                                const options::gridfs::download& options) {
+        std::ostringstream destination;
+        bucket.download_to_stream(id, &destination, options);
+        return destination.str();
+    };
+
+    REQUIRE(downloaded(original_id, {}) == original);
+    REQUIRE(downloaded(edited_id, {}) == edited);
+    REQUIRE(downloaded(edited_id, options::gridfs::download{}.window_chunks(3)) == edited);
+    REQUIRE(downloaded(edited_id,
+                       options::gridfs::download{}.fetch_pool(&pool).window_chunks(3)) == edited);
+
+    auto downloader = bucket.open_download_stream(edited_id);
+    std::uint8_t buffer[100];
+    REQUIRE(downloader.read_at(99 * 1000, buffer, sizeof(buffer)) == sizeof(buffer));
+    REQUIRE(std::equal(buffer, buffer + sizeof(buffer), edited.begin() + 99 * 1000));
+    REQUIRE(downloader.read_at(5, buffer, sizeof(buffer)) == sizeof(buffer));
+    REQUIRE(std::equal(buffer, buffer + sizeof(buffer), edited.begin() + 5));
+
+    SECTION("chunks are deleted with the last file referring to them") {
+        bucket.delete_file(original_id);
+        REQUIRE(downloaded(copy_id, {}) == original);
+        REQUIRE(downloaded(edited_id, {}) == edited);
+
+        bucket.delete_file(copy_id);
+        REQUIRE(downloaded(edited_id, {}) == edited);
+
+        bucket.delete_file(edited_id);
+        REQUIRE(blob_count() == 0);
+    }
+
+    SECTION("a bucket without deduplication releases the chunks of deduplicated files") {
+        gridfs::bucket plain = db.gridfs_bucket();
+
+        plain.delete_file(original_id);
+        plain.delete_file(copy_id);
+        plain.delete_file(edited_id);
+        REQUIRE(blob_count() == 0);
+        REQUIRE(db["fs.files"].count_documents({}) == 0);
+    }
+
+    SECTION("an aborted upload releases its chunks") {
+        const auto blobs_before = blob_count();
+
+        auto uploader = bucket.open_upload_stream("aborted");
+        uploader.write(reinterpret_cast<const std::uint8_t*>(original.data()), original.size());
+        uploader.abort();
+
+        REQUIRE(blob_count() == blobs_before);
+        REQUIRE(downloaded(original_id, {}) == original);
+    }
+
+    SECTION("chunk codecs cannot be combined with deduplication") {
+        REQUIRE_THROWS_AS(
+            db.gridfs_bucket(options::gridfs::bucket{}.deduplicate(true).codec(
+                options::gridfs::chunk_codec::k_zstd)),
+            logic_error);
+    }
+}
+
+TEST_CASE("gridfs::bucket caches files", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_bucket_cache_test"];
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    gridfs::bucket bucket =
+        db.gridfs_bucket(options::gridfs::bucket{}.chunk_size_bytes(1000).cache_bytes(1000 * 1000));
+    gridfs::bucket uncached = db.gridfs_bucket();
+
+    const std::string asset(5000, 'a');
+    const std::string replacement(6000, 'b');
+
+    std::istringstream source{asset};
+    auto id = bucket.upload_from_stream("asset", &source).id();
+
+    const auto downloaded = [&](gridfs::bucket& from) {
+        std::ostringstream destination;
+        from.download_to_stream(id, &destination);
+        return destination.str();
+    };
+
+    REQUIRE(downloaded(bucket) == asset);
+
+    // The chunks are no longer read from the server.
+    db["fs.chunks"].delete_many({});
+    REQUIRE(downloaded(bucket) == asset);
+
+    // Downloads share the cached chunks.
+    auto first = bucket.open_download_stream(id);
+    auto second = bucket.open_download_stream(id);
+    REQUIRE(first.next_chunk().data == second.next_chunk().data);
+
+    SECTION("a replaced file is read again") {
+        uncached.delete_file(id);
+
+        std::istringstream replacement_source{replacement};
+        uncached.upload_from_stream_with_id(id, "asset", &replacement_source);
+
+        REQUIRE(downloaded(bucket) == replacement);
+    }
+
+    SECTION("a file deleted through the bucket is no longer cached") {
+        bucket.delete_file(id);
+        REQUIRE_THROWS_AS(downloaded(bucket), gridfs_exception);
+    }
+
+    SECTION("a recently validated file is served without reading its files document") {
+        gridfs::bucket revalidating = db.gridfs_bucket(
+            options::gridfs::bucket{}.cache_bytes(1000 * 1000).cache_revalidate_after(
+                std::chrono::hours{1}));
+
+        db["fs.chunks"].drop();
+        db["fs.files"].drop();
+
+        std::istringstream again{asset};
+        revalidating.upload_from_stream_with_id(id, "asset", &again);
+        REQUIRE(downloaded(revalidating) == asset);
+
+        db["fs.files"].delete_many({});
+        REQUIRE(downloaded(revalidating) == asset);
+    }
+
+    SECTION("invalid cache options are rejected") {
+        REQUIRE_THROWS_AS(db.gridfs_bucket(options::gridfs::bucket{}.cache_bytes(0)), logic_error);
+        REQUIRE_THROWS_AS(
+            db.gridfs_bucket(options::gridfs::bucket{}.cache_bytes(1000).cache_revalidate_after(
+                std::chrono::milliseconds{-1})),
+            logic_error);
+    }
+}
+
+TEST_CASE("gridfs::bucket::upload_many batches small files", "[gridfs::bucket]") {
+    instance::current();
+
+    client client{uri{}};
+    database db = client["gridfs_bucket_upload_many_test"];
+
+    db["fs.files"].drop();
+    db["fs.chunks"].drop();
+
+    gridfs::bucket bucket = db.gridfs_bucket(
+        options::gridfs::bucket{}.chunk_size_bytes(1000).adaptive_chunk_size(true));
+
+    std::vector<std::string> contents;
+    for (std::size_t i = 0; i < 50; ++i) {
+        contents.push_back(std::string(i * 100, static_cast<char>('a' + i % 26)));
+    }
+
+    const auto named_id = bsoncxx::types::bson_value::view{bsoncxx::types::b_int32{42}};
+    const auto metadata = make_document(kvp("kind", "small"));
+
+    std::vector<gridfs::bucket::upload_source> sources;
+    for (std::size_t i = 0; i < contents.size(); ++i) {
+        gridfs::bucket::upload_source source{};
+        source.filename = "small";
+        source.data = reinterpret_cast<const std::uint8_t*>(contents[i].data());
+        source.length = contents[i].size();
+        sources.push_back(source);
+    }
+    sources[0].id = named_id;
+    sources[1].metadata = metadata.view();
+
+    std::int64_t last_progress = 0;
+    options::gridfs::upload upload_options;
+    upload_options.on_progress(
+        [&](std::int64_t uploaded, std::int64_t) { last_progress = uploaded; });
+
+    auto results = bucket.upload_many(sources, upload_options);
+    REQUIRE(results.size() == sources.size());
+    REQUIRE(results[0].id() == named_id);
+
+    std::int64_t total_length = 0;
+    for (std::size_t i = 0; i < contents.size(); ++i) {
+        std::ostringstream destination;
+        bucket.download_to_stream(results[i].id(), &destination);
+        REQUIRE(destination.str() == contents[i]);
+        total_length += static_cast<std::int64_t>(contents[i].size());
+    }
+    REQUIRE(last_progress == total_length);
+
+    auto files_doc = db["fs.files"].find_one(make_document(kvp("_id", results[1].id())));
+    REQUIRE(files_doc);
+    REQUIRE(files_doc->view()["metadata"].get_document().value == metadata.view());
+
+    SECTION("a large file of a known length takes larger chunks") {
+        const std::string large(2000 * 1000, 'z');
+        std::istringstream source{large};
+        auto id = bucket.upload_from_stream("large", &source).id();
+
+        auto large_doc = db["fs.files"].find_one(make_document(kvp("_id", id)));
+        REQUIRE(large_doc);
+        REQUIRE(large_doc->view()["chunkSize"].get_int32().value == 256 * 1024);
+
+        std::ostringstream destination;
+        bucket.download_to_stream(id, &destination);
+        REQUIRE(destination.str() == large);
+    }
+}
+
 TEST_CASE("gridfs::bucket::open_upload_stream_with_id works", "[gridfs::bucket]") {
     instance::current();
 
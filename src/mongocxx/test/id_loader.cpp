@@ -0,0 +1,141 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/id_loader.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+bsoncxx::types::bson_value::view int32(std::int32_t value) {
+    return bsoncxx::types::bson_value::view{bsoncxx::types::b_int32{value}};
+}
+
+TEST_CASE("id_loader batches lookups by _id", "[id_loader]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+    auto coll = (*client)["id_loader"]["lookups"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 20; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("square", i * i)));
+    }
+    coll.insert_many(docs);
+
+    SECTION("every lookup resolves to its document or to nothing") {
+        id_loader loader{pool, "id_loader", "lookups"};
+
+        auto found = loader.load(int32(3));
+        auto duplicate = loader.load(int32(3));
+        auto missing = loader.load(int32(42));
+        loader.flush();
+
+        auto doc = found.get();
+        REQUIRE(doc);
+        REQUIRE(doc->view()["square"].get_int32().value == 9);
+        REQUIRE(duplicate.get()->view() == doc->view());
+        REQUIRE(!missing.get());
+    }
+
+    SECTION("numeric ids match regardless of their type") {
+        id_loader loader{pool, "id_loader", "lookups"};
+
+        auto found = loader.load(bsoncxx::types::bson_value::view{bsoncxx::types::b_double{5.0}});
+        REQUIRE(found.get()->view()["square"].get_int32().value == 25);
+    }
+
+    SECTION("lookups beyond the maximum batch size are split") {
+        options::id_loader options;
+        options.max_batch_size(3).max_delay(std::chrono::milliseconds{50});
+        id_loader loader{pool, "id_loader", "lookups", options};
+
+        std::vector<std::future<stdx::optional<bsoncxx::document::value>>> results;
+        for (std::int32_t i = 0; i < 10; ++i) {
+            results.push_back(loader.load(int32(i)));
+        }
+
+        for (std::int32_t i = 0; i < 10; ++i) {
+            auto doc = results[static_cast<std::size_t>(i)].get();
+            REQUIRE(doc->view()["square"].get_int32().value == i * i);
+        }
+    }
+
+    SECTION("lookups from several threads share the loader") {
+        id_loader loader{pool, "id_loader", "lookups"};
+
+        std::vector<std::int32_t> squares(20, -1);
+        std::vector<std::thread> threads;
+        for (std::int32_t i = 0; i < 20; ++i) {
+            threads.emplace_back([&, i] {
+                squares[static_cast<std::size_t>(i)] =
+                    loader.load(int32(i)).get()->view()["square"].get_int32().value;
+            });
+        }
+
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+
+        for (std::int32_t i = 0; i < 20; ++i) {
+            REQUIRE(squares[static_cast<std::size_t>(i)] == i * i);
+        }
+    }
+
+    SECTION("lookups queued when the loader is destroyed are still resolved") {
+        std::future<stdx::optional<bsoncxx::document::value>> result;
+        {
+            options::id_loader options;
+            options.max_delay(std::chrono::milliseconds{60000});
+            id_loader loader{pool, "id_loader", "lookups", options};
+            result = loader.load(int32(7));
+        }
+
+        REQUIRE(result.get()->view()["square"].get_int32().value == 49);
+    }
+
+    SECTION("invalid options are rejected") {
+        options::id_loader options;
+
+        options.max_batch_size(0);
+        REQUIRE_THROWS_AS((id_loader{pool, "id_loader", "lookups", options}), logic_error);
+
+        options.max_batch_size(10).find_options(
+            options::find{}.projection(make_document(kvp("_id", 0))));
+        REQUIRE_THROWS_AS((id_loader{pool, "id_loader", "lookups", options}), logic_error);
+
+        options.find_options(options::find{}.limit(1));
+        REQUIRE_THROWS_AS((id_loader{pool, "id_loader", "lookups", options}), logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,141 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/local_replica.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_array;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// Change events are applied asynchronously; polls a condition for a few seconds.
+bool eventually(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    return false;
+}
+
+bsoncxx::types::bson_value::view int32(std::int32_t value) {
+    return bsoncxx::types::bson_value::view{bsoncxx::types::b_int32{value}};
+}
+
+bsoncxx::types::bson_value::view string(stdx::string_view value) {
+    return bsoncxx::types::bson_value::view{bsoncxx::types::b_string{value}};
+}
+
+TEST_CASE("local_replica mirrors a collection", "[local_replica]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+
+    if (!test_util::is_replica_set(*client)) {
+        WARN("skip: change streams require replica set");
+        return;
+    }
+
+    auto coll = (*client)["local_replica"]["entitlements"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 100; ++i) {
+        docs.push_back(make_document(kvp("_id", i),
+                                     kvp("plan", i % 3 == 0 ? "pro" : "free"),
+                                     kvp("limits", make_document(kvp("seats", i)))));
+    }
+    coll.insert_many(docs);
+
+    options::local_replica options;
+    options.indexes({"plan", "limits.seats"});
+    local_replica replica{pool, "local_replica", "entitlements", options};
+
+    SECTION("the snapshot is loaded on construction") {
+        REQUIRE(replica.size() == 100);
+        REQUIRE(replica.find(int32(42))->view()["plan"].get_string().value ==
+                stdx::string_view{"pro"});
+        REQUIRE(!replica.find(int32(1000)));
+        REQUIRE(replica.find_by("plan", string("pro")).size() == 34);
+        REQUIRE(replica.find_by("limits.seats", int32(7)).size() == 1);
+        REQUIRE_THROWS_AS(replica.find_by("missing", int32(0)), logic_error);
+    }
+
+    SECTION("numeric ids match regardless of their type") {
+        REQUIRE(replica.find(bsoncxx::types::bson_value::view{bsoncxx::types::b_double{5.0}}));
+        REQUIRE(replica.find(bsoncxx::types::bson_value::view{bsoncxx::types::b_int64{5}}));
+    }
+
+    SECTION("inserts, updates and deletes are applied") {
+        coll.insert_one(make_document(kvp("_id", 100), kvp("plan", "team")));
+        coll.update_one(make_document(kvp("_id", 1)),
+                        make_document(kvp("$set", make_document(kvp("limits.seats", 500))),
+                                      kvp("$unset", make_document(kvp("plan", "")))));
+        coll.delete_one(make_document(kvp("_id", 2)));
+
+        REQUIRE(eventually([&] { return replica.size() == 100 && !replica.find(int32(2)); }));
+        REQUIRE(replica.find_by("plan", string("team")).size() == 1);
+        REQUIRE(eventually([&] {
+            auto doc = replica.find(int32(1));
+            return doc && !doc->view()["plan"] &&
+                   doc->view()["limits"]["seats"].get_int32().value == 500;
+        }));
+        REQUIRE(replica.find_by("limits.seats", int32(500)).size() == 1);
+        REQUIRE(replica.find_by("limits.seats", int32(1)).empty());
+        REQUIRE(replica.resume_token());
+    }
+
+    SECTION("updates which cannot be applied locally are read from the server") {
+        coll.update_one(make_document(kvp("_id", 3)),
+                        make_document(kvp("$set", make_document(kvp("tags", make_array("a"))))));
+        coll.update_one(make_document(kvp("_id", 3)),
+                        make_document(kvp("$push", make_document(kvp("tags", "b")))));
+
+        REQUIRE(eventually([&] {
+            auto doc = replica.find(int32(3));
+            return doc && doc->view()["tags"] &&
+                   doc->view()["tags"].get_array().value == make_array("a", "b").view();
+        }));
+    }
+
+    SECTION("invalid options are rejected") {
+        options::local_replica invalid;
+        invalid.snapshot_partitions(0);
+
+        REQUIRE_THROWS_AS((local_replica{pool, "local_replica", "entitlements", invalid}),
+                          logic_error);
+    }
+}
+
+}  // namespace
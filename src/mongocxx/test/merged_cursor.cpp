@@ -0,0 +1,124 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/merged_cursor.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("merged_cursor merges sorted cursors in sort order", "[merged_cursor]") {
+    instance::current();
+
+    client client{uri{}};
+    auto db = client["merged_cursor"];
+
+    // Each collection holds every third value of "k", mixing numeric types.
+    std::vector<collection> colls;
+    for (std::int32_t c = 0; c < 3; ++c) {
+        auto coll = db["merge_" + std::to_string(c)];
+        coll.drop();
+
+        std::vector<bsoncxx::document::value> docs;
+        for (std::int32_t i = c; i < 30; i += 3) {
+            if (i % 2 == 0) {
+                docs.push_back(make_document(kvp("k", i), kvp("src", c)));
+            } else {
+                docs.push_back(make_document(kvp("k", static_cast<double>(i)), kvp("src", c)));
+            }
+        }
+        coll.insert_many(docs);
+
+        colls.push_back(std::move(coll));
+    }
+
+    SECTION("ascending") {
+        auto sort = make_document(kvp("k", 1));
+
+        std::vector<cursor> cursors;
+        for (auto&& coll : colls) {
+            cursors.push_back(coll.find({}, options::find{}.sort(sort.view())));
+        }
+
+        merged_cursor merged{std::move(cursors), sort.view()};
+
+        std::int32_t expected = 0;
+        for (auto&& doc : merged) {
+            auto k = doc["k"].get_value();
+            double value = k.type() == bsoncxx::type::k_int32 ? k.get_int32().value
+                                                               : k.get_double().value;
+            REQUIRE(value == expected);
+            ++expected;
+        }
+        REQUIRE(expected == 30);
+    }
+
+    SECTION("descending") {
+        auto sort = make_document(kvp("k", -1));
+
+        std::vector<cursor> cursors;
+        for (auto&& coll : colls) {
+            cursors.push_back(coll.find({}, options::find{}.sort(sort.view()).batch_size(2)));
+        }
+
+        merged_cursor merged{std::move(cursors), sort.view()};
+
+        std::int32_t count = 0;
+        for (auto it = merged.begin(); it != merged.end(); ++it) {
+            auto k = (*it)["k"].get_value();
+            double value = k.type() == bsoncxx::type::k_int32 ? k.get_int32().value
+                                                               : k.get_double().value;
+            REQUIRE(value == 29 - count);
+            ++count;
+        }
+        REQUIRE(count == 30);
+    }
+
+    SECTION("empty cursors are skipped") {
+        auto sort = make_document(kvp("k", 1));
+
+        std::vector<cursor> cursors;
+        cursors.push_back(colls[0].find(make_document(kvp("k", -1))));
+        cursors.push_back(colls[1].find({}, options::find{}.sort(sort.view())));
+
+        merged_cursor merged{std::move(cursors), sort.view()};
+
+        std::int32_t count = 0;
+        for (auto&& doc : merged) {
+            REQUIRE(doc["src"].get_int32().value == 1);
+            ++count;
+        }
+        REQUIRE(count == 10);
+    }
+
+    SECTION("invalid sort specifications are rejected") {
+        std::vector<cursor> cursors;
+        REQUIRE_THROWS_AS((merged_cursor{std::move(cursors), make_document(kvp("k", "text"))}),
+                          logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,163 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/paginator.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+std::vector<std::int32_t> ids(const std::vector<bsoncxx::document::value>& docs) {
+    std::vector<std::int32_t> result;
+    for (auto&& doc : docs) {
+        result.push_back(doc.view()["_id"].get_int32().value);
+    }
+    return result;
+}
+
+TEST_CASE("paginator pages through a collection without skipping", "[paginator]") {
+    instance::current();
+
+    client client{uri{}};
+    auto coll = client["paginator"]["pages"];
+    coll.drop();
+
+    // Groups of three documents share a value of "k", so the _id tiebreaker is exercised at every
+    // page boundary.
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 20; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("k", i / 3), kvp("even", i % 2 == 0)));
+    }
+    coll.insert_many(docs);
+
+    SECTION("ascending sort") {
+        paginator pages{coll, {}, options::find{}.sort(make_document(kvp("k", 1))).limit(4)};
+
+        std::vector<std::int32_t> seen;
+        while (!pages.exhausted()) {
+            auto page = pages.next_page();
+            REQUIRE(page.size() <= 4);
+            auto page_ids = ids(page);
+            seen.insert(seen.end(), page_ids.begin(), page_ids.end());
+        }
+
+        REQUIRE(seen.size() == 20);
+        for (std::int32_t i = 0; i < 20; ++i) {
+            REQUIRE(seen[static_cast<std::size_t>(i)] == i);
+        }
+        REQUIRE(pages.next_page().empty());
+    }
+
+    SECTION("descending sort with a filter") {
+        paginator pages{coll,
+                        make_document(kvp("even", true)),
+                        options::find{}.sort(make_document(kvp("k", -1), kvp("_id", -1))).limit(3)};
+
+        std::vector<std::int32_t> seen;
+        for (auto page = pages.next_page(); !page.empty(); page = pages.next_page()) {
+            auto page_ids = ids(page);
+            seen.insert(seen.end(), page_ids.begin(), page_ids.end());
+        }
+
+        REQUIRE(seen == (std::vector<std::int32_t>{18, 16, 14, 12, 10, 8, 6, 4, 2, 0}));
+    }
+
+    SECTION("paging resumes from a page token") {
+        options::find options;
+        options.sort(make_document(kvp("k", 1))).limit(5);
+
+        paginator first{coll, {}, options};
+        REQUIRE(!first.page_token());
+        REQUIRE(ids(first.next_page()) == (std::vector<std::int32_t>{0, 1, 2, 3, 4}));
+
+        bsoncxx::document::value token{*first.page_token()};
+
+        paginator resumed{coll, {}, options, bsoncxx::document::view_or_value{token.view()}};
+        REQUIRE(ids(resumed.next_page()) == (std::vector<std::int32_t>{5, 6, 7, 8, 9}));
+    }
+
+    SECTION("invalid options are rejected") {
+        REQUIRE_THROWS_AS((paginator{coll, {}, options::find{}}), logic_error);
+        REQUIRE_THROWS_AS((paginator{coll, {}, options::find{}.limit(2).skip(2)}), logic_error);
+        REQUIRE_THROWS_AS(
+            (paginator{coll, {}, options::find{}.limit(2).sort(make_document(kvp("k", 2)))}),
+            logic_error);
+
+        bsoncxx::document::view_or_value mismatched_token{make_document(kvp("_id", 1))};
+        REQUIRE_THROWS_AS((paginator{coll,
+                                     {},
+                                     options::find{}.limit(2).sort(make_document(kvp("k", 1))),
+                                     std::move(mismatched_token)}),
+                          logic_error);
+    }
+}
+
+TEST_CASE("paginator pages across sort keys of different types", "[paginator]") {
+    instance::current();
+
+    client client{uri{}};
+    auto coll = client["paginator"]["nulls"];
+    coll.drop();
+
+    // Missing and null values of "k" sort together, before every number, and numbers sort before
+    // strings.
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 3; ++i) {
+        docs.push_back(make_document(kvp("_id", i)));
+    }
+    for (std::int32_t i = 3; i < 5; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("k", bsoncxx::types::b_null{})));
+    }
+    for (std::int32_t i = 5; i < 10; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("k", i)));
+    }
+    docs.push_back(make_document(kvp("_id", 10), kvp("k", "a")));
+    docs.push_back(make_document(kvp("_id", 11), kvp("k", "b")));
+    coll.insert_many(docs);
+
+    const auto all_ids = [](paginator& pages) {
+        std::vector<std::int32_t> seen;
+        for (auto page = pages.next_page(); !page.empty(); page = pages.next_page()) {
+            auto page_ids = ids(page);
+            seen.insert(seen.end(), page_ids.begin(), page_ids.end());
+        }
+        return seen;
+    };
+
+    SECTION("ascending sort") {
+        paginator pages{coll, {}, options::find{}.sort(make_document(kvp("k", 1))).limit(3)};
+        REQUIRE(all_ids(pages) ==
+                (std::vector<std::int32_t>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+    }
+
+    SECTION("descending sort") {
+        paginator pages{coll, {}, options::find{}.sort(make_document(kvp("k", -1))).limit(3)};
+        REQUIRE(all_ids(pages) ==
+                (std::vector<std::int32_t>{11, 10, 9, 8, 7, 6, 5, 0, 1, 2, 3, 4}));
+    }
+}
+
+}  // namespace
@@ -0,0 +1,142 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/parallel_scan.hpp>
+#include <mongocxx/pool.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("parallel_scan visits every matching document exactly once", "[parallel_scan]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+    auto coll = (*client)["parallel_scan"]["visits_every_document"];
+    coll.drop();
+
+    const std::int32_t num_docs = 1000;
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < num_docs; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("even", i % 2 == 0)));
+    }
+    coll.insert_many(docs);
+
+    std::mutex mutex;
+    std::map<std::int32_t, std::int32_t> seen;
+    std::map<std::int32_t, std::int32_t> partitions;
+
+    auto record = [&](std::int32_t partition, bsoncxx::document::view doc) {
+        std::lock_guard<std::mutex> lock{mutex};
+        ++seen[doc["_id"].get_int32().value];
+        ++partitions[partition];
+    };
+
+    SECTION("without a filter") {
+        parallel_scan(pool, "parallel_scan", "visits_every_document", {}, 4, record);
+
+        REQUIRE(seen.size() == static_cast<std::size_t>(num_docs));
+        for (auto&& entry : seen) {
+            REQUIRE(entry.second == 1);
+        }
+        REQUIRE(partitions.size() <= 4);
+    }
+
+    SECTION("with a filter") {
+        parallel_scan(pool,
+                      "parallel_scan",
+                      "visits_every_document",
+                      make_document(kvp("even", true)),
+                      4,
+                      record);
+
+        REQUIRE(seen.size() == static_cast<std::size_t>(num_docs / 2));
+        for (auto&& entry : seen) {
+            REQUIRE(entry.first % 2 == 0);
+            REQUIRE(entry.second == 1);
+        }
+    }
+
+    SECTION("with a single partition") {
+        REQUIRE(parallel_scan_boundaries(coll, 1).empty());
+
+        parallel_scan(pool, "parallel_scan", "visits_every_document", {}, 1, record);
+
+        REQUIRE(seen.size() == static_cast<std::size_t>(num_docs));
+        REQUIRE(partitions.size() == 1);
+    }
+
+    SECTION("the first exception thrown by the handler is rethrown") {
+        REQUIRE_THROWS_AS(
+            parallel_scan(pool,
+                          "parallel_scan",
+                          "visits_every_document",
+                          {},
+                          4,
+                          [](std::int32_t, bsoncxx::document::view) {
+                              throw std::runtime_error{"handler failed"};
+                          }),
+            std::runtime_error);
+    }
+
+    SECTION("reserved find options are rejected") {
+        options::parallel_scan options;
+        options.find_options(options::find{}.limit(1));
+
+        REQUIRE_THROWS_AS(
+            parallel_scan(pool, "parallel_scan", "visits_every_document", {}, 4, record, options),
+            logic_error);
+    }
+}
+
+TEST_CASE("parallel_scan_boundaries are sorted and distinct", "[parallel_scan]") {
+    instance::current();
+
+    client client{uri{}};
+    auto coll = client["parallel_scan"]["boundaries"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 100; ++i) {
+        docs.push_back(make_document(kvp("_id", i)));
+    }
+    coll.insert_many(docs);
+
+    auto boundaries = parallel_scan_boundaries(coll, 8);
+
+    REQUIRE(boundaries.size() <= 7);
+    for (std::size_t i = 1; i < boundaries.size(); ++i) {
+        REQUIRE(boundaries[i - 1].view()["_id"].get_int32().value <
+                boundaries[i].view()["_id"].get_int32().value);
+    }
+
+    REQUIRE_THROWS_AS(parallel_scan_boundaries(coll, 0), logic_error);
+}
+
+}  // namespace
@@ -0,0 +1,121 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <bsoncxx/types.hpp>
+#include <bsoncxx/types/bson_value/view.hpp>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pipeline.hpp>
+#include <mongocxx/prepared_aggregate.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+std::vector<std::int32_t> values(cursor&& cursor) {
+    std::vector<std::int32_t> result;
+    for (auto&& doc : cursor) {
+        result.push_back(doc["x"].get_int32().value);
+    }
+    return result;
+}
+
+bsoncxx::types::bson_value::view int32(std::int32_t value) {
+    return bsoncxx::types::bson_value::view{bsoncxx::types::b_int32{value}};
+}
+
+TEST_CASE("prepared_aggregate substitutes bound values for placeholders", "[prepared_aggregate]") {
+    instance::current();
+
+    client client{uri{}};
+    auto coll = client["prepared_aggregate"]["bind"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 10; ++i) {
+        docs.push_back(make_document(kvp("x", i), kvp("tag", i % 2 == 0 ? "even" : "odd")));
+    }
+    coll.insert_many(docs);
+
+    pipeline stages;
+    stages
+        .match(make_document(
+            kvp("x", make_document(kvp("$gte", prepared_aggregate::placeholder(0)))),
+            kvp("tag", prepared_aggregate::placeholder(1))))
+        .sort(make_document(kvp("x", 1)))
+        .project(make_document(kvp("_id", 0), kvp("x", 1)));
+
+    prepared_aggregate prepared{coll, stages};
+
+    SECTION("every placeholder must be bound") {
+        prepared.bind(0, int32(4));
+        REQUIRE_THROWS_AS(prepared.execute(), logic_error);
+    }
+
+    SECTION("unknown slots are rejected") {
+        REQUIRE_THROWS_AS(prepared.bind(2, int32(0)), logic_error);
+        REQUIRE_THROWS_AS(prepared.bind(-1, int32(0)), logic_error);
+    }
+
+    SECTION("values of the same size are rebound in place") {
+        prepared.bind(0, int32(4)).bind(1, bsoncxx::types::bson_value::view{
+                                               bsoncxx::types::b_utf8{"odd"}});
+        REQUIRE(values(prepared.execute()) == (std::vector<std::int32_t>{5, 7, 9}));
+
+        prepared.bind(0, int32(6));
+        REQUIRE(values(prepared.execute()) == (std::vector<std::int32_t>{7, 9}));
+    }
+
+    SECTION("values of a different size or type are spliced") {
+        prepared.bind(0, int32(4)).bind(1, bsoncxx::types::bson_value::view{
+                                               bsoncxx::types::b_utf8{"odd"}});
+        REQUIRE(values(prepared.execute()) == (std::vector<std::int32_t>{5, 7, 9}));
+
+        prepared.bind(1, bsoncxx::types::bson_value::view{bsoncxx::types::b_utf8{"even"}});
+        REQUIRE(values(prepared.execute()) == (std::vector<std::int32_t>{4, 6, 8}));
+
+        prepared.bind(0, bsoncxx::types::bson_value::view{bsoncxx::types::b_double{1.5}});
+        REQUIRE(values(prepared.execute()) == (std::vector<std::int32_t>{2, 4, 6, 8}));
+    }
+
+    SECTION("with a session") {
+        if (!test_util::server_has_sessions(client)) {
+            return;
+        }
+
+        auto session = client.start_session();
+        prepared.bind(0, int32(7)).bind(1, bsoncxx::types::bson_value::view{
+                                               bsoncxx::types::b_utf8{"odd"}});
+        REQUIRE(values(prepared.execute(session)) == (std::vector<std::int32_t>{7, 9}));
+    }
+
+    SECTION("negative slots are rejected when preparing") {
+        pipeline invalid;
+        invalid.match(make_document(kvp("x", prepared_aggregate::placeholder(-1))));
+
+        REQUIRE_THROWS_AS((prepared_aggregate{coll, invalid}), logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,87 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/prepared_find.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+std::vector<std::int32_t> values(cursor&& cursor) {
+    std::vector<std::int32_t> result;
+    for (auto&& doc : cursor) {
+        REQUIRE(!doc["_id"]);
+        result.push_back(doc["x"].get_int32().value);
+    }
+    return result;
+}
+
+TEST_CASE("prepared_find reuses its options across executions", "[prepared_find]") {
+    instance::current();
+
+    client client{uri{}};
+    auto coll = client["prepared_find"]["reuse"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 10; ++i) {
+        docs.push_back(make_document(kvp("x", i), kvp("group", i % 2)));
+    }
+    coll.insert_many(docs);
+
+    options::find options;
+    options.projection(make_document(kvp("_id", 0), kvp("x", 1)))
+        .sort(make_document(kvp("x", -1)))
+        .limit(3);
+
+    prepared_find prepared{coll, options};
+
+    REQUIRE(values(prepared.execute(make_document(kvp("group", 0)))) ==
+            (std::vector<std::int32_t>{8, 6, 4}));
+    REQUIRE(values(prepared.execute(make_document(kvp("group", 1)))) ==
+            (std::vector<std::int32_t>{9, 7, 5}));
+    REQUIRE(values(prepared.execute({})) == values(coll.find({}, options)));
+
+    SECTION("with a session") {
+        if (!test_util::server_has_sessions(client)) {
+            return;
+        }
+
+        auto session = client.start_session();
+        REQUIRE(values(prepared.execute(session, make_document(kvp("group", 0)))) ==
+                (std::vector<std::int32_t>{8, 6, 4}));
+    }
+
+    SECTION("invalid options are rejected when preparing") {
+        options::find invalid;
+        invalid.max_await_time(std::chrono::milliseconds{-1});
+
+        REQUIRE_THROWS_AS((prepared_find{coll, invalid}), logic_error);
+    }
+}
+
+}  // namespace
@@ -0,0 +1,148 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/logic_error.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/read_cache.hpp>
+#include <mongocxx/test_util/client_helpers.hh>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+// Change events are applied asynchronously; polls a condition for a few seconds.
+bool eventually(const std::function<bool()>& condition) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    }
+    return false;
+}
+
+std::int32_t value_of(const stdx::optional<bsoncxx::document::value>& doc) {
+    return doc->view()["value"].get_int32().value;
+}
+
+TEST_CASE("read_cache serves repeated reads and observes changes", "[read_cache]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+
+    if (!test_util::is_replica_set(*client)) {
+        WARN("skip: change streams require replica set");
+        return;
+    }
+
+    auto coll = (*client)["read_cache"]["reference"];
+    coll.drop();
+    coll.insert_one(make_document(kvp("_id", 1), kvp("name", "a"), kvp("value", 10)));
+    coll.insert_one(make_document(kvp("_id", 2), kvp("name", "b"), kvp("value", 20)));
+
+    read_cache cache{pool, "read_cache", "reference"};
+
+    SECTION("repeated reads are served from the cache") {
+        REQUIRE(value_of(cache.find_one(make_document(kvp("name", "a")))) == 10);
+        REQUIRE(value_of(cache.find_one(make_document(kvp("name", "a")))) == 10);
+        REQUIRE(cache.hits() == 1);
+        REQUIRE(cache.misses() == 1);
+        REQUIRE(cache.size_bytes() > 0);
+
+        // The order of top-level fields does not matter.
+        REQUIRE(value_of(cache.find_one(make_document(kvp("value", 10), kvp("name", "a")))) ==
+                10);
+        REQUIRE(value_of(cache.find_one(make_document(kvp("name", "a"), kvp("value", 10)))) ==
+                10);
+        REQUIRE(cache.hits() == 2);
+
+        cache.clear();
+        REQUIRE(cache.size_bytes() == 0);
+    }
+
+    SECTION("updates invalidate the entries holding the document") {
+        REQUIRE(value_of(cache.find_one(make_document(kvp("_id", 1)))) == 10);
+        coll.update_one(make_document(kvp("_id", 1)),
+                        make_document(kvp("$set", make_document(kvp("value", 11)))));
+
+        REQUIRE(eventually(
+            [&] { return value_of(cache.find_one(make_document(kvp("_id", 1)))) == 11; }));
+        REQUIRE(cache.invalidations() >= 1);
+    }
+
+    SECTION("updates invalidate the entries holding a document without its _id") {
+        options::find options;
+        options.projection(make_document(kvp("_id", 0), kvp("value", 1)));
+
+        REQUIRE(value_of(cache.find_one(make_document(kvp("name", "a")), options)) == 10);
+        coll.update_one(make_document(kvp("_id", 1)),
+                        make_document(kvp("$set", make_document(kvp("value", 12)))));
+
+        REQUIRE(eventually([&] {
+            return value_of(cache.find_one(make_document(kvp("name", "a")), options)) == 12;
+        }));
+        REQUIRE(cache.invalidations() >= 1);
+    }
+
+    SECTION("inserts invalidate the entries which found no document") {
+        REQUIRE(!cache.find_one(make_document(kvp("name", "c"))));
+        coll.insert_one(make_document(kvp("_id", 3), kvp("name", "c"), kvp("value", 30)));
+
+        REQUIRE(eventually([&] { return !!cache.find_one(make_document(kvp("name", "c"))); }));
+    }
+
+    SECTION("deletes invalidate the entries holding the document") {
+        REQUIRE(cache.find_one(make_document(kvp("_id", 2))));
+        coll.delete_one(make_document(kvp("_id", 2)));
+
+        REQUIRE(eventually([&] { return !cache.find_one(make_document(kvp("_id", 2))); }));
+    }
+
+    SECTION("the byte budget is honored") {
+        options::read_cache options;
+        options.max_bytes(256);
+        read_cache small{pool, "read_cache", "reference", options};
+
+        small.find_one(make_document(kvp("_id", 1)));
+        small.find_one(make_document(kvp("_id", 2)));
+        REQUIRE(small.size_bytes() <= 256);
+        REQUIRE(small.evictions() >= 1);
+    }
+
+    SECTION("invalid options are rejected") {
+        options::read_cache options;
+        options.ttl(std::chrono::milliseconds{0});
+        REQUIRE_THROWS_AS((read_cache{pool, "read_cache", "reference", options}), logic_error);
+
+        options::find tailable;
+        tailable.cursor_type(cursor::type::k_tailable);
+        REQUIRE_THROWS_AS(cache.find_one({}, tailable), logic_error);
+    }
+}
+
+}  // namespace
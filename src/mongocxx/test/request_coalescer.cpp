@@ -0,0 +1,138 @@
+// Copyright 2020 MongoDB Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <bsoncxx/builder/basic/document.hpp>
+#include <bsoncxx/test_util/catch.hh>
+#include <mongocxx/client.hpp>
+#include <mongocxx/collection.hpp>
+#include <mongocxx/exception/operation_exception.hpp>
+#include <mongocxx/instance.hpp>
+#include <mongocxx/pool.hpp>
+#include <mongocxx/request_coalescer.hpp>
+
+namespace {
+
+using bsoncxx::builder::basic::kvp;
+using bsoncxx::builder::basic::make_document;
+
+using namespace mongocxx;
+
+TEST_CASE("request_coalescer returns the results of the underlying reads", "[request_coalescer]") {
+    instance::current();
+
+    pool pool{uri{}};
+    auto client = pool.acquire();
+    auto coll = (*client)["request_coalescer"]["reads"];
+    coll.drop();
+
+    std::vector<bsoncxx::document::value> docs;
+    for (std::int32_t i = 0; i < 10; ++i) {
+        docs.push_back(make_document(kvp("_id", i), kvp("group", i % 2)));
+    }
+    coll.insert_many(docs);
+
+    request_coalescer coalescer;
+
+    SECTION("sequential reads are not coalesced") {
+        auto found = coalescer.find_one(coll, make_document(kvp("_id", 3)));
+        REQUIRE(found);
+        REQUIRE(found->view() == coll.find_one(make_document(kvp("_id", 3)))->view());
+        REQUIRE(!coalescer.find_one(coll, make_document(kvp("_id", 42))));
+
+        REQUIRE(coalescer.count_documents(coll, make_document(kvp("group", 1))) == 5);
+
+        pipeline stages;
+        stages.match(make_document(kvp("group", 0))).sort(make_document(kvp("_id", 1)));
+        auto results = coalescer.aggregate(coll, stages);
+        REQUIRE(results);
+        REQUIRE(results->size() == 5);
+        REQUIRE(results->front().view()["_id"].get_int32().value == 0);
+        REQUIRE(results->back().view()["_id"].get_int32().value == 8);
+
+        REQUIRE(coalescer.hits() == 0);
+        REQUIRE(coalescer.misses() == 4);
+    }
+
+    SECTION("errors are raised to the caller") {
+        options::count options;
+        options.hint(hint{"no_such_index"});
+
+        REQUIRE_THROWS_AS(coalescer.count_documents(coll, {}, options), operation_exception);
+        REQUIRE(coalescer.misses() == 1);
+    }
+
+    SECTION("concurrent identical aggregations share their results") {
+        const std::size_t num_threads = 16;
+        std::vector<std::shared_ptr<const std::vector<bsoncxx::document::value>>> results(
+            num_threads);
+        std::vector<std::thread> threads;
+
+        pipeline stages;
+        stages.match(make_document(kvp("group", 1)));
+
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&, i] {
+                auto thread_client = pool.acquire();
+                auto thread_coll = (*thread_client)["request_coalescer"]["reads"];
+                results[i] = coalescer.aggregate(thread_coll, stages);
+            });
+        }
+
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+
+        // Every caller sharing a read holds the same vector, so there are at most as many distinct
+        // vectors as reads sent to the server.
+        std::set<const std::vector<bsoncxx::document::value>*> distinct;
+        for (const auto& result : results) {
+            REQUIRE(result);
+            REQUIRE(result->size() == 5);
+            distinct.insert(result.get());
+        }
+        REQUIRE(static_cast<std::int64_t>(distinct.size()) == coalescer.misses());
+    }
+
+    SECTION("concurrent identical reads all receive the result") {
+        const std::size_t num_threads = 16;
+        std::vector<std::int64_t> counts(num_threads, -1);
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < num_threads; ++i) {
+            threads.emplace_back([&, i] {
+                auto thread_client = pool.acquire();
+                auto thread_coll = (*thread_client)["request_coalescer"]["reads"];
+                counts[i] = coalescer.count_documents(thread_coll, make_document(kvp("group", 0)));
+            });
+        }
+
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+
+        for (auto count : counts) {
+            REQUIRE(count == 5);
+        }
+
+        REQUIRE(coalescer.hits() + coalescer.misses() == static_cast<std::int64_t>(num_threads));
+        REQUIRE(coalescer.misses() >= 1);
+    }
+}
+
+}  // namespace